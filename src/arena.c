@@ -0,0 +1,191 @@
+#include "arena.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_ALIGN (sizeof(void *) > sizeof(double) ? sizeof(void *) : sizeof(double))
+
+struct ArenaBlock {
+    ArenaBlock *next;
+    size_t used;
+    size_t size;
+};
+
+static size_t align_up(size_t n)
+{
+    return (n + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+// Payload starts after the header, rounded up so every allocation is aligned
+static unsigned char *block_data(ArenaBlock *block)
+{
+    return (unsigned char *)block + align_up(sizeof(ArenaBlock));
+}
+
+static ArenaBlock *new_block(Arena *arena, size_t min_size)
+{
+    size_t size = min_size > arena->block_size ? min_size : arena->block_size;
+    ArenaBlock *block = malloc(align_up(sizeof(ArenaBlock)) + size);
+    if (!block)
+        return NULL;
+
+    block->next = arena->head;
+    block->used = 0;
+    block->size = size;
+    arena->head = block;
+    arena->reserved += size;
+    return block;
+}
+
+Arena *arena_create(size_t block_size)
+{
+    Arena *arena = calloc(1, sizeof(Arena));
+    if (!arena)
+        return NULL;
+    arena->block_size = block_size ? align_up(block_size) : ARENA_DEFAULT_BLOCK_SIZE;
+    return arena;
+}
+
+void arena_destroy(Arena *arena)
+{
+    if (!arena)
+        return;
+
+    ArenaBlock *block = arena->head;
+    while (block)
+    {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+void arena_reset(Arena *arena)
+{
+    if (!arena || !arena->head)
+        return;
+
+    // Drop every block but the oldest, which is usually the only one needed
+    ArenaBlock *block = arena->head;
+    while (block->next)
+    {
+        ArenaBlock *next = block->next;
+        arena->reserved -= block->size;
+        free(block);
+        block = next;
+    }
+    block->used = 0;
+    arena->head = block;
+    arena->allocated = 0;
+}
+
+void arena_adopt(Arena *arena, Arena *other)
+{
+    if (!arena || !other || arena == other)
+        return;
+
+    if (other->head)
+    {
+        // Splice other's blocks in behind our current block, which stays the
+        // bump target so in-place growth keeps working
+        ArenaBlock *tail = other->head;
+        while (tail->next)
+            tail = tail->next;
+
+        if (arena->head)
+        {
+            tail->next = arena->head->next;
+            arena->head->next = other->head;
+        }
+        else
+        {
+            arena->head = other->head;
+        }
+    }
+
+    arena->allocated += other->allocated;
+    arena->reserved += other->reserved;
+    free(other);
+}
+
+void *arena_alloc(Arena *arena, size_t size)
+{
+    if (!arena)
+        return malloc(size);
+
+    size = align_up(size ? size : 1);
+    ArenaBlock *block = arena->head;
+    if (!block || block->size - block->used < size)
+    {
+        block = new_block(arena, size);
+        if (!block)
+            return NULL;
+    }
+
+    void *p = block_data(block) + block->used;
+    block->used += size;
+    arena->allocated += size;
+    return p;
+}
+
+void *arena_calloc(Arena *arena, size_t count, size_t size)
+{
+    if (!arena)
+        return calloc(count, size);
+
+    if (size && count > SIZE_MAX / size)
+        return NULL;
+
+    void *p = arena_alloc(arena, count * size);
+    if (p)
+        memset(p, 0, count * size);
+    return p;
+}
+
+void *arena_realloc(Arena *arena, void *ptr, size_t old_size, size_t new_size)
+{
+    if (!arena)
+        return realloc(ptr, new_size);
+
+    if (!ptr)
+        return arena_alloc(arena, new_size);
+
+    // Grow in place when ptr is the most recent allocation in the current block
+    ArenaBlock *block = arena->head;
+    size_t old_aligned = align_up(old_size ? old_size : 1);
+    size_t new_aligned = align_up(new_size ? new_size : 1);
+    if (block && (unsigned char *)ptr + old_aligned == block_data(block) + block->used &&
+        block->used - old_aligned + new_aligned <= block->size)
+    {
+        block->used = block->used - old_aligned + new_aligned;
+        arena->allocated = arena->allocated - old_aligned + new_aligned;
+        return ptr;
+    }
+
+    if (new_size <= old_size)
+        return ptr;
+
+    void *p = arena_alloc(arena, new_size);
+    if (p)
+        memcpy(p, ptr, old_size);
+    return p;
+}
+
+char *arena_strdup(Arena *arena, const char *s)
+{
+    if (!s)
+        return NULL;
+
+    size_t len = strlen(s) + 1;
+    char *copy = arena_alloc(arena, len);
+    if (copy)
+        memcpy(copy, s, len);
+    return copy;
+}
+
+void arena_free(Arena *arena, void *ptr)
+{
+    if (!arena)
+        free(ptr);
+}
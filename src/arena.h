@@ -0,0 +1,33 @@
+#ifndef ARENA_H
+#define ARENA_H
+#include <stddef.h>
+
+// Bump-pointer region allocator. Everything allocated from an arena is
+// released at once by arena_reset / arena_destroy; there is no per-object free.
+//
+// Every helper accepts a NULL arena and falls back to the C heap, so code
+// can be written once and used for both arena-backed and heap-backed data.
+
+#define ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct Arena {
+    ArenaBlock *head;      // Current block; older blocks chain behind it
+    size_t block_size;     // Minimum size of each new block
+    size_t allocated;      // Bytes handed out since the last reset
+    size_t reserved;       // Bytes obtained from malloc
+} Arena;
+
+Arena *arena_create(size_t block_size);     // 0 → ARENA_DEFAULT_BLOCK_SIZE
+void arena_destroy(Arena *arena);
+void arena_reset(Arena *arena);             // Keeps the first block for reuse
+void arena_adopt(Arena *arena, Arena *other); // Takes over other's memory and destroys it
+
+void *arena_alloc(Arena *arena, size_t size);
+void *arena_calloc(Arena *arena, size_t count, size_t size);
+void *arena_realloc(Arena *arena, void *ptr, size_t old_size, size_t new_size);
+void arena_free(Arena *arena, void *ptr);   // Heap only; no-op inside an arena
+char *arena_strdup(Arena *arena, const char *s);
+
+#endif
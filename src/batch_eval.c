@@ -0,0 +1,640 @@
+#define _POSIX_C_SOURCE 200809L // getline, clock_gettime
+#include "batch_eval.h"
+#include "log.h"
+#include "mkrand.h"
+#include "schedule.h"
+#include "truth_table.h"
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Words handled per inner loop (512 vectors). The loops over a lane have a
+// fixed trip count, so the compiler can turn them into SIMD when the target
+// has it; signals are padded to a whole number of lanes.
+#define BATCH_LANE_WORDS 8
+
+// Same cap as MAX_ITERATIONS in eval.c
+#define BATCH_LOOP_ROUNDS 5
+
+#define BATCH_ALL_ONES UINT64_MAX
+
+// One product term: the Case pattern packed like a truth-table row
+typedef struct BatchTerm {
+    uint32_t row;
+    uint8_t result;
+} BatchTerm;
+
+typedef struct BatchGate {
+    const Instance *inst;
+    uint32_t first_term;
+    uint32_t term_count;
+    uint8_t *literal_bits;    // One 0/1 per literal binding
+    bool has_logic;           // False: the instance only publishes literals
+} BatchGate;
+
+typedef struct BatchEngine {
+    const Schedule *schedule;
+    size_t signal_count;
+    size_t word_count;        // Per signal; a multiple of BATCH_LANE_WORDS
+    size_t vector_count;
+    uint64_t *value;          // signal_count × word_count
+    uint64_t *valid;          // Bit set once that vector's signal is driven
+    BatchGate *gates;         // By instance ordinal
+    BatchTerm *terms;
+    uint8_t *literal_bits;
+} BatchEngine;
+
+typedef struct BatchStimuli {
+    SignalId *inputs;
+    size_t input_count;
+    size_t vector_count;
+    size_t word_count;
+    uint64_t *bits;           // input_count × word_count
+} BatchStimuli;
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+}
+
+static size_t words_for(size_t vector_count)
+{
+    size_t words = (vector_count + 63) / 64;
+    return (words + BATCH_LANE_WORDS - 1) / BATCH_LANE_WORDS * BATCH_LANE_WORDS;
+}
+
+static void destroy_stimuli(BatchStimuli *stimuli)
+{
+    free(stimuli->inputs);
+    free(stimuli->bits);
+    memset(stimuli, 0, sizeof(*stimuli));
+}
+
+static void destroy_engine(BatchEngine *engine)
+{
+    free(engine->value);
+    free(engine->valid);
+    free(engine->gates);
+    free(engine->terms);
+    free(engine->literal_bits);
+    memset(engine, 0, sizeof(*engine));
+}
+
+static int single_bit(const char *value)
+{
+    if (value && (value[0] == '0' || value[0] == '1') && value[1] == '\0')
+        return value[0] - '0';
+    return -1;
+}
+
+/**
+ * Lower every instance to product terms. The truth table already resolved
+ * duplicate patterns (first Case wins), so a Case becomes a term only where
+ * the table points back at it.
+ */
+static int lower_netlist(BatchEngine *engine)
+{
+    const Schedule *schedule = engine->schedule;
+    size_t n = schedule->instance_count;
+    size_t term_total = 0, literal_total = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Instance *inst = schedule->instances[i];
+        if (!inst || !inst->definition || !inst->invocation)
+            continue;
+        literal_total += inst->literal_count;
+
+        const ConditionalInvocation *ci = inst->definition->conditional_invocation;
+        if (!ci || !ci->pattern_args || !ci->output)
+            continue; // Literals only, as in eval_instance
+        if (!ci->truth_table || ci->arg_count != inst->pattern_count)
+        {
+            LOG_ERROR("❌ Batch: %s has no bitwise form (templates wider than %d args or non-bit patterns)",
+                      inst->name, TRUTH_TABLE_MAX_ARGS);
+            return -1;
+        }
+        for (size_t c = 0; c < ci->case_count; ++c)
+        {
+            if (single_bit(ci->cases[c].result) < 0)
+            {
+                LOG_ERROR("❌ Batch: %s case %zu result '%s' is not a single bit", inst->name, c, ci->cases[c].result);
+                return -1;
+            }
+        }
+        term_total += ci->case_count;
+    }
+
+    engine->gates = calloc(n ? n : 1, sizeof(BatchGate));
+    engine->terms = malloc(sizeof(BatchTerm) * (term_total ? term_total : 1));
+    engine->literal_bits = malloc(literal_total ? literal_total : 1);
+    if (!engine->gates || !engine->terms || !engine->literal_bits)
+    {
+        LOG_ERROR("❌ Batch: out of memory lowering %zu instance(s)", n);
+        return -1;
+    }
+
+    size_t next_term = 0, next_literal = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Instance *inst = schedule->instances[i];
+        if (!inst || !inst->definition || !inst->invocation)
+            continue;
+
+        BatchGate *gate = &engine->gates[i];
+        gate->inst = inst;
+        gate->first_term = (uint32_t)next_term;
+        gate->literal_bits = engine->literal_bits + next_literal;
+
+        const LiteralBinding *bindings = inst->invocation->literal_bindings ? inst->invocation->literal_bindings->items : NULL;
+        for (size_t l = 0; l < inst->literal_count; ++l)
+        {
+            int bit = bindings ? single_bit(bindings[l].value) : -1;
+            if (bit < 0)
+            {
+                LOG_ERROR("❌ Batch: %s literal %zu is not a single bit", inst->name, l);
+                return -1;
+            }
+            gate->literal_bits[l] = (uint8_t)bit;
+        }
+        next_literal += inst->literal_count;
+
+        const ConditionalInvocation *ci = inst->definition->conditional_invocation;
+        if (!ci || !ci->pattern_args || !ci->output)
+            continue;
+        gate->has_logic = true;
+
+        size_t rows = (size_t)1 << ci->arg_count;
+        for (size_t row = 0; row < rows; ++row)
+        {
+            uint16_t c = truth_table_lookup(ci->truth_table, (uint32_t)row);
+            if (c == TRUTH_TABLE_NO_CASE)
+                continue;
+            engine->terms[next_term].row = (uint32_t)row;
+            engine->terms[next_term].result = (uint8_t)single_bit(ci->cases[c].result);
+            next_term++;
+        }
+        gate->term_count = (uint32_t)(next_term - gate->first_term);
+    }
+
+    return 0;
+}
+
+static void fill_words(uint64_t *words, size_t count, uint64_t pattern)
+{
+    for (size_t w = 0; w < count; ++w)
+        words[w] = pattern;
+}
+
+/**
+ * One instance over every vector. Mirrors eval_instance: literals are
+ * published first, and the output is only written for vectors whose inputs
+ * are all driven and whose pattern matched a Case. Returns true on change.
+ */
+static bool eval_gate(BatchEngine *engine, const BatchGate *gate)
+{
+    const Instance *inst = gate->inst;
+    size_t words = engine->word_count;
+
+    for (size_t l = 0; l < inst->literal_count; ++l)
+    {
+        SignalId id = inst->literal_ids[l];
+        if (id == SIGNAL_ID_NONE || id >= engine->signal_count)
+            continue;
+        fill_words(engine->value + id * words, words, gate->literal_bits[l] ? BATCH_ALL_ONES : 0);
+        fill_words(engine->valid + id * words, words, BATCH_ALL_ONES);
+    }
+
+    SignalId out = inst->output_id;
+    if (!gate->has_logic || out == SIGNAL_ID_NONE || out >= engine->signal_count || inst->input_count == 0)
+        return false;
+    for (size_t i = 0; i < inst->input_count; ++i)
+        if (inst->input_ids[i] == SIGNAL_ID_NONE || inst->input_ids[i] >= engine->signal_count)
+            return false;
+    for (size_t j = 0; j < inst->pattern_count; ++j)
+        if (inst->pattern_ids[j] == SIGNAL_ID_NONE || inst->pattern_ids[j] >= engine->signal_count)
+            return false;
+
+    const BatchTerm *terms = engine->terms + gate->first_term;
+    size_t args = inst->pattern_count;
+    bool changed = false;
+
+    for (size_t base = 0; base < words; base += BATCH_LANE_WORDS)
+    {
+        uint64_t ready[BATCH_LANE_WORDS], any[BATCH_LANE_WORDS], ones[BATCH_LANE_WORDS];
+        for (size_t k = 0; k < BATCH_LANE_WORDS; ++k)
+        {
+            ready[k] = BATCH_ALL_ONES;
+            any[k] = ones[k] = 0;
+        }
+
+        for (size_t i = 0; i < inst->input_count; ++i)
+        {
+            const uint64_t *v = engine->valid + inst->input_ids[i] * words + base;
+            for (size_t k = 0; k < BATCH_LANE_WORDS; ++k)
+                ready[k] &= v[k];
+        }
+        for (size_t j = 0; j < args; ++j)
+        {
+            const uint64_t *v = engine->valid + inst->pattern_ids[j] * words + base;
+            for (size_t k = 0; k < BATCH_LANE_WORDS; ++k)
+                ready[k] &= v[k];
+        }
+
+        for (uint32_t t = 0; t < gate->term_count; ++t)
+        {
+            uint64_t match[BATCH_LANE_WORDS];
+            for (size_t k = 0; k < BATCH_LANE_WORDS; ++k)
+                match[k] = BATCH_ALL_ONES;
+
+            // Template arg 0 is the most significant bit of the row
+            for (size_t j = 0; j < args; ++j)
+            {
+                const uint64_t *x = engine->value + inst->pattern_ids[j] * words + base;
+                uint64_t flip = (terms[t].row >> (args - 1 - j)) & 1 ? 0 : BATCH_ALL_ONES;
+                for (size_t k = 0; k < BATCH_LANE_WORDS; ++k)
+                    match[k] &= x[k] ^ flip;
+            }
+
+            uint64_t result = terms[t].result ? BATCH_ALL_ONES : 0;
+            for (size_t k = 0; k < BATCH_LANE_WORDS; ++k)
+            {
+                any[k] |= match[k];
+                ones[k] |= match[k] & result;
+            }
+        }
+
+        uint64_t *value = engine->value + out * words + base;
+        uint64_t *valid = engine->valid + out * words + base;
+        uint64_t diff = 0;
+        for (size_t k = 0; k < BATCH_LANE_WORDS; ++k)
+        {
+            uint64_t hit = any[k] & ready[k];
+            uint64_t next_value = (value[k] & ~hit) | (ones[k] & hit);
+            uint64_t next_valid = valid[k] | hit;
+            diff |= (next_value ^ value[k]) | (next_valid ^ valid[k]);
+            value[k] = next_value;
+            valid[k] = next_valid;
+        }
+        changed |= diff != 0;
+    }
+
+    return changed;
+}
+
+static void run_schedule(BatchEngine *engine)
+{
+    const Schedule *schedule = engine->schedule;
+    for (size_t s = 0; s < schedule->step_count; ++s)
+    {
+        const ScheduleStep *step = &schedule->steps[s];
+        int rounds = step->iterative ? BATCH_LOOP_ROUNDS : 1;
+        for (int round = 0; round < rounds; ++round)
+        {
+            bool changed = false;
+            for (uint32_t i = step->first; i < step->first + step->count; ++i)
+            {
+                const BatchGate *gate = &engine->gates[schedule->order[i]];
+                if (gate->inst)
+                    changed |= eval_gate(engine, gate);
+            }
+            if (!changed)
+                break;
+            if (step->iterative && round + 1 == rounds)
+                LOG_WARN("⚠️ Batch: feedback loop of %u instance(s) at level %u did not settle in %d rounds",
+                         step->count, step->level, BATCH_LOOP_ROUNDS);
+        }
+    }
+}
+
+// Signals some instance reads but no instance (or literal binding) drives
+static int collect_primary_inputs(const Schedule *schedule, size_t signal_count, BatchStimuli *stimuli)
+{
+    uint8_t *role = calloc(signal_count ? signal_count : 1, 1); // bit 0: read, bit 1: written
+    stimuli->inputs = malloc(sizeof(SignalId) * (signal_count ? signal_count : 1));
+    if (!role || !stimuli->inputs)
+    {
+        free(role);
+        return -1;
+    }
+
+    for (size_t i = 0; i < schedule->instance_count; ++i)
+    {
+        const Instance *inst = schedule->instances[i];
+        if (!inst)
+            continue;
+        if (inst->output_id < signal_count)
+            role[inst->output_id] |= 2;
+        for (size_t l = 0; l < inst->literal_count; ++l)
+            if (inst->literal_ids[l] < signal_count)
+                role[inst->literal_ids[l]] |= 2;
+        for (size_t k = 0; k < inst->input_count; ++k)
+            if (inst->input_ids[k] < signal_count)
+                role[inst->input_ids[k]] |= 1;
+        for (size_t k = 0; k < inst->pattern_count; ++k)
+            if (inst->pattern_ids[k] < signal_count)
+                role[inst->pattern_ids[k]] |= 1;
+    }
+
+    for (SignalId id = 0; id < signal_count; ++id)
+        if (role[id] == 1)
+            stimuli->inputs[stimuli->input_count++] = id;
+
+    free(role);
+    return 0;
+}
+
+static int random_stimuli(const Schedule *schedule, size_t signal_count, size_t vector_count, BatchStimuli *stimuli)
+{
+    if (collect_primary_inputs(schedule, signal_count, stimuli) != 0)
+        return -1;
+
+    stimuli->vector_count = vector_count;
+    stimuli->word_count = words_for(vector_count);
+    stimuli->bits = calloc(stimuli->input_count * stimuli->word_count + 1, sizeof(uint64_t));
+    if (!stimuli->bits)
+        return -1;
+
+    // mkrand logs every block it makes
+    LogLevel saved_level = log_get_level();
+    log_set_level(saved_level > LOG_LEVEL_WARN ? saved_level : LOG_LEVEL_WARN);
+    size_t used_words = (vector_count + 63) / 64;
+    for (size_t i = 0; i < stimuli->input_count; ++i)
+    {
+        uint64_t *words = stimuli->bits + i * stimuli->word_count;
+        for (size_t w = 0; w < used_words; w += 2)
+        {
+            struct in6_addr block = mkrand_generate_ipv6();
+            memcpy(&words[w], block.s6_addr, sizeof(uint64_t));
+            if (w + 1 < used_words)
+                memcpy(&words[w + 1], block.s6_addr + sizeof(uint64_t), sizeof(uint64_t));
+        }
+    }
+    log_set_level(saved_level);
+
+    LOG_INFO("🎲 Batch: %zu random vector(s) from mkrand over %zu primary input(s)", vector_count, stimuli->input_count);
+    return 0;
+}
+
+static int read_stimuli_file(const char *path, SignalMap *signal_map, BatchStimuli *stimuli)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        LOG_ERROR("❌ Batch: cannot open stimuli file %s", path);
+        return -1;
+    }
+
+    char *line = NULL;
+    size_t line_cap = 0, capacity = 0, line_no = 0;
+    int rc = 0;
+
+    while (getline(&line, &line_cap, f) != -1)
+    {
+        line_no++;
+        char *hash = strchr(line, '#');
+        if (hash)
+            *hash = '\0';
+
+        if (!stimuli->inputs)
+        {
+            // Header: input signal names
+            size_t name_cap = 16;
+            stimuli->inputs = malloc(sizeof(SignalId) * name_cap);
+            if (!stimuli->inputs)
+            {
+                rc = -1;
+                break;
+            }
+            for (char *tok = strtok(line, " \t\r\n"); tok; tok = strtok(NULL, " \t\r\n"))
+            {
+                SignalId id = signal_map_find(signal_map, tok);
+                if (id == SIGNAL_ID_NONE)
+                {
+                    LOG_ERROR("❌ Batch: %s:%zu: unknown signal '%s'", path, line_no, tok);
+                    rc = -1;
+                    break;
+                }
+                if (stimuli->input_count == name_cap)
+                {
+                    name_cap *= 2;
+                    SignalId *grown = realloc(stimuli->inputs, sizeof(SignalId) * name_cap);
+                    if (!grown)
+                    {
+                        rc = -1;
+                        break;
+                    }
+                    stimuli->inputs = grown;
+                }
+                stimuli->inputs[stimuli->input_count++] = id;
+            }
+            if (rc != 0)
+                break;
+            if (stimuli->input_count == 0)
+            {
+                free(stimuli->inputs); // Blank or comment-only line: still waiting for the header
+                stimuli->inputs = NULL;
+            }
+            continue;
+        }
+
+        size_t bit_count = 0;
+        for (const char *p = line; *p; ++p)
+            if (!isspace((unsigned char)*p))
+                bit_count++;
+        if (bit_count == 0)
+            continue;
+        if (bit_count != stimuli->input_count)
+        {
+            LOG_ERROR("❌ Batch: %s:%zu: %zu bit(s) for %zu input(s)", path, line_no, bit_count, stimuli->input_count);
+            rc = -1;
+            break;
+        }
+
+        // Vectors are stored input-major, so growing means re-spacing every input's words
+        size_t v = stimuli->vector_count;
+        if (v == capacity)
+        {
+            size_t new_capacity = capacity ? capacity * 2 : 512;
+            size_t old_words = stimuli->word_count, new_words = words_for(new_capacity);
+            uint64_t *bits = calloc(stimuli->input_count * new_words + 1, sizeof(uint64_t));
+            if (!bits)
+            {
+                rc = -1;
+                break;
+            }
+            for (size_t i = 0; i < stimuli->input_count && old_words; ++i)
+                memcpy(bits + i * new_words, stimuli->bits + i * old_words, sizeof(uint64_t) * old_words);
+            free(stimuli->bits);
+            stimuli->bits = bits;
+            stimuli->word_count = new_words;
+            capacity = new_capacity;
+        }
+
+        size_t i = 0;
+        for (const char *p = line; *p; ++p)
+        {
+            if (isspace((unsigned char)*p))
+                continue;
+            if (*p != '0' && *p != '1')
+            {
+                LOG_ERROR("❌ Batch: %s:%zu: '%c' is not a bit", path, line_no, *p);
+                rc = -1;
+                break;
+            }
+            if (*p == '1')
+                stimuli->bits[i * stimuli->word_count + v / 64] |= (uint64_t)1 << (v % 64);
+            i++;
+        }
+        if (rc != 0)
+            break;
+        stimuli->vector_count++;
+    }
+
+    free(line);
+    fclose(f);
+
+    if (rc == 0 && stimuli->vector_count == 0)
+    {
+        LOG_ERROR("❌ Batch: %s has no vectors", path);
+        rc = -1;
+    }
+    if (rc == 0)
+        LOG_INFO("📥 Batch: %zu vector(s) over %zu input(s) from %s", stimuli->vector_count, stimuli->input_count, path);
+    return rc;
+}
+
+// Signals no stimulus drives start from their current value in every vector
+static int init_engine(BatchEngine *engine, const SignalMap *signal_map, const BatchStimuli *stimuli)
+{
+    size_t words = engine->word_count;
+    engine->value = calloc(engine->signal_count * words + 1, sizeof(uint64_t));
+    engine->valid = calloc(engine->signal_count * words + 1, sizeof(uint64_t));
+    if (!engine->value || !engine->valid)
+        return -1;
+
+    for (SignalId id = 0; id < engine->signal_count; ++id)
+    {
+        uint8_t bit = signal_map_get_bit(signal_map, id);
+        if (bit > 1)
+            continue; // Undriven, or a wide value the bitwise form cannot hold
+        fill_words(engine->value + id * words, words, bit ? BATCH_ALL_ONES : 0);
+        fill_words(engine->valid + id * words, words, BATCH_ALL_ONES);
+    }
+
+    for (size_t i = 0; i < stimuli->input_count; ++i)
+    {
+        SignalId id = stimuli->inputs[i];
+        memcpy(engine->value + id * words, stimuli->bits + i * stimuli->word_count, sizeof(uint64_t) * words);
+        fill_words(engine->valid + id * words, words, BATCH_ALL_ONES);
+    }
+    return 0;
+}
+
+// Header of observed signals (every instance output), then one row per vector
+static int write_results(const BatchEngine *engine, SignalMap *signal_map, const char *path)
+{
+    FILE *f = path ? fopen(path, "w") : stdout;
+    if (!f)
+    {
+        LOG_ERROR("❌ Batch: cannot write %s", path);
+        return -1;
+    }
+
+    size_t words = engine->word_count;
+    uint8_t *observed = calloc(engine->signal_count ? engine->signal_count : 1, 1);
+    if (!observed)
+    {
+        if (path)
+            fclose(f);
+        return -1;
+    }
+    for (size_t i = 0; i < engine->schedule->instance_count; ++i)
+    {
+        const Instance *inst = engine->gates[i].inst;
+        if (inst && engine->gates[i].has_logic && inst->output_id < engine->signal_count)
+            observed[inst->output_id] = 1;
+    }
+
+    fprintf(f, "# vector");
+    for (SignalId id = 0; id < engine->signal_count; ++id)
+        if (observed[id])
+            fprintf(f, " %s", signal_map_name(signal_map, id));
+    fprintf(f, "\n");
+
+    for (size_t v = 0; v < engine->vector_count; ++v)
+    {
+        fprintf(f, "%zu ", v);
+        for (SignalId id = 0; id < engine->signal_count; ++id)
+        {
+            if (!observed[id])
+                continue;
+            uint64_t mask = (uint64_t)1 << (v % 64);
+            size_t w = id * words + v / 64;
+            fputc(!(engine->valid[w] & mask) ? 'x' : (engine->value[w] & mask) ? '1' : '0', f);
+        }
+        fputc('\n', f);
+    }
+
+    free(observed);
+    if (path)
+        fclose(f);
+    return 0;
+}
+
+int batch_eval(Block *blk, SignalMap *signal_map, const BatchOptions *options)
+{
+    if (!blk || !signal_map || !options)
+        return -1;
+
+    // --load has no compile step, so the schedule is built on first use
+    if (!blk->schedule)
+        blk->schedule = build_schedule(blk, signal_map);
+    if (!blk->schedule)
+    {
+        LOG_ERROR("❌ Batch: no evaluation schedule");
+        return -1;
+    }
+
+    BatchEngine engine = {0};
+    BatchStimuli stimuli = {0};
+    engine.schedule = blk->schedule;
+    engine.signal_count = signal_map->count;
+
+    int rc = options->stimuli_path
+        ? read_stimuli_file(options->stimuli_path, signal_map, &stimuli)
+        : random_stimuli(engine.schedule, engine.signal_count, options->random_vectors ? options->random_vectors : 64, &stimuli);
+    if (rc == 0)
+        rc = lower_netlist(&engine);
+
+    if (rc == 0)
+    {
+        engine.vector_count = stimuli.vector_count;
+        engine.word_count = words_for(stimuli.vector_count);
+        rc = init_engine(&engine, signal_map, &stimuli);
+    }
+
+    if (rc == 0)
+    {
+        double start = now_ms();
+        run_schedule(&engine);
+        double elapsed = now_ms() - start;
+
+        double gate_evals = (double)engine.schedule->instance_count * (double)engine.vector_count;
+        LOG_INFO("🧪 Batch: %zu vector(s) × %zu instance(s) in %.3f ms (%.1f M gate-evals/s)",
+                 engine.vector_count, engine.schedule->instance_count, elapsed,
+                 elapsed > 0.0 ? gate_evals / elapsed / 1000.0 : 0.0);
+
+        rc = write_results(&engine, signal_map, options->output_path);
+    }
+
+    destroy_engine(&engine);
+    destroy_stimuli(&stimuli);
+    return rc;
+}
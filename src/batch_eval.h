@@ -0,0 +1,30 @@
+#ifndef BATCH_EVAL_H
+#define BATCH_EVAL_H
+#include "block.h"
+#include "signal_map.h"
+#include <stddef.h>
+
+// Bit-sliced batch evaluation. Every signal holds one bit per test vector,
+// 64 vectors to a uint64_t word, so one levelized pass over the netlist
+// evaluates the whole batch. Each ConditionalInvocation is lowered to a
+// sum of products: one AND term per Case pattern, ORed by result.
+//
+// Stimuli file format: '#' starts a comment; the first line names the
+// input signals; every following line is one vector, one 0/1 per input
+// (whitespace between bits is optional).
+
+// Upper bound for random_vectors: each signal takes vectors / 8 bytes of values
+// and as many of validity bits, so 2^20 vectors is 256 KiB a signal
+#define BATCH_MAX_RANDOM_VECTORS (1u << 20)
+
+typedef struct BatchOptions {
+    const char *stimuli_path;   // Stimuli file, or NULL to use random_vectors
+    size_t random_vectors;      // Vectors drawn from mkrand for every primary input
+    const char *output_path;    // One row per vector; NULL → stdout
+} BatchOptions;
+
+// Leaves the SignalMap untouched. Returns 0 on success, -1 if the stimuli
+// cannot be read or some instance has no bitwise form (wide values).
+int batch_eval(Block *blk, SignalMap *signal_map, const BatchOptions *options);
+
+#endif
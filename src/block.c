@@ -1,7 +1,13 @@
 #include "block.h"
+#include "netlist_image.h"
 #include "block_util.h"
+#include "bytecode.h"
 #include "instance.h"
+#include "intern.h"
 #include "log.h"
+#include "netlist.h"
+#include "schedule.h"
+#include "jit.h"
 #include "mkrand.h"
 #include "string_list.h"
 #include <stdlib.h>
@@ -22,7 +28,7 @@ void print_block(const Block *blk)
         LOG_INFO("    Inputs: ");
         for (size_t i = 0; i < string_list_count(instance->definition->input_signals); i++)
         {
-            LOG_INFO("%s ", string_list_get_by_index(instance->definition->input_signals, i));
+            LOG_INFO("%s ", string_list_get(instance->definition->input_signals, i));
         }
 
         LOG_INFO("\n    Outputs: ");
@@ -30,7 +36,7 @@ void print_block(const Block *blk)
         {
             for (size_t i = 0; i < string_list_count(instance->definition->output_signals); i++)
             {
-                LOG_INFO("%s ", string_list_get_by_index(instance->definition->output_signals, i));
+                LOG_INFO("%s ", string_list_get(instance->definition->output_signals, i));
             }
         }
 
@@ -43,13 +49,13 @@ void print_block(const Block *blk)
         LOG_INFO("\n    Inputs: ");
         for (size_t i = 0; i < string_list_count(instance->invocation->input_signals); i++)
         {
-            LOG_INFO("%s ", string_list_get_by_index(instance->invocation->input_signals, i));
+            LOG_INFO("%s ", string_list_get(instance->invocation->input_signals, i));
         }
 
         LOG_INFO("\n    Outputs: ");
         for (size_t i = 0; i < string_list_count(instance->invocation->output_signals); i++)
         {
-            LOG_INFO("%s ", string_list_get_by_index(instance->invocation->output_signals, i));
+            LOG_INFO("%s ", string_list_get(instance->invocation->output_signals, i));
         }
 
         LOG_INFO("\n");
@@ -61,7 +67,7 @@ void block_add_instance(Block *blk, Instance *instance)
     if (!blk || !instance)
         return;
 
-    InstanceList *node = malloc(sizeof(InstanceList));
+    InstanceList *node = arena_alloc(blk->arena, sizeof(InstanceList));
     if (!node)
     {
         LOG_ERROR("❌ Failed to allocate memory for InstanceList node.");
@@ -72,15 +78,104 @@ void block_add_instance(Block *blk, Instance *instance)
     node->next = NULL;
 
     if (!blk->instances)
-    {
         blk->instances = node;
-        return;
+    else
+        blk->instances_tail->next = node;
+    blk->instances_tail = node;
+}
+
+int block_index_definitions(Block *blk)
+{
+    if (!blk)
+        return -1;
+
+    size_t count = 0;
+    for (Definition *def = blk->definitions; def; def = def->next)
+        count++;
+
+    // Load factor under 1/2, as in the signal map
+    size_t slot_count = 16;
+    while (slot_count < count * 2)
+        slot_count *= 2;
+    Definition **slots = arena_calloc(blk->arena, slot_count, sizeof(Definition *));
+    if (!slots)
+    {
+        blk->definition_slots = NULL;
+        blk->definition_slot_count = 0;
+        LOG_ERROR("❌ Failed to allocate the definition index; lookups fall back to a scan");
+        return -1;
+    }
+
+    size_t mask = slot_count - 1;
+    for (Definition *def = blk->definitions; def; def = def->next)
+    {
+        if (!def->name)
+            continue;
+        // Definition names are interned (parser, image loader, create_definition)
+        size_t slot = intern_hash(def->name) & mask;
+        while (slots[slot] && slots[slot]->name != def->name)
+            slot = (slot + 1) & mask;
+        if (!slots[slot])
+            slots[slot] = def; // An earlier definition of the same name shadows later ones
     }
 
-    // Walk to end of list
-    InstanceList *cur = blk->instances;
-    while (cur->next)
-        cur = cur->next;
+    blk->definition_slots = slots;
+    blk->definition_slot_count = slot_count;
+    return 0;
+}
+
+Definition *block_find_definition(const Block *blk, const char *name)
+{
+    if (!blk || !name)
+        return NULL;
+
+    if (!blk->definition_slots)
+    {
+        for (Definition *def = blk->definitions; def; def = def->next)
+            if (def->name && strcmp(def->name, name) == 0)
+                return def;
+        return NULL;
+    }
+
+    const char *interned = intern_lookup(name);
+    if (!interned)
+        return NULL;
+
+    size_t mask = blk->definition_slot_count - 1;
+    for (size_t slot = intern_hash(interned) & mask; blk->definition_slots[slot]; slot = (slot + 1) & mask)
+        if (blk->definition_slots[slot]->name == interned)
+            return blk->definition_slots[slot];
+    return NULL;
+}
+
+void block_release(Block *blk)
+{
+    if (!blk)
+        return;
+
+    jit_release(blk->jit);
+    blk->jit = NULL;
+    bytecode_release(blk->bytecode);
+    blk->bytecode = NULL;
+    destroy_netlist(blk->netlist);
+    blk->netlist = NULL;
+    destroy_schedule(blk->schedule);
+    blk->schedule = NULL;
+
+    if (blk->arena)
+    {
+        LOG_INFO("🧹 Releasing netlist arena (%zu bytes in use, %zu reserved)",
+                 blk->arena->allocated, blk->arena->reserved);
+        arena_destroy(blk->arena);
+    }
+    blk->arena = NULL;
+    blk->definitions = NULL;
+    blk->invocations = NULL;
+    blk->instances = NULL;
+    blk->instances_tail = NULL;
+    blk->definition_slots = NULL;
+    blk->definition_slot_count = 0;
 
-    cur->next = node;
+    netlist_image_close(blk->image); // Last: the arena's instances pointed into it
+    blk->image = NULL;
 }
@@ -3,6 +3,8 @@
 #include "string_list.h"
 #include "invocation.h"
 #include "instance.h"
+#include "arena.h"
+#include "build_cache.h"
 #include <stdint.h>
 #include <stddef.h>
 #include <netinet/in.h>
@@ -14,13 +16,32 @@
 
 // === Core Structures ===
 
+struct Schedule;
+struct JitModule;
+struct Bytecode;
+struct Netlist;
+struct NetlistImage;
+
 typedef struct Block {
     psi128_t psi;
     Invocation *invocations;
     Definition *definitions;
     InstanceList *instances;
+    InstanceList *instances_tail; // Last node of instances, so appends are O(1)
+    Arena *arena;               // Netlist arena: definitions, invocations, instances
+    BuildCache *cache;          // Set while compiling; NULL = emit everything
+    struct Schedule *schedule;  // Levelized evaluation order (see schedule.h); NULL until compiled
+    struct Netlist *netlist;    // Schedule-ordered SoA copy of the instances (see netlist.h)
+    struct JitModule *jit;      // Native code for the schedule (see jit.h); NULL until first native eval
+    struct Bytecode *bytecode;  // VM program for the schedule (see bytecode.h); NULL until first bytecode eval
+    Definition **definition_slots; // Open-addressing index over definitions by interned name (arena)
+    size_t definition_slot_count;  // Power of two; 0 until block_index_definitions
+    struct NetlistImage *image; // Mapping that instances and truth tables point into, if loaded (see netlist_image.h)
 } Block;
 
 void block_add_instance(Block *blk, Instance *instance);
+int block_index_definitions(Block *blk); // (Re)build the name index after definitions are linked
+Definition *block_find_definition(const Block *blk, const char *name); // First match in list order
+void block_release(Block *blk); // Drops the whole netlist in one go; keeps psi
 
 #endif
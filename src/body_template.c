@@ -0,0 +1,399 @@
+#include "body_template.h"
+#include "intern.h"
+#include "log.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Pointer → value, open addressing; keys are Definitions or interned names
+typedef struct PointerMap {
+    const void **keys;
+    uintptr_t *values;
+    size_t slot_count;    // Power of two, or 0 before first insert
+    size_t count;
+} PointerMap;
+
+struct BodyTemplates {
+    Block *blk;
+    SignalMap *signal_map;
+    PointerMap templates;   // Definition → BodyTemplate
+    PointerMap instantiated; // Parent instance name → first reserved SignalId
+    size_t template_count;
+};
+
+static size_t pointer_slot(const void *key, size_t slot_count)
+{
+    uint64_t h = (uint64_t)(uintptr_t)key * 0x9E3779B97F4A7C15ull;
+    return (size_t)(h >> 32) & (slot_count - 1);
+}
+
+static bool pointer_map_get(const PointerMap *map, const void *key, uintptr_t *value)
+{
+    if (!map->slot_count)
+        return false;
+    for (size_t slot = pointer_slot(key, map->slot_count); map->keys[slot]; slot = (slot + 1) & (map->slot_count - 1))
+    {
+        if (map->keys[slot] == key)
+        {
+            *value = map->values[slot];
+            return true;
+        }
+    }
+    return false;
+}
+
+static int pointer_map_put(PointerMap *map, const void *key, uintptr_t value)
+{
+    if ((map->count + 1) * 2 > map->slot_count)
+    {
+        size_t new_count = map->slot_count ? map->slot_count * 2 : 64;
+        const void **keys = calloc(new_count, sizeof(void *));
+        uintptr_t *values = malloc(sizeof(uintptr_t) * new_count);
+        if (!keys || !values)
+        {
+            free(keys);
+            free(values);
+            return -1;
+        }
+        for (size_t i = 0; i < map->slot_count; ++i)
+        {
+            if (!map->keys[i])
+                continue;
+            size_t slot = pointer_slot(map->keys[i], new_count);
+            while (keys[slot])
+                slot = (slot + 1) & (new_count - 1);
+            keys[slot] = map->keys[i];
+            values[slot] = map->values[i];
+        }
+        free(map->keys);
+        free(map->values);
+        map->keys = keys;
+        map->values = values;
+        map->slot_count = new_count;
+    }
+
+    size_t slot = pointer_slot(key, map->slot_count);
+    while (map->keys[slot] && map->keys[slot] != key)
+        slot = (slot + 1) & (map->slot_count - 1);
+    if (!map->keys[slot])
+        map->count++;
+    map->keys[slot] = key;
+    map->values[slot] = value;
+    return 0;
+}
+
+static void pointer_map_free(PointerMap *map)
+{
+    free(map->keys);
+    free(map->values);
+}
+
+// ─── Template construction ─────────────────────────────────────────
+
+typedef struct TemplateBuilder {
+    BodyTemplates *templates;
+    const char **locals;    // Heap while building, copied to the arena at the end
+    size_t local_count;
+    size_t local_capacity;
+    size_t item_first;      // First local of the item being bound; names repeat only within an item
+    int failed;
+} TemplateBuilder;
+
+static uint32_t local_port(TemplateBuilder *b, const char *suffix, const char *name)
+{
+    const char *local = intern_join(suffix, '.', name);
+    if (!local)
+    {
+        b->failed = 1;
+        return SIGNAL_ID_NONE;
+    }
+    for (size_t k = b->item_first; k < b->local_count; ++k)
+        if (b->locals[k] == local)
+            return (uint32_t)k | BODY_TEMPLATE_LOCAL;
+
+    if (b->local_count == b->local_capacity)
+    {
+        size_t new_capacity = b->local_capacity ? b->local_capacity * 2 : 16;
+        const char **locals = realloc(b->locals, sizeof(const char *) * new_capacity);
+        if (!locals)
+        {
+            b->failed = 1;
+            return SIGNAL_ID_NONE;
+        }
+        b->locals = locals;
+        b->local_capacity = new_capacity;
+    }
+    b->locals[b->local_count] = local;
+    return (uint32_t)b->local_count++ | BODY_TEMPLATE_LOCAL;
+}
+
+// As create_instance's bind_qualified: dotted names are global, the rest belong to the instance
+static uint32_t bind_port(TemplateBuilder *b, const char *suffix, const char *name)
+{
+    if (!name)
+        return SIGNAL_ID_NONE;
+    if (strchr(name, '.'))
+        return signal_map_intern(b->templates->signal_map, name);
+    return local_port(b, suffix, name);
+}
+
+/**
+ * Port layout and binding rules mirror bind_instance_ports in instance.c,
+ * with the instance name left out of every local signal.
+ */
+static int bind_item(TemplateBuilder *b, BodyTemplateItem *item, Arena *arena)
+{
+    const Definition *def = item->definition;
+    const Invocation *inv = item->invocation;
+    const ConditionalInvocation *ci = def->conditional_invocation;
+    SignalMap *signal_map = b->templates->signal_map;
+
+    item->input_count = string_list_count(inv->input_signals);
+    item->output_count = string_list_count(inv->output_signals);
+    item->literal_count = inv->literal_bindings ? inv->literal_bindings->count : 0;
+    item->def_input_count = string_list_count(def->input_signals);
+    item->def_output_count = string_list_count(def->output_signals);
+    item->pattern_count = ci ? string_list_count(ci->pattern_args) : 0;
+
+    size_t port_count = item->input_count + item->output_count + item->literal_count +
+                        item->def_input_count + item->def_output_count + item->pattern_count;
+    item->ports = arena_alloc(arena, sizeof(uint32_t) * (port_count + 1));
+    if (!item->ports)
+        return -1;
+
+    b->item_first = b->local_count;
+    uint32_t *cursor = item->ports;
+    uint32_t *inputs = cursor;
+    for (size_t i = 0; i < item->input_count; ++i)
+        *cursor++ = bind_port(b, item->suffix, string_list_get(inv->input_signals, i));
+    for (size_t i = 0; i < item->output_count; ++i)
+        *cursor++ = bind_port(b, item->suffix, string_list_get(inv->output_signals, i));
+    for (size_t i = 0; i < item->literal_count; ++i)
+        *cursor++ = bind_port(b, item->suffix, inv->literal_bindings->items[i].name);
+    for (size_t i = 0; i < item->def_input_count; ++i)
+        *cursor++ = i < item->input_count ? inputs[i] : bind_port(b, item->suffix, string_list_get(def->input_signals, i));
+    for (size_t i = 0; i < item->def_output_count; ++i)
+        *cursor++ = bind_port(b, item->suffix, string_list_get(def->output_signals, i));
+
+    for (size_t i = 0; i < item->pattern_count; ++i)
+    {
+        const char *arg = string_list_get(ci->pattern_args, i);
+        uint32_t port = SIGNAL_ID_NONE;
+        for (size_t j = 0; j < item->def_input_count && j < item->input_count; ++j)
+        {
+            if (string_list_get(def->input_signals, j) == arg)
+            {
+                port = inputs[j];
+                break;
+            }
+        }
+        *cursor++ = port != SIGNAL_ID_NONE ? port : signal_map_intern(signal_map, arg);
+    }
+
+    *cursor = ci ? signal_map_intern(signal_map, ci->output) : SIGNAL_ID_NONE;
+    return b->failed ? -1 : 0;
+}
+
+static BodyTemplate *build_template(BodyTemplates *templates, const Definition *def)
+{
+    Block *blk = templates->blk;
+    Arena *arena = blk->arena;
+
+    size_t capacity = 0;
+    for (const BodyItem *body = def->body; body; body = body->next)
+        capacity += body->type == BODY_INVOCATION;
+
+    BodyTemplate *tpl = arena_calloc(arena, 1, sizeof(BodyTemplate));
+    if (!tpl)
+        return NULL;
+    tpl->definition = def;
+    tpl->items = arena_calloc(arena, capacity ? capacity : 1, sizeof(BodyTemplateItem));
+    if (!tpl->items)
+        return NULL;
+
+    TemplateBuilder b = {templates, NULL, 0, 0, 0, 0};
+    size_t sub_index = 0;
+    for (BodyItem *body = def->body; body; body = body->next)
+    {
+        if (body->type != BODY_INVOCATION)
+        {
+            sub_index++;
+            continue;
+        }
+
+        Invocation *sub_inv = body->data.invocation;
+        sub_inv->instance_id = (int)sub_index;
+
+        Definition *sub_def = block_find_definition(blk, sub_inv->target_name);
+        if (!sub_def)
+        {
+            LOG_WARN("⚠️ No definition for nested invocation %s", sub_inv->target_name);
+            continue; // A skipped invocation does not take an index
+        }
+
+        char suffix[256];
+        snprintf(suffix, sizeof(suffix), "%s.%zu", sub_inv->target_name, sub_index);
+
+        BodyTemplateItem *item = &tpl->items[tpl->item_count++];
+        item->suffix = intern(suffix);
+        item->definition = sub_def;
+        item->invocation = sub_inv;
+        if (!item->suffix || bind_item(&b, item, arena) != 0)
+        {
+            free(b.locals);
+            return NULL;
+        }
+        sub_index++;
+    }
+
+    tpl->local_count = b.local_count;
+    tpl->locals = arena_alloc(arena, sizeof(const char *) * (b.local_count ? b.local_count : 1));
+    if (!tpl->locals)
+    {
+        free(b.locals);
+        return NULL;
+    }
+    if (b.local_count)
+        memcpy(tpl->locals, b.locals, sizeof(const char *) * b.local_count);
+    free(b.locals);
+
+    templates->template_count++;
+    LOG_INFO("🧩 Body template for %s: %zu instance(s), %zu local signal(s)", def->name, tpl->item_count,
+             tpl->local_count);
+    return tpl;
+}
+
+static const BodyTemplate *template_for(BodyTemplates *templates, const Definition *def)
+{
+    uintptr_t value;
+    if (pointer_map_get(&templates->templates, def, &value))
+        return (const BodyTemplate *)value;
+
+    BodyTemplate *tpl = build_template(templates, def);
+    if (!tpl)
+    {
+        LOG_ERROR("❌ Failed to build the body template for %s", def->name);
+        return NULL;
+    }
+    if (pointer_map_put(&templates->templates, def, (uintptr_t)tpl) != 0)
+        LOG_WARN("⚠️ Could not cache the body template for %s", def->name);
+    return tpl;
+}
+
+// ─── Instantiation ─────────────────────────────────────────────────
+
+static Instance *instantiate_item(BodyTemplates *templates, const BodyTemplateItem *item, const char *parent_name,
+                                  SignalId first, const SignalId *bound)
+{
+    Arena *arena = templates->blk->arena;
+    Instance *inst = arena_calloc(arena, 1, sizeof(Instance));
+    if (!inst)
+        return NULL;
+
+    inst->name = intern_join(parent_name, '.', item->suffix);
+    inst->definition = item->definition;
+    inst->invocation = item->invocation;
+    inst->input_count = item->input_count;
+    inst->output_count = item->output_count;
+    inst->literal_count = item->literal_count;
+    inst->def_input_count = item->def_input_count;
+    inst->def_output_count = item->def_output_count;
+    inst->pattern_count = item->pattern_count;
+    inst->port_count = inst->input_count + inst->output_count + inst->literal_count + inst->def_input_count +
+                       inst->def_output_count + inst->pattern_count;
+    inst->ports = arena_alloc(arena, sizeof(SignalId) * (inst->port_count ? inst->port_count : 1));
+    if (!inst->name || !inst->ports)
+        return NULL;
+
+    // Relocate: locals land in the parent's reserved run, or on a signal that already had their name
+    for (size_t p = 0; p < inst->port_count; ++p)
+    {
+        uint32_t port = item->ports[p];
+        if (port == SIGNAL_ID_NONE || !(port & BODY_TEMPLATE_LOCAL))
+            inst->ports[p] = port;
+        else
+            inst->ports[p] = bound ? bound[port & ~BODY_TEMPLATE_LOCAL] : first + (port & ~BODY_TEMPLATE_LOCAL);
+    }
+    inst->output_id = item->ports[inst->port_count];
+
+    SignalId *cursor = inst->ports;
+    inst->input_ids = cursor;
+    cursor += inst->input_count;
+    inst->output_ids = cursor;
+    cursor += inst->output_count;
+    inst->literal_ids = cursor;
+    cursor += inst->literal_count;
+    inst->def_input_ids = cursor;
+    cursor += inst->def_input_count;
+    inst->def_output_ids = cursor;
+    cursor += inst->def_output_count;
+    inst->pattern_ids = cursor;
+    return inst;
+}
+
+size_t instantiate_body(BodyTemplates *templates, const Instance *parent)
+{
+    if (!templates || !parent || !parent->definition || !parent->definition->body)
+        return 0;
+
+    const BodyTemplate *tpl = template_for(templates, parent->definition);
+    if (!tpl || tpl->item_count == 0)
+        return 0;
+
+    // Instances that share a name share their signals, as qualified names always did
+    uintptr_t value;
+    SignalId first;
+    if (pointer_map_get(&templates->instantiated, parent->name, &value))
+    {
+        first = (SignalId)value;
+    }
+    else
+    {
+        first = signal_map_reserve(templates->signal_map, parent->name, tpl->locals, tpl->local_count);
+        if (first == SIGNAL_ID_NONE || pointer_map_put(&templates->instantiated, parent->name, first) != 0)
+        {
+            LOG_ERROR("❌ Failed to reserve %zu signal(s) for %s", tpl->local_count, parent->name);
+            return 0;
+        }
+    }
+
+    const SignalId *bound = signal_map_reserved_ids(templates->signal_map, first);
+    size_t added = 0;
+    for (size_t i = 0; i < tpl->item_count; ++i)
+    {
+        const BodyTemplateItem *item = &tpl->items[i];
+        Instance *inst = instantiate_item(templates, item, parent->name, first, bound);
+        if (!inst)
+        {
+            LOG_ERROR("❌ Failed to create nested instance: %s.%s", parent->name, item->suffix);
+            continue;
+        }
+        block_add_instance(templates->blk, inst);
+        added += 1 + instantiate_body(templates, inst);
+    }
+    return added;
+}
+
+BodyTemplates *create_body_templates(Block *blk, SignalMap *signal_map)
+{
+    if (!blk || !signal_map)
+        return NULL;
+    BodyTemplates *templates = calloc(1, sizeof(BodyTemplates));
+    if (!templates)
+        return NULL;
+    templates->blk = blk;
+    templates->signal_map = signal_map;
+    return templates;
+}
+
+void destroy_body_templates(BodyTemplates *templates)
+{
+    if (!templates)
+        return;
+    LOG_INFO("🧩 %zu body template(s), %zu instantiation(s)", templates->template_count,
+             templates->instantiated.count);
+    pointer_map_free(&templates->templates);
+    pointer_map_free(&templates->instantiated);
+    free(templates);
+}
@@ -0,0 +1,47 @@
+#ifndef BODY_TEMPLATE_H
+#define BODY_TEMPLATE_H
+#include "block.h"
+#include "signal_map.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Relocatable sub-netlist for one Definition body. Every port that
+// create_instance would qualify with the instance name is a local index
+// into `locals` (names relative to the instantiating instance, e.g.
+// "NOT.3.A"); the rest are global SignalIds, resolved once per template.
+// Instantiating a body reserves one contiguous run of signal ids for the
+// locals (see signal_map_reserve) and copies the ports with an offset:
+// no string formatting per signal, and names are built only when asked for.
+
+#define BODY_TEMPLATE_LOCAL 0x80000000u // Port flag: low bits are a local index
+
+typedef struct BodyTemplateItem {
+    const char *suffix;            // "<target>.<index>", interned
+    const Definition *definition;
+    const Invocation *invocation;
+    uint32_t *ports;               // Instance port order, then output_id
+    size_t input_count;
+    size_t output_count;
+    size_t literal_count;
+    size_t def_input_count;
+    size_t def_output_count;
+    size_t pattern_count;
+} BodyTemplateItem;
+
+typedef struct BodyTemplate {
+    const Definition *definition;
+    BodyTemplateItem *items;       // Body invocations with a definition, in body order
+    size_t item_count;
+    const char **locals;           // Interned, relative to the instantiating instance
+    size_t local_count;
+} BodyTemplate;
+
+typedef struct BodyTemplates BodyTemplates; // Per-unification cache (templates live in the Block's arena)
+
+BodyTemplates *create_body_templates(Block *blk, SignalMap *signal_map);
+void destroy_body_templates(BodyTemplates *templates);
+
+// Instantiate parent's definition body, recursively; returns the number of instances added
+size_t instantiate_body(BodyTemplates *templates, const Instance *parent);
+
+#endif
@@ -0,0 +1,366 @@
+#include "build_cache.h"
+#include "intern.h"
+#include "log.h"
+#include <openssl/evp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define BUILD_CACHE_MANIFEST ".rccache"
+#define BUILD_CACHE_HEADER "rccache 1"
+#define BUILD_CACHE_INITIAL_SLOTS 256
+
+// Mixed into every key. Bump BUILD_CACHE_FORMAT_VERSION whenever a compile
+// stage changes what it writes (stage S-expr/SPIR-V, constants, the netlist
+// image's layout or contents), so outputs of an older pipeline are never
+// reused. RCNODE_BUILD_ID (git describe, passed in by meson) also keeps
+// builds of different commits apart; both are stable across rebuilds.
+#define BUILD_CACHE_FORMAT_VERSION 2
+#ifndef RCNODE_BUILD_ID
+#define RCNODE_BUILD_ID "unknown"
+#endif
+#define BUILD_CACHE_STR_(x) #x
+#define BUILD_CACHE_STR(x) BUILD_CACHE_STR_(x)
+#define BUILD_CACHE_TAG "rcnode cache v" BUILD_CACHE_STR(BUILD_CACHE_FORMAT_VERSION) " " RCNODE_BUILD_ID
+
+typedef struct CacheEntry {
+    const char *path; // Interned; NULL = empty slot
+    unsigned char key[BUILD_CACHE_KEY_SIZE];
+} CacheEntry;
+
+// Open addressing on the interned path pointer
+typedef struct CacheTable {
+    CacheEntry *slots;
+    size_t slot_count; // Power of two, or 0 before first insert
+    size_t count;
+} CacheTable;
+
+struct BuildCache {
+    char manifest_path[512];
+    CacheTable previous; // Loaded from the manifest
+    CacheTable current;  // Recorded this run; becomes the next manifest
+    CacheTable sources;  // SHA-256 of each source file, computed once per run
+    size_t reused;
+    size_t written;
+};
+
+static CacheEntry *table_find(const CacheTable *table, const char *path)
+{
+    if (!table->slot_count)
+        return NULL;
+    size_t mask = table->slot_count - 1;
+    size_t slot = intern_hash(path) & mask;
+    while (table->slots[slot].path)
+    {
+        if (table->slots[slot].path == path)
+            return &table->slots[slot];
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
+}
+
+static int table_grow(CacheTable *table)
+{
+    size_t new_count = table->slot_count ? table->slot_count * 2 : BUILD_CACHE_INITIAL_SLOTS;
+    CacheEntry *slots = calloc(new_count, sizeof(CacheEntry));
+    if (!slots)
+        return -1;
+
+    size_t mask = new_count - 1;
+    for (size_t i = 0; i < table->slot_count; ++i)
+    {
+        const CacheEntry *entry = &table->slots[i];
+        if (!entry->path)
+            continue;
+        size_t slot = intern_hash(entry->path) & mask;
+        while (slots[slot].path)
+            slot = (slot + 1) & mask;
+        slots[slot] = *entry;
+    }
+
+    free(table->slots);
+    table->slots = slots;
+    table->slot_count = new_count;
+    return 0;
+}
+
+// Insert or overwrite; path must be interned
+static CacheEntry *table_put(CacheTable *table, const char *path, const unsigned char key[BUILD_CACHE_KEY_SIZE])
+{
+    CacheEntry *entry = table_find(table, path);
+    if (!entry)
+    {
+        if ((table->count + 1) * 2 > table->slot_count && table_grow(table) != 0)
+            return NULL;
+        size_t mask = table->slot_count - 1;
+        size_t slot = intern_hash(path) & mask;
+        while (table->slots[slot].path)
+            slot = (slot + 1) & mask;
+        entry = &table->slots[slot];
+        entry->path = path;
+        table->count++;
+    }
+    memcpy(entry->key, key, BUILD_CACHE_KEY_SIZE);
+    return entry;
+}
+
+static int hex_digit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+static void load_manifest(BuildCache *cache)
+{
+    FILE *in = fopen(cache->manifest_path, "r");
+    if (!in)
+        return; // First compile into this directory
+
+    char line[1024];
+    if (!fgets(line, sizeof(line), in) || strncmp(line, BUILD_CACHE_HEADER, strlen(BUILD_CACHE_HEADER)) != 0)
+    {
+        LOG_WARN("⚠️ Ignoring build cache with unknown format: %s", cache->manifest_path);
+        fclose(in);
+        return;
+    }
+
+    while (fgets(line, sizeof(line), in))
+    {
+        size_t len = strcspn(line, "\n");
+        line[len] = '\0';
+        if (len < 2 * BUILD_CACHE_KEY_SIZE + 2 || line[2 * BUILD_CACHE_KEY_SIZE] != ' ')
+            continue;
+
+        unsigned char key[BUILD_CACHE_KEY_SIZE];
+        int valid = 1;
+        for (size_t i = 0; i < BUILD_CACHE_KEY_SIZE && valid; ++i)
+        {
+            int hi = hex_digit(line[2 * i]), lo = hex_digit(line[2 * i + 1]);
+            valid = hi >= 0 && lo >= 0;
+            key[i] = (unsigned char)(hi << 4 | lo);
+        }
+        if (valid)
+            table_put(&cache->previous, intern(line + 2 * BUILD_CACHE_KEY_SIZE + 1), key);
+    }
+
+    fclose(in);
+    LOG_INFO("🗃️ Loaded build cache: %zu artifact(s) from %s", cache->previous.count, cache->manifest_path);
+}
+
+BuildCache *build_cache_open(const char *out_dir)
+{
+    if (!out_dir)
+        return NULL;
+
+    BuildCache *cache = calloc(1, sizeof(BuildCache));
+    if (!cache)
+        return NULL;
+
+    snprintf(cache->manifest_path, sizeof(cache->manifest_path), "%s/%s", out_dir, BUILD_CACHE_MANIFEST);
+    load_manifest(cache);
+    return cache;
+}
+
+int build_cache_save(BuildCache *cache)
+{
+    if (!cache)
+        return 0;
+
+    char tmp_path[sizeof(cache->manifest_path) + 4];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", cache->manifest_path);
+
+    FILE *out = fopen(tmp_path, "w");
+    if (!out)
+    {
+        LOG_ERROR("❌ Failed to write build cache: %s", tmp_path);
+        return -1;
+    }
+
+    fprintf(out, "%s\n", BUILD_CACHE_HEADER);
+    for (size_t i = 0; i < cache->current.slot_count; ++i)
+    {
+        const CacheEntry *entry = &cache->current.slots[i];
+        if (!entry->path || strchr(entry->path, '\n'))
+            continue;
+        for (size_t b = 0; b < BUILD_CACHE_KEY_SIZE; ++b)
+            fprintf(out, "%02x", entry->key[b]);
+        fprintf(out, " %s\n", entry->path);
+    }
+
+    // Replace atomically so an interrupted compile never leaves a torn manifest
+    if (fclose(out) != 0 || rename(tmp_path, cache->manifest_path) != 0)
+    {
+        LOG_ERROR("❌ Failed to update build cache: %s", cache->manifest_path);
+        remove(tmp_path);
+        return -1;
+    }
+
+    LOG_INFO("🗃️ Build cache: %zu artifact(s) reused, %zu written", cache->reused, cache->written);
+    return 0;
+}
+
+void build_cache_close(BuildCache *cache)
+{
+    if (!cache)
+        return;
+    free(cache->previous.slots);
+    free(cache->current.slots);
+    free(cache->sources.slots);
+    free(cache);
+}
+
+int build_cache_key_begin(BuildCacheKey *key)
+{
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+    if (!ctx || EVP_DigestInit_ex(ctx, EVP_sha256(), NULL) != 1)
+    {
+        EVP_MD_CTX_free(ctx);
+        key->ctx = NULL;
+        return -1;
+    }
+    key->ctx = ctx;
+    build_cache_key_add(key, BUILD_CACHE_TAG);
+    return 0;
+}
+
+void build_cache_key_add(BuildCacheKey *key, const char *field)
+{
+    if (!key->ctx)
+        return;
+
+    // Fields keep their terminator so ("ab","c") and ("a","bc") differ
+    static const unsigned char null_field[2] = {0xFF, 0};
+    if (field)
+        EVP_DigestUpdate(key->ctx, field, strlen(field) + 1);
+    else
+        EVP_DigestUpdate(key->ctx, null_field, sizeof(null_field));
+}
+
+int build_cache_key_finish(BuildCacheKey *key, unsigned char out[BUILD_CACHE_KEY_SIZE])
+{
+    if (!key->ctx)
+        return -1;
+    unsigned int len = 0;
+    int ok = EVP_DigestFinal_ex(key->ctx, out, &len) == 1 && len == BUILD_CACHE_KEY_SIZE;
+    EVP_MD_CTX_free(key->ctx);
+    key->ctx = NULL;
+    return ok ? 0 : -1;
+}
+
+static int hash_file(const char *path, unsigned char out[BUILD_CACHE_KEY_SIZE])
+{
+    FILE *in = fopen(path, "rb");
+    if (!in)
+        return -1;
+
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+    if (!ctx || EVP_DigestInit_ex(ctx, EVP_sha256(), NULL) != 1)
+    {
+        EVP_MD_CTX_free(ctx);
+        fclose(in);
+        return -1;
+    }
+
+    unsigned char buf[16 * 1024];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0)
+        EVP_DigestUpdate(ctx, buf, n);
+
+    unsigned int len = 0;
+    int ok = !ferror(in) && EVP_DigestFinal_ex(ctx, out, &len) == 1 && len == BUILD_CACHE_KEY_SIZE;
+    EVP_MD_CTX_free(ctx);
+    fclose(in);
+    return ok ? 0 : -1;
+}
+
+int build_cache_key_add_source(BuildCache *cache, BuildCacheKey *key, const char *source_path)
+{
+    if (!cache || !source_path || !key->ctx)
+        return -1;
+
+    const char *path = intern(source_path);
+    CacheEntry *entry = table_find(&cache->sources, path);
+    if (!entry)
+    {
+        unsigned char digest[BUILD_CACHE_KEY_SIZE];
+        if (hash_file(path, digest) != 0)
+            return -1;
+        entry = table_put(&cache->sources, path, digest);
+        if (!entry)
+            return -1;
+    }
+
+    build_cache_key_add(key, path);
+    EVP_DigestUpdate(key->ctx, entry->key, BUILD_CACHE_KEY_SIZE);
+    return 0;
+}
+
+int build_cache_source_key(BuildCache *cache, const char *source_path, unsigned char out[BUILD_CACHE_KEY_SIZE])
+{
+    if (!cache || !source_path)
+        return -1;
+
+    BuildCacheKey key;
+    if (build_cache_key_begin(&key) != 0)
+        return -1;
+    if (build_cache_key_add_source(cache, &key, source_path) != 0)
+    {
+        build_cache_key_finish(&key, out);
+        return -1;
+    }
+    return build_cache_key_finish(&key, out);
+}
+
+int build_cache_fresh(BuildCache *cache, const char *artifact_path, const unsigned char key[BUILD_CACHE_KEY_SIZE])
+{
+    if (!cache || !artifact_path)
+        return 0;
+
+    const char *path = intern(artifact_path);
+
+    // Several sources can emit to the same path (e.g. two invocations of one
+    // target); once it has been claimed this run only the same key may reuse it
+    const CacheEntry *claimed = table_find(&cache->current, path);
+    if (claimed)
+        return memcmp(claimed->key, key, BUILD_CACHE_KEY_SIZE) == 0;
+
+    const CacheEntry *prev = table_find(&cache->previous, path);
+    if (!prev || memcmp(prev->key, key, BUILD_CACHE_KEY_SIZE) != 0)
+        return 0;
+
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+        return 0;
+
+    table_put(&cache->current, path, key);
+    cache->reused++;
+    return 1;
+}
+
+int build_cache_outputs_present(const BuildCache *cache)
+{
+    if (!cache)
+        return 0;
+
+    for (size_t i = 0; i < cache->previous.slot_count; ++i)
+    {
+        const char *path = cache->previous.slots[i].path;
+        struct stat st;
+        if (path && (stat(path, &st) != 0 || !S_ISREG(st.st_mode)))
+            return 0;
+    }
+    return 1;
+}
+
+void build_cache_record(BuildCache *cache, const char *artifact_path, const unsigned char key[BUILD_CACHE_KEY_SIZE])
+{
+    if (!cache || !artifact_path)
+        return;
+    table_put(&cache->current, intern(artifact_path), key);
+    cache->written++;
+}
@@ -0,0 +1,41 @@
+#ifndef BUILD_CACHE_H
+#define BUILD_CACHE_H
+#include <stddef.h>
+
+// Content-addressed cache for compile artifacts. Every emitted file is
+// recorded in <out_dir>/.rccache with the SHA-256 of everything that went
+// into it (source file bytes, cache format version and build id, qualified
+// names). On the next compile an artifact whose key is unchanged and whose
+// file still exists is left alone instead of being regenerated. The netlist image is keyed on all
+// the inputs together: when none changed, compile_block loads it and skips
+// the pipeline entirely. A NULL cache disables all of this.
+
+#define BUILD_CACHE_KEY_SIZE 32
+
+typedef struct BuildCache BuildCache;
+
+// Incremental key builder (SHA-256 over the compiler tag and added fields)
+typedef struct BuildCacheKey {
+    void *ctx;
+} BuildCacheKey;
+
+BuildCache *build_cache_open(const char *out_dir); // Loads the previous manifest, if any
+int build_cache_save(BuildCache *cache);           // Writes the entries recorded this run
+void build_cache_close(BuildCache *cache);
+
+int build_cache_key_begin(BuildCacheKey *key);
+void build_cache_key_add(BuildCacheKey *key, const char *field); // NULL is a distinct field
+int build_cache_key_add_source(BuildCache *cache, BuildCacheKey *key, const char *source_path);
+int build_cache_key_finish(BuildCacheKey *key, unsigned char out[BUILD_CACHE_KEY_SIZE]);
+
+// Key for an artifact that depends only on one source file; -1 if not cacheable
+int build_cache_source_key(BuildCache *cache, const char *source_path, unsigned char out[BUILD_CACHE_KEY_SIZE]);
+
+// 1 if artifact_path is up to date for key (and records it); 0 if it must be written
+int build_cache_fresh(BuildCache *cache, const char *artifact_path, const unsigned char key[BUILD_CACHE_KEY_SIZE]);
+// 1 if every artifact listed in the previous manifest still exists
+int build_cache_outputs_present(const BuildCache *cache);
+// Call after artifact_path has been written for key
+void build_cache_record(BuildCache *cache, const char *artifact_path, const unsigned char key[BUILD_CACHE_KEY_SIZE]);
+
+#endif
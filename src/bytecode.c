@@ -0,0 +1,452 @@
+#include "bytecode.h"
+#include "log.h"
+#include "pubsub.h"
+#include "truth_table.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    OP_HALT,
+    OP_SET,
+    OP_LUT,
+    OP_LOOP,
+    OP_NEXT,
+    OP_COUNT
+};
+
+#define BYTECODE_UNSET   0xFF  // SIGNAL_BIT_UNSET
+#define BYTECODE_NO_CASE 0xFF  // Table row with no matching Case
+
+// Same cap as MAX_ITERATIONS in eval.c
+#define BYTECODE_LOOP_ROUNDS 5
+
+// Direct threading needs GCC's labels-as-values; elsewhere a switch does the same job
+#if defined(__GNUC__) && !defined(BYTECODE_SWITCH_DISPATCH)
+#define BYTECODE_THREADED 1
+#else
+#define BYTECODE_THREADED 0
+#endif
+
+typedef struct CodeBuffer {
+    uint32_t *words;
+    size_t length;
+    size_t capacity;
+    bool failed;
+} CodeBuffer;
+
+// Content-addressed table pool, so identical Definitions share one table
+typedef struct TablePool {
+    uint8_t *bytes;
+    size_t used;
+    size_t capacity;
+    uint32_t *offsets;        // Open addressing: offset + 1, 0 = empty
+    uint32_t *lengths;
+    size_t slot_count;        // Power of two
+    size_t table_count;
+    bool failed;
+} TablePool;
+
+static void emit_word(CodeBuffer *buf, uint32_t word)
+{
+    if (buf->failed)
+        return;
+    if (buf->length == buf->capacity)
+    {
+        size_t capacity = buf->capacity ? buf->capacity * 2 : 1024;
+        uint32_t *words = realloc(buf->words, sizeof(uint32_t) * capacity);
+        if (!words)
+        {
+            buf->failed = true;
+            return;
+        }
+        buf->words = words;
+        buf->capacity = capacity;
+    }
+    buf->words[buf->length++] = word;
+}
+
+static uint32_t hash_bytes(const uint8_t *bytes, size_t length)
+{
+    uint32_t h = 2166136261u; // FNV-1a
+    for (size_t i = 0; i < length; ++i)
+        h = (h ^ bytes[i]) * 16777619u;
+    return h;
+}
+
+static int pool_grow_slots(TablePool *pool)
+{
+    size_t slot_count = pool->slot_count ? pool->slot_count * 2 : 256;
+    uint32_t *offsets = calloc(slot_count, sizeof(uint32_t));
+    uint32_t *lengths = calloc(slot_count, sizeof(uint32_t));
+    if (!offsets || !lengths)
+    {
+        free(offsets);
+        free(lengths);
+        return -1;
+    }
+    for (size_t s = 0; s < pool->slot_count; ++s)
+    {
+        if (!pool->offsets[s])
+            continue;
+        size_t mask = slot_count - 1;
+        size_t slot = hash_bytes(pool->bytes + pool->offsets[s] - 1, pool->lengths[s]) & mask;
+        while (offsets[slot])
+            slot = (slot + 1) & mask;
+        offsets[slot] = pool->offsets[s];
+        lengths[slot] = pool->lengths[s];
+    }
+    free(pool->offsets);
+    free(pool->lengths);
+    pool->offsets = offsets;
+    pool->lengths = lengths;
+    pool->slot_count = slot_count;
+    return 0;
+}
+
+// Offset of an identical table already in the pool, or of a fresh copy
+static uint32_t pool_intern(TablePool *pool, const uint8_t *table, size_t length)
+{
+    if (pool->failed)
+        return 0;
+    if ((pool->table_count + 1) * 2 > pool->slot_count && pool_grow_slots(pool) != 0)
+    {
+        pool->failed = true;
+        return 0;
+    }
+
+    size_t mask = pool->slot_count - 1;
+    size_t slot = hash_bytes(table, length) & mask;
+    while (pool->offsets[slot])
+    {
+        if (pool->lengths[slot] == length && memcmp(pool->bytes + pool->offsets[slot] - 1, table, length) == 0)
+            return pool->offsets[slot] - 1;
+        slot = (slot + 1) & mask;
+    }
+
+    if (pool->used + length > pool->capacity)
+    {
+        size_t capacity = pool->capacity ? pool->capacity : 1024;
+        while (pool->used + length > capacity)
+            capacity *= 2;
+        uint8_t *bytes = realloc(pool->bytes, capacity);
+        if (!bytes)
+        {
+            pool->failed = true;
+            return 0;
+        }
+        pool->bytes = bytes;
+        pool->capacity = capacity;
+    }
+
+    uint32_t offset = (uint32_t)pool->used;
+    memcpy(pool->bytes + offset, table, length);
+    pool->used += length;
+    pool->offsets[slot] = offset + 1;
+    pool->lengths[slot] = (uint32_t)length;
+    pool->table_count++;
+    return offset;
+}
+
+static int single_bit(const char *value)
+{
+    if (value && (value[0] == '0' || value[0] == '1') && value[1] == '\0')
+        return value[0] - '0';
+    return -1;
+}
+
+static bool id_valid(SignalId id, size_t signal_count)
+{
+    return id != SIGNAL_ID_NONE && id < signal_count;
+}
+
+/**
+ * SET for each literal, then one LUT if the row can ever fire (see
+ * eval_instance). Inputs that are also template args are only checked once.
+ */
+static int compile_row(const Netlist *net, uint32_t row, size_t signal_count, CodeBuffer *code, TablePool *pool,
+                       uint8_t *published, uint8_t *scratch)
+{
+    const char *name = net->names[row];
+    for (uint32_t l = net->literal_first[row]; l < net->literal_first[row + 1]; ++l)
+    {
+        if (!id_valid(net->literal_slots[l], signal_count))
+            continue;
+        int bit = single_bit(net->literal_values[l]);
+        if (bit < 0)
+        {
+            LOG_WARN("⚠️ Bytecode: %s literal %u is not a single bit", name, l - net->literal_first[row]);
+            return -1;
+        }
+        emit_word(code, OP_SET | (uint32_t)bit << 8);
+        emit_word(code, net->literal_slots[l]);
+    }
+
+    if (!(net->flags[row] & NETLIST_ROW_LOGIC))
+        return 0;
+
+    const ConditionalInvocation *ci = net->logic[net->def_index[row]];
+    uint32_t input_count, pattern_count;
+    const SignalId *inputs = netlist_inputs(net, row, &input_count);
+    const SignalId *patterns = netlist_patterns(net, row, &pattern_count);
+    if (!ci->truth_table || ci->arg_count != pattern_count)
+    {
+        LOG_WARN("⚠️ Bytecode: %s has no truth table", name);
+        return -1;
+    }
+
+    SignalId output = net->output_slot[row];
+    if (!id_valid(output, signal_count))
+        return 0;
+    for (uint32_t i = 0; i < input_count; ++i)
+        if (!id_valid(inputs[i], signal_count))
+            return 0;
+    for (uint32_t j = 0; j < pattern_count; ++j)
+        if (!id_valid(patterns[j], signal_count))
+            return 0;
+
+    size_t rows = (size_t)1 << ci->arg_count;
+    for (size_t r = 0; r < rows; ++r)
+    {
+        uint16_t c = truth_table_lookup(ci->truth_table, (uint32_t)r);
+        int bit = c == TRUTH_TABLE_NO_CASE ? BYTECODE_NO_CASE : single_bit(ci->cases[c].result);
+        if (bit < 0)
+        {
+            LOG_WARN("⚠️ Bytecode: %s case %u result is not a single bit", name, c);
+            return -1;
+        }
+        scratch[r] = (uint8_t)bit;
+    }
+    uint32_t table = pool_intern(pool, scratch, rows);
+
+    uint32_t checks = 0;
+    for (uint32_t i = 0; i < input_count; ++i)
+    {
+        bool is_arg = false;
+        for (uint32_t j = 0; j < pattern_count && !is_arg; ++j)
+            is_arg = patterns[j] == inputs[i];
+        checks += !is_arg;
+    }
+
+    emit_word(code, OP_LUT | pattern_count << 8 | checks << 16);
+    emit_word(code, output);
+    emit_word(code, table);
+    for (uint32_t i = 0; i < input_count; ++i)
+    {
+        bool is_arg = false;
+        for (uint32_t j = 0; j < pattern_count && !is_arg; ++j)
+            is_arg = patterns[j] == inputs[i];
+        if (!is_arg)
+            emit_word(code, inputs[i]);
+    }
+    for (uint32_t j = 0; j < pattern_count; ++j)
+        emit_word(code, patterns[j]);
+
+    published[output] = 1;
+    return 1;
+}
+
+Bytecode *bytecode_compile(const Schedule *schedule, const Netlist *net, const SignalMap *signal_map)
+{
+    if (!schedule || !net || !signal_map)
+        return NULL;
+
+    size_t signal_count = signal_map->count;
+    Bytecode *program = calloc(1, sizeof(Bytecode));
+    uint8_t *scratch = malloc((size_t)1 << TRUTH_TABLE_MAX_ARGS);
+    CodeBuffer code = {0};
+    TablePool pool = {0};
+    if (!program || !scratch)
+        goto fail;
+
+    program->signal_count = signal_count;
+    program->published = calloc(signal_count ? signal_count : 1, 1);
+    program->values = malloc(signal_count ? signal_count : 1);
+    if (!program->published || !program->values)
+        goto fail;
+
+    for (size_t s = 0; s < schedule->step_count; ++s)
+    {
+        const ScheduleStep *step = &schedule->steps[s];
+        size_t body = code.length + 1;
+        if (step->iterative)
+            emit_word(&code, OP_LOOP);
+
+        for (uint32_t i = step->first; i < step->first + step->count; ++i)
+        {
+            int luts = compile_row(net, i, signal_count, &code, &pool, program->published, scratch);
+            if (luts < 0)
+                goto fail;
+            program->lut_count += (size_t)luts;
+        }
+
+        if (step->iterative)
+        {
+            emit_word(&code, OP_NEXT | BYTECODE_LOOP_ROUNDS << 8);
+            emit_word(&code, (uint32_t)body);
+        }
+    }
+    emit_word(&code, OP_HALT);
+
+    if (code.failed || pool.failed)
+    {
+        LOG_ERROR("❌ Bytecode: out of memory");
+        goto fail;
+    }
+
+    program->code = code.words;
+    program->code_length = code.length;
+    program->tables = pool.bytes;
+    program->table_bytes = pool.used;
+    free(pool.offsets);
+    free(pool.lengths);
+    free(scratch);
+
+    LOG_INFO("🧩 Bytecode: %zu LUT(s) in %zu word(s), %zu table(s) in %zu byte(s), %s dispatch",
+             program->lut_count, program->code_length, pool.table_count, program->table_bytes,
+             BYTECODE_THREADED ? "threaded" : "switch");
+    return program;
+
+fail:
+    free(code.words);
+    free(pool.bytes);
+    free(pool.offsets);
+    free(pool.lengths);
+    free(scratch);
+    bytecode_release(program);
+    return NULL;
+}
+
+void bytecode_release(Bytecode *program)
+{
+    if (!program)
+        return;
+    free(program->code);
+    free(program->tables);
+    free(program->published);
+    free(program->values);
+    free(program);
+}
+
+#if BYTECODE_THREADED
+// Labels-as-values are a GNU extension
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#define TARGET(op) L_##op:
+#define DISPATCH() goto *dispatch[*pc & 0xFF]
+#else
+#define TARGET(op) case op:
+#define DISPATCH() continue
+#endif
+
+static void run(const Bytecode *program, uint8_t *restrict v)
+{
+    const uint32_t *code = program->code;
+    const uint32_t *pc = code;
+    const uint8_t *tables = program->tables;
+    uint32_t changed = 0, round = 0;
+
+#if BYTECODE_THREADED
+    static const void *const dispatch[OP_COUNT] = {
+        [OP_HALT] = &&L_OP_HALT,
+        [OP_SET] = &&L_OP_SET,
+        [OP_LUT] = &&L_OP_LUT,
+        [OP_LOOP] = &&L_OP_LOOP,
+        [OP_NEXT] = &&L_OP_NEXT,
+    };
+    DISPATCH();
+#else
+    for (;;)
+    {
+        switch (*pc & 0xFF)
+        {
+#endif
+
+    TARGET(OP_SET)
+    {
+        v[pc[1]] = (uint8_t)(pc[0] >> 8);
+        pc += 2;
+        DISPATCH();
+    }
+
+    TARGET(OP_LUT)
+    {
+        uint32_t args = (pc[0] >> 8) & 0xFF, checks = pc[0] >> 16;
+        uint32_t out = pc[1];
+        const uint8_t *table = tables + pc[2];
+        const uint32_t *slots = pc + 3;
+        pc = slots + checks + args;
+
+        uint32_t ready = 1, row = 0;
+        for (uint32_t i = 0; i < checks; ++i)
+            ready &= v[slots[i]] != BYTECODE_UNSET;
+        for (uint32_t j = 0; j < args; ++j)
+        {
+            uint8_t bit = v[slots[checks + j]];
+            ready &= bit <= 1;
+            row = row << 1 | (bit & 1);
+        }
+
+        if (ready)
+        {
+            uint8_t result = table[row];
+            if (result != BYTECODE_NO_CASE && v[out] != result)
+            {
+                v[out] = result;
+                changed = 1;
+            }
+        }
+        DISPATCH();
+    }
+
+    TARGET(OP_LOOP)
+    {
+        changed = 0;
+        round = 0;
+        pc += 1;
+        DISPATCH();
+    }
+
+    TARGET(OP_NEXT)
+    {
+        if (changed && ++round < (pc[0] >> 8))
+        {
+            changed = 0;
+            pc = code + pc[1];
+        }
+        else
+        {
+            pc += 2;
+        }
+        DISPATCH();
+    }
+
+    TARGET(OP_HALT)
+        return;
+
+#if !BYTECODE_THREADED
+        default:
+            return;
+        }
+    }
+#endif
+}
+
+#if BYTECODE_THREADED
+#pragma GCC diagnostic pop
+#endif
+
+int bytecode_eval(Bytecode *program, SignalMap *signal_map)
+{
+    if (!program || !signal_map || signal_map->count < program->signal_count)
+        return -1;
+
+    // Tables only know 0 and 1; a wide value needs the string matcher
+    for (size_t id = 0; id < program->signal_count; ++id)
+        if (signal_map->bits[id] == SIGNAL_BIT_WIDE)
+            return -1;
+
+    memcpy(program->values, signal_map->bits, program->signal_count);
+    run(program, program->values);
+    return publish_bit_changes(signal_map, program->values, program->published, program->signal_count);
+}
@@ -0,0 +1,40 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+#include "netlist.h"
+#include "schedule.h"
+#include "signal_map.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Portable middle tier between the interpreter and the native JIT. The
+// levelized schedule is compiled to a flat array of uint32_t instructions
+// over a contiguous byte-per-signal value array (0, 1 or SIGNAL_BIT_UNSET),
+// with every distinct truth table stored once in a shared pool. It is built
+// from the Netlist rows; evaluation touches neither those nor the Instances.
+//
+// Instructions (first word: opcode in the low 8 bits, operands above):
+//   SET   bit            | slot                          literal binding
+//   LUT   args, checks   | out | table | check slots... | arg slots...
+//   LOOP                                                 feedback loop start
+//   NEXT  rounds         | body pc                       repeat while changed
+//   HALT
+
+typedef struct Bytecode {
+    uint32_t *code;
+    size_t code_length;       // In words
+    uint8_t *tables;          // Truth-table pool: 0, 1 or BYTECODE_NO_CASE per row
+    size_t table_bytes;
+    size_t lut_count;
+    size_t signal_count;      // Slots the program was compiled for
+    uint8_t *published;       // By slot: 1 for instance outputs, 0 for literals
+    uint8_t *values;          // Working copy of the bit array
+} Bytecode;
+
+// NULL if some instance has no bitwise form (see truth_table.h)
+Bytecode *bytecode_compile(const Schedule *schedule, const Netlist *net, const SignalMap *signal_map);
+void bytecode_release(Bytecode *program);
+
+// One pass; publishes changed outputs. -1 if a wide value is present.
+int bytecode_eval(Bytecode *program, SignalMap *signal_map);
+
+#endif
@@ -11,11 +11,93 @@
 #include "wiring.h"
 #include "emit_sexpr.h"
 #include "signal_map.h"
+#include "intern.h"
+#include "netlist_image.h"
+#include "schedule.h"
+#include "netlist.h"
+#include "const_fold.h"
+#include "liveness.h"
 #include <libgen.h>
 #include <errno.h>
 #include <sys/stat.h> // for mkdir
 #include <string.h>   // for strlen
 
+// Reuse unchanged artifacts recorded in <out_dir>/.rccache (see build_cache.h)
+static int build_cache_enabled = 1;
+
+// Drop instances and signals nothing observable depends on (see liveness.h)
+static int trim_enabled = 1;
+
+void set_build_cache_enabled(int enabled)
+{
+  build_cache_enabled = enabled;
+}
+
+void set_trim_enabled(int enabled)
+{
+  trim_enabled = enabled;
+}
+
+// Everything the netlist image depends on: the cache format, the options
+// that change the netlist and every input file. -1 if an input cannot be read.
+static int compile_inputs_key(BuildCache *cache, const char *inv_dir, unsigned char out[BUILD_CACHE_KEY_SIZE])
+{
+  BuildCacheKey key;
+  if (build_cache_key_begin(&key) != 0)
+    return -1;
+  build_cache_key_add(&key, "netlist-image");
+  build_cache_key_add(&key, trim_enabled ? "trim" : "no-trim");
+  int rc = sexpr_inputs_key(cache, &key, inv_dir);
+  if (build_cache_key_finish(&key, out) != 0)
+    return -1;
+  return rc;
+}
+
+/**
+ * Incremental fast path: with the inputs unchanged, the image written by the
+ * last compile is the netlist this one would build. It is loaded into a
+ * scratch map, so a bad image leaves signal_map untouched for a full compile.
+ * Any changed input rebuilds the whole netlist (flattening crosses every
+ * definition); the build cache then still skips unchanged artifact writes.
+ */
+static int load_unchanged_netlist(Block *blk, SignalMap *signal_map, const char *image_path)
+{
+  SignalMap *loaded = create_signal_map();
+  NetlistImage *image = loaded ? netlist_image_load(image_path, blk, loaded) : NULL;
+  if (!image)
+  {
+    destroy_signal_map(loaded);
+    return -1;
+  }
+
+  // Take the loaded table, keep the caller's store
+  SignalMap empty = *signal_map;
+  *signal_map = *loaded;
+  signal_map->store = empty.store;
+  empty.store = NULL;
+  *loaded = empty;
+  destroy_signal_map(loaded);
+
+  blk->image = image;
+  return 0;
+}
+
+// The fast path writes nothing, so everything the last compile left must still
+// be there: each artifact in the manifest, and the unkeyed stage 4/5 files
+static int previous_outputs_present(const BuildCache *cache, const char *sexpr_stage4_dir,
+                                    const char *spirv_asm_stage5_dir)
+{
+  char path[512];
+  struct stat st;
+  snprintf(path, sizeof(path), "%s/%s", sexpr_stage4_dir, CONSTANTS_FILE);
+  if (stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+    return 0;
+  snprintf(path, sizeof(path), "%s/main.spvasm", spirv_asm_stage5_dir);
+  if (stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+    return 0;
+  return build_cache_outputs_present(cache);
+}
+
 void stage_path_buf(char *buf, size_t bufsize, int stage, const char *backend, const char *base)
 {
   snprintf(buf, bufsize, "%s/stage/%d/%s", base, stage, backend);
@@ -71,6 +153,38 @@ void compile_block(Block *blk,
 
   // === Compilation Pipeline ===
 
+  // Recompiling into the same Block starts from a fresh netlist arena
+  block_release(blk);
+  blk->arena = arena_create(0);
+  blk->cache = build_cache_enabled ? build_cache_open(out_dir) : NULL;
+
+  char image_path[512];
+  snprintf(image_path, sizeof(image_path), "%s/%s", out_dir, NETLIST_IMAGE_FILE);
+  unsigned char inputs_key[BUILD_CACHE_KEY_SIZE];
+  int have_inputs_key = blk->cache && compile_inputs_key(blk->cache, inv_dir, inputs_key) == 0;
+
+  int unchanged = have_inputs_key && signal_map->count == 0 && build_cache_fresh(blk->cache, image_path, inputs_key);
+  if (unchanged && !previous_outputs_present(blk->cache, sexpr_stage4_dir, spirv_asm_stage5_dir))
+  {
+    LOG_INFO("🔧 Inputs unchanged, but outputs of the last compile are missing; compiling from source");
+    unchanged = 0;
+  }
+  if (unchanged)
+  {
+    block_release(blk); // netlist_image_load brings its own arena
+    if (load_unchanged_netlist(blk, signal_map, image_path) == 0)
+    {
+      LOG_INFO("♻️ Inputs unchanged since %s was written; loaded it instead of recompiling", image_path);
+      blk->schedule = build_schedule(blk, signal_map);
+      blk->netlist = build_netlist(blk->schedule);
+      build_cache_close(blk->cache); // Manifest unchanged: every artifact it lists is still current
+      blk->cache = NULL;
+      return;
+    }
+    LOG_WARN("⚠️ Could not reuse %s; compiling from source", image_path);
+    blk->arena = arena_create(0);
+  }
+
   parse_block_from_sexpr(blk, inv_dir);        // Stage 1: Parse raw S-expr files (definitions + invocations)
   emit_all_definitions(blk, sexpr_stage1_dir); // Emit initial logic blocks
   emit_all_invocations(blk, sexpr_stage1_dir); // Emit initial invocations
@@ -83,15 +197,32 @@ void compile_block(Block *blk,
   // Stage 3: Unit construction — flatten all logic into self-contained Invocation|Definition instances
 
   unify_invocations(blk, signal_map); // Instantiate definition+invocation pairs as Instances
+  LOG_INFO("🧵 Intern pool: %zu strings, %zu bytes", intern_pool_count(), intern_pool_bytes());
+
+  // Boundary logic nobody reads is never emitted, scheduled or evaluated
+  LivenessReport liveness;
+  if (trim_enabled)
+    trim_unobserved(blk, signal_map, &liveness);
  
   for (Invocation *inv = blk->invocations; inv; inv = inv->next) {
     dump_literal_bindings(inv);
   }
 
-  emit_all_instances(blk, sexpr_stage3_dir);
+  emit_all_instances(blk, signal_map, sexpr_stage3_dir);
  
   publish_all_literal_bindings(blk, signal_map);
-  emit_all_instances(blk, sexpr_stage4_dir);
+
+  // Fold literal bindings through the truth tables; stage 4 is the optimized netlist
+  ConstFold fold;
+  if (fold_constants(blk, signal_map, &fold) == 0)
+    emit_constant_signals(fold.constants, fold.constant_count, signal_map, sexpr_stage4_dir);
+  const_fold_release(&fold);
+  emit_all_instances(blk, signal_map, sexpr_stage4_dir);
+  emit_spirv_instances(blk, spirv_stage4_dir);
+
+  // Static evaluation order: acyclic levels run once, feedback loops iterate
+  blk->schedule = build_schedule(blk, signal_map);
+  blk->netlist = build_netlist(blk->schedule);
 
   // Emit final S-expr per Unit
   //  emit_all_units_to_spirv(blk, spirv_stage4_dir);     // Emit SPIR-V per Unit
@@ -103,5 +234,13 @@ void compile_block(Block *blk,
   //  emit_spirv_units(blk, sexpr_stage4_dir, spirv_stage4_dir);
   emit_spirv_asm_file(spirv_stage4_dir, spirv_asm_stage5_dir);
 
-  dump_wiring(blk);
+  dump_wiring(blk, signal_map);
+
+  // Snapshot for --load, and for the next compile if the inputs stay the same
+  if (netlist_image_write(blk, signal_map, image_path) == 0 && have_inputs_key)
+    build_cache_record(blk->cache, image_path, inputs_key);
+
+  build_cache_save(blk->cache);
+  build_cache_close(blk->cache);
+  blk->cache = NULL;
 }
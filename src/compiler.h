@@ -3,4 +3,6 @@ void compile_block(Block *blk,
                    SignalMap* signal_map,
                    const char *inv_dir,
                    const char *out_dir);
+void set_build_cache_enabled(int enabled); // 0 = rewrite every artifact (--no-cache)
+void set_trim_enabled(int enabled);        // 0 = keep unobserved instances and signals (--no-trim)
                    
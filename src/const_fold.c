@@ -0,0 +1,499 @@
+#include "const_fold.h"
+#include "intern.h"
+#include "log.h"
+#include "truth_table.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Writers per signal saturate here: 0, 1 or "more than one"
+#define WRITERS_MANY 2
+
+// Case patterns are matched as one string of this size, as in eval.c
+#define FOLD_PATTERN_MAX 256
+
+// One specialized Definition per (Definition, arg code), shared like the original
+typedef struct Specialization {
+    const Definition *source;
+    const char *code;            // Interned: '0'/'1' per constant arg, 'x' per kept arg
+    Definition *result;
+    struct Specialization *next;
+} Specialization;
+
+// Literal-free copy of an Invocation, shared by its instances
+typedef struct StrippedInvocation {
+    const Invocation *source;
+    Invocation *result;
+    struct StrippedInvocation *next;
+} StrippedInvocation;
+
+typedef struct FoldState {
+    Block *blk;
+    SignalMap *signal_map;
+    uint8_t *writers;            // By SignalId
+    bool *constant;              // By SignalId
+    Specialization *specs;
+    StrippedInvocation *stripped;
+    ConstFold *fold;
+} FoldState;
+
+static bool id_valid(const FoldState *st, SignalId id)
+{
+    return id != SIGNAL_ID_NONE && id < st->signal_map->count;
+}
+
+static bool instance_complete(const Instance *inst)
+{
+    return inst && inst->definition && inst->invocation;
+}
+
+static const LiteralBinding *literal_at(const Instance *inst, size_t l)
+{
+    const LiteralBindingList *list = inst->invocation->literal_bindings;
+    return list && l < list->count ? &list->items[l] : NULL;
+}
+
+// The conditional invocation eval would run for this instance, or NULL if it never fires
+static const ConditionalInvocation *gate_logic(const Instance *inst)
+{
+    const ConditionalInvocation *ci = inst->definition->conditional_invocation;
+    if (!ci || !ci->pattern_args || ci->arg_count == 0 || !ci->output || inst->input_count == 0)
+        return NULL;
+    return ci;
+}
+
+static int single_bit(const char *value)
+{
+    if (value && (value[0] == '0' || value[0] == '1') && value[1] == '\0')
+        return value[0] - '0';
+    return -1;
+}
+
+static void count_writer(FoldState *st, SignalId id)
+{
+    if (id_valid(st, id) && st->writers[id] < WRITERS_MANY)
+        st->writers[id]++;
+}
+
+static int add_constant(FoldState *st, SignalId id)
+{
+    ConstFold *fold = st->fold;
+    SignalId *constants = realloc(fold->constants, sizeof(SignalId) * (fold->constant_count + 1));
+    if (!constants)
+        return -1;
+    fold->constants = constants;
+    fold->constants[fold->constant_count++] = id;
+    st->constant[id] = true;
+    return 0;
+}
+
+// Every literal this instance publishes is the only writer of its signal
+static bool literals_constant(const FoldState *st, const Instance *inst)
+{
+    for (size_t l = 0; l < inst->literal_count; ++l)
+    {
+        const LiteralBinding *b = literal_at(inst, l);
+        if (!b || !b->value || inst->literal_ids[l] == SIGNAL_ID_NONE)
+            continue; // eval skips these
+        if (!id_valid(st, inst->literal_ids[l]) || !st->constant[inst->literal_ids[l]])
+            return false;
+    }
+    return true;
+}
+
+static bool ids_constant(const FoldState *st, const SignalId *ids, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        if (!id_valid(st, ids[i]) || !st->constant[ids[i]])
+            return false;
+    return true;
+}
+
+// Case eval would pick with every template arg fixed (the string matcher; the table agrees on bits)
+static int constant_case(const FoldState *st, const Instance *inst, const ConditionalInvocation *ci)
+{
+    char pattern[FOLD_PATTERN_MAX] = {0};
+    for (size_t j = 0; j < inst->pattern_count; ++j)
+        strncat(pattern, signal_map_get(st->signal_map, inst->pattern_ids[j]), sizeof(pattern) - strlen(pattern) - 1);
+
+    for (size_t c = 0; c < ci->case_count; ++c)
+        if (strcmp(ci->cases[c].pattern, pattern) == 0)
+            return (int)c;
+    return -1;
+}
+
+/**
+ * Evaluate gates whose inputs are all constant, until nothing changes.
+ * Only a gate that is the sole writer of its output can be folded; with a
+ * second writer the value would depend on evaluation order.
+ */
+static int propagate(FoldState *st, Instance **insts, bool *dead, size_t n)
+{
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t i = 0; i < n; ++i)
+        {
+            Instance *inst = insts[i];
+            if (dead[i] || !instance_complete(inst) || !literals_constant(st, inst))
+                continue;
+
+            const ConditionalInvocation *ci = gate_logic(inst);
+            if (!ci || !id_valid(st, inst->output_id) || st->writers[inst->output_id] != 1)
+                continue;
+            if (!ids_constant(st, inst->input_ids, inst->input_count) ||
+                !ids_constant(st, inst->pattern_ids, inst->pattern_count))
+                continue;
+
+            int c = constant_case(st, inst, ci);
+            if (c >= 0)
+            {
+                signal_map_set(st->signal_map, inst->output_id, ci->cases[c].result);
+                if (add_constant(st, inst->output_id) != 0)
+                    return -1;
+                LOG_INFO("📌 Folded %s: %s = %s", inst->name,
+                         signal_map_name(st->signal_map, inst->output_id), ci->cases[c].result);
+            }
+            else
+            {
+                LOG_INFO("📌 Folded %s: no case matches its constant inputs", inst->name);
+            }
+
+            // Either way it can never write anything else
+            dead[i] = true;
+            st->fold->folded++;
+            changed = true;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Fill code[] with '0'/'1' for template args that are constant bits and 'x'
+ * for the rest. False unless some args are constant, some are not, and every
+ * Case pattern has one character per arg.
+ */
+static bool arg_code(const FoldState *st, const Instance *inst, const ConditionalInvocation *ci, char *code)
+{
+    if (inst->pattern_count != ci->arg_count || ci->arg_count >= FOLD_PATTERN_MAX)
+        return false;
+    for (size_t c = 0; c < ci->case_count; ++c)
+        if (!ci->cases[c].pattern || strlen(ci->cases[c].pattern) != ci->arg_count)
+            return false;
+
+    bool any_constant = false, any_kept = false;
+    for (size_t j = 0; j < ci->arg_count; ++j)
+    {
+        SignalId id = inst->pattern_ids[j];
+        int bit = id_valid(st, id) && st->constant[id] ? single_bit(signal_map_get(st->signal_map, id)) : -1;
+        code[j] = bit < 0 ? 'x' : (char)('0' + bit);
+        any_constant |= bit >= 0;
+        any_kept |= bit < 0;
+    }
+    code[ci->arg_count] = '\0';
+    return any_constant && any_kept;
+}
+
+/**
+ * The Definition with the constant args of `code` removed from its Template
+ * and the Cases that contradict them dropped. Inputs are unchanged, so the
+ * instance keeps its port positions.
+ */
+static Definition *specialize_definition(FoldState *st, const Definition *def, const char *code)
+{
+    const char *key = intern(code);
+    for (Specialization *s = st->specs; s; s = s->next)
+        if (s->source == def && s->code == key)
+            return s->result;
+
+    Arena *arena = st->blk->arena;
+    const ConditionalInvocation *ci = def->conditional_invocation;
+    ConditionalInvocation *sci = arena_calloc(arena, 1, sizeof(ConditionalInvocation));
+    Definition *sdef = arena_calloc(arena, 1, sizeof(Definition));
+    Specialization *spec = malloc(sizeof(Specialization));
+    if (!sci || !sdef || !spec)
+    {
+        free(spec);
+        return NULL;
+    }
+
+    sci->pattern_args = create_string_list_in(arena);
+    sci->cases = arena_alloc(arena, sizeof(ConditionalCase) * (ci->case_count ? ci->case_count : 1));
+    if (!sci->pattern_args || !sci->cases)
+    {
+        free(spec);
+        return NULL;
+    }
+    for (size_t j = 0; j < ci->arg_count; ++j)
+        if (code[j] == 'x')
+            string_list_add(sci->pattern_args, string_list_get(ci->pattern_args, j));
+    sci->arg_count = string_list_count(sci->pattern_args);
+    sci->output = ci->output;
+
+    for (size_t c = 0; c < ci->case_count; ++c)
+    {
+        char reduced[FOLD_PATTERN_MAX];
+        size_t len = 0;
+        bool matches = true;
+        for (size_t j = 0; j < ci->arg_count && matches; ++j)
+        {
+            if (code[j] == 'x')
+                reduced[len++] = ci->cases[c].pattern[j];
+            else
+                matches = ci->cases[c].pattern[j] == code[j];
+        }
+        if (!matches)
+            continue;
+        reduced[len] = '\0';
+
+        // First match wins at eval time, so later duplicates are unreachable
+        const char *pattern = intern(reduced);
+        bool duplicate = false;
+        for (size_t k = 0; k < sci->case_count && !duplicate; ++k)
+            duplicate = sci->cases[k].pattern == pattern;
+        if (!duplicate)
+            sci->cases[sci->case_count++] = (ConditionalCase){pattern, ci->cases[c].result};
+    }
+    sci->truth_table = compile_truth_table(sci, arena);
+
+    char name[256];
+    snprintf(name, sizeof(name), "%s_%s", def->name, code);
+    sdef->name = intern(name);
+    sdef->origin_sexpr_path = def->origin_sexpr_path;
+    sdef->input_signals = def->input_signals;
+    sdef->output_signals = def->output_signals;
+    sdef->body = def->body;
+    sdef->conditional_invocation = sci;
+
+    *spec = (Specialization){def, key, sdef, st->specs};
+    st->specs = spec;
+    LOG_INFO("✂️ Specialized %s → %s (%zu → %zu case(s))", def->name, sdef->name, ci->case_count, sci->case_count);
+    return sdef;
+}
+
+static Invocation *strip_literals(FoldState *st, const Invocation *inv)
+{
+    for (StrippedInvocation *s = st->stripped; s; s = s->next)
+        if (s->source == inv)
+            return s->result;
+
+    Invocation *sinv = arena_alloc(st->blk->arena, sizeof(Invocation));
+    StrippedInvocation *entry = malloc(sizeof(StrippedInvocation));
+    if (!sinv || !entry)
+    {
+        free(entry);
+        return NULL;
+    }
+    *sinv = *inv;
+    sinv->literal_bindings = NULL;
+    sinv->next = NULL;
+
+    *entry = (StrippedInvocation){inv, sinv, st->stripped};
+    st->stripped = entry;
+    return sinv;
+}
+
+// Same name and ports on a new Definition / Invocation; literals and constant args dropped
+static Instance *rebuild_instance(FoldState *st, const Instance *inst, const Definition *def,
+                                  const Invocation *inv, const char *code)
+{
+    Arena *arena = st->blk->arena;
+    Instance *out = arena_calloc(arena, 1, sizeof(Instance));
+    if (!out)
+        return NULL;
+
+    out->name = inst->name;
+    out->definition = def;
+    out->invocation = inv;
+    out->output_id = inst->output_id;
+    out->input_count = inst->input_count;
+    out->output_count = inst->output_count;
+    out->literal_count = inv->literal_bindings ? inv->literal_bindings->count : 0;
+    out->def_input_count = inst->def_input_count;
+    out->def_output_count = inst->def_output_count;
+    out->pattern_count = def->conditional_invocation ? def->conditional_invocation->arg_count : 0;
+    out->port_count = out->input_count + out->output_count + out->literal_count +
+                      out->def_input_count + out->def_output_count + out->pattern_count;
+    out->ports = arena_alloc(arena, sizeof(SignalId) * (out->port_count ? out->port_count : 1));
+    if (!out->ports)
+        return NULL;
+
+    SignalId *cursor = out->ports;
+    out->input_ids = cursor;
+    memcpy(cursor, inst->input_ids, sizeof(SignalId) * inst->input_count);
+    cursor += out->input_count;
+    out->output_ids = cursor;
+    memcpy(cursor, inst->output_ids, sizeof(SignalId) * inst->output_count);
+    cursor += out->output_count;
+    out->literal_ids = cursor;
+    if (out->literal_count)
+        memcpy(cursor, inst->literal_ids, sizeof(SignalId) * out->literal_count);
+    cursor += out->literal_count;
+    out->def_input_ids = cursor;
+    memcpy(cursor, inst->def_input_ids, sizeof(SignalId) * inst->def_input_count);
+    cursor += out->def_input_count;
+    out->def_output_ids = cursor;
+    memcpy(cursor, inst->def_output_ids, sizeof(SignalId) * inst->def_output_count);
+    cursor += out->def_output_count;
+    out->pattern_ids = cursor;
+    for (size_t j = 0; j < inst->pattern_count; ++j)
+        if (!code || code[j] == 'x')
+            *cursor++ = inst->pattern_ids[j];
+
+    return out;
+}
+
+/**
+ * Decide what is left of a live instance. NULL with *keep false drops it
+ * (it only published constant literals); otherwise the instance to keep.
+ */
+static Instance *reduce_instance(FoldState *st, Instance *inst, bool *keep, int *status)
+{
+    *keep = true;
+    if (!instance_complete(inst) || !literals_constant(st, inst))
+        return inst;
+
+    const ConditionalInvocation *ci = gate_logic(inst);
+    if (!ci)
+    {
+        *keep = false;
+        return NULL;
+    }
+
+    char code[FOLD_PATTERN_MAX];
+    bool specialize = arg_code(st, inst, ci, code);
+    if (!specialize && inst->literal_count == 0)
+        return inst;
+
+    const Definition *def = specialize ? specialize_definition(st, inst->definition, code) : inst->definition;
+    const Invocation *inv = inst->literal_count ? strip_literals(st, inst->invocation) : inst->invocation;
+    Instance *out = def && inv ? rebuild_instance(st, inst, def, inv, specialize ? code : NULL) : NULL;
+    if (!out)
+    {
+        *status = -1;
+        return inst;
+    }
+
+    st->fold->specialized += specialize;
+    st->fold->stripped += inst->literal_count > 0;
+    return out;
+}
+
+int fold_constants(Block *blk, SignalMap *signal_map, ConstFold *fold)
+{
+    if (!blk || !signal_map || !fold)
+        return -1;
+    memset(fold, 0, sizeof(*fold));
+
+    size_t n = 0;
+    for (InstanceList *node = blk->instances; node; node = node->next)
+        n++;
+
+    size_t signal_count = signal_map->count;
+    FoldState st = {blk, signal_map, NULL, NULL, NULL, NULL, fold};
+    st.writers = calloc(signal_count ? signal_count : 1, sizeof(uint8_t));
+    st.constant = calloc(signal_count ? signal_count : 1, sizeof(bool));
+    Instance **insts = malloc(sizeof(Instance *) * (n ? n : 1));
+    bool *dead = calloc(n ? n : 1, sizeof(bool));
+    int status = 0;
+    if (!st.writers || !st.constant || !insts || !dead)
+    {
+        status = -1;
+        goto done;
+    }
+
+    size_t i = 0;
+    for (InstanceList *node = blk->instances; node; node = node->next)
+        insts[i++] = node->instance;
+
+    // Who writes what: every usable literal, and the output of every gate that can fire
+    for (i = 0; i < n; ++i)
+    {
+        const Instance *inst = insts[i];
+        if (!instance_complete(inst))
+            continue;
+        for (size_t l = 0; l < inst->literal_count; ++l)
+        {
+            const LiteralBinding *b = literal_at(inst, l);
+            if (b && b->value)
+                count_writer(&st, inst->literal_ids[l]);
+        }
+        if (gate_logic(inst))
+            count_writer(&st, inst->output_id);
+    }
+
+    // Sole-writer literals are constant; publish_all_literal_bindings already stored their values
+    for (i = 0; i < n && status == 0; ++i)
+    {
+        const Instance *inst = insts[i];
+        if (!instance_complete(inst))
+            continue;
+        for (size_t l = 0; l < inst->literal_count && status == 0; ++l)
+        {
+            SignalId id = inst->literal_ids[l];
+            const LiteralBinding *b = literal_at(inst, l);
+            if (b && b->value && id_valid(&st, id) && st.writers[id] == 1 && !st.constant[id])
+                status = add_constant(&st, id);
+        }
+    }
+
+    if (status == 0)
+        status = propagate(&st, insts, dead, n);
+
+    // Rebuild the instance list in place, reusing its nodes
+    InstanceList **link = &blk->instances, *tail = NULL;
+    i = 0;
+    for (InstanceList *node = blk->instances; node; node = node->next, ++i)
+    {
+        bool keep = !dead[i];
+        Instance *inst = keep && status == 0 ? reduce_instance(&st, node->instance, &keep, &status) : node->instance;
+        if (!keep)
+        {
+            fold->removed++;
+            continue;
+        }
+        node->instance = inst;
+        *link = node;
+        link = &node->next;
+        tail = node;
+    }
+    *link = NULL;
+    blk->instances_tail = tail;
+
+    if (status == 0)
+        LOG_INFO("📌 Constant folding: %zu constant signal(s), %zu gate(s) folded, %zu specialized, "
+                 "%zu no longer republishing literals, %zu of %zu instance(s) removed",
+                 fold->constant_count, fold->folded, fold->specialized, fold->stripped, fold->removed, n);
+    else
+        LOG_ERROR("❌ Constant folding ran out of memory; the netlist is partly optimized");
+
+done:
+    while (st.specs)
+    {
+        Specialization *next = st.specs->next;
+        free(st.specs);
+        st.specs = next;
+    }
+    while (st.stripped)
+    {
+        StrippedInvocation *next = st.stripped->next;
+        free(st.stripped);
+        st.stripped = next;
+    }
+    free(st.writers);
+    free(st.constant);
+    free(insts);
+    free(dead);
+    return status;
+}
+
+void const_fold_release(ConstFold *fold)
+{
+    if (!fold)
+        return;
+    free(fold->constants);
+    fold->constants = NULL;
+    fold->constant_count = 0;
+}
@@ -0,0 +1,27 @@
+#ifndef CONST_FOLD_H
+#define CONST_FOLD_H
+#include "block.h"
+#include "signal_map.h"
+#include <stddef.h>
+
+// Compile-time constant propagation over the Block's instances, run after
+// publish_all_literal_bindings. A signal is constant when its only writer is
+// a literal binding, or a gate whose inputs are all constant. Such gates are
+// evaluated once here, their output stored in the signal map, and removed.
+// Gates with some constant template args move to a Definition specialized
+// to the remaining args (e.g. XOR_1x), and literal bindings that are
+// constant are no longer republished by eval.
+
+typedef struct ConstFold {
+    SignalId *constants;   // Sole-writer literals, then folded gate outputs
+    size_t constant_count;
+    size_t folded;         // Gates evaluated at compile time
+    size_t specialized;    // Gates moved to a smaller Definition
+    size_t stripped;       // Instances that no longer republish their literals
+    size_t removed;        // Instances dropped from the Block (folded, or only publishing literals)
+} ConstFold;
+
+int fold_constants(Block *blk, SignalMap *signal_map, ConstFold *fold); // 0 on success; logs a summary
+void const_fold_release(ConstFold *fold);
+
+#endif
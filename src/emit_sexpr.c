@@ -4,10 +4,77 @@
 #include "instance.h"
 #include "eval.h"
 #include "log.h"
+#include "build_cache.h"
 #include <stdio.h>
 #include <errno.h>
 
-void emit_instance(Instance *instance, const char *out_dir)
+/*
+ * Instances share their Definition and Invocation, so the qualified names
+ * live in the instance's port vector. A PortNames view points the emitters
+ * at that vector; a NULL view emits the template names as parsed.
+ */
+typedef struct PortNames {
+    const Instance *instance;
+    SignalMap *signal_map;
+} PortNames;
+
+static const char *port_name(const PortNames *ports, const SignalId *ids, const StringList *names, size_t i)
+{
+    if (ports)
+        return signal_map_name(ports->signal_map, ids[i]);
+    return string_list_get(names, i);
+}
+
+static void emit_invocation_with(FILE *out, const Invocation *inv, const PortNames *ports, int indent);
+static void emit_definition_with(FILE *out, const Definition *def, const PortNames *ports, int indent);
+
+static int add_invocation_to_key(BuildCache *cache, BuildCacheKey *key, const Invocation *inv)
+{
+    if (inv->origin_sexpr_path)
+        return build_cache_key_add_source(cache, key, inv->origin_sexpr_path);
+
+    // Invocations from a definition body have no file of their own; key on
+    // the parts of them that get emitted (port names are added separately)
+    build_cache_key_add(key, inv->target_name);
+    size_t count = inv->literal_bindings ? inv->literal_bindings->count : 0;
+    for (size_t i = 0; i < count; ++i)
+        build_cache_key_add(key, inv->literal_bindings->items[i].value);
+    return 0;
+}
+
+// Stage 3/4 output depends on both sources and on the qualified port names
+static int instance_cache_key(BuildCache *cache, const Instance *instance, SignalMap *signal_map,
+                              unsigned char out[BUILD_CACHE_KEY_SIZE])
+{
+    if (!cache)
+        return -1;
+
+    BuildCacheKey key;
+    if (build_cache_key_begin(&key) != 0)
+        return -1;
+
+    int status = 0;
+    if (build_cache_key_add_source(cache, &key, instance->definition->origin_sexpr_path) != 0 ||
+        add_invocation_to_key(cache, &key, instance->invocation) != 0)
+        status = -1;
+
+    build_cache_key_add(&key, instance->name);
+    build_cache_key_add(&key, instance->definition->name); // Specialized by constant folding, e.g. AND_1x
+    for (size_t i = 0; i < instance->port_count; ++i)
+        build_cache_key_add(&key, signal_map_name(signal_map, instance->ports[i]));
+    build_cache_key_add(&key, signal_map_name(signal_map, instance->output_id));
+
+    if (build_cache_key_finish(&key, out) != 0)
+        return -1;
+    return status;
+}
+
+void emit_instance(Instance *instance, SignalMap *signal_map, const char *out_dir)
+{
+    emit_instance_cached(NULL, instance, signal_map, out_dir);
+}
+
+void emit_instance_cached(BuildCache *cache, Instance *instance, SignalMap *signal_map, const char *out_dir)
 {
     if (!instance || !instance->name || !instance->invocation || !instance->definition)
     {
@@ -17,6 +84,15 @@ void emit_instance(Instance *instance, const char *out_dir)
 
     char path[512];
     snprintf(path, sizeof(path), "%s/%s.sexp", out_dir, instance->name);
+
+    unsigned char key[BUILD_CACHE_KEY_SIZE];
+    int cacheable = instance_cache_key(cache, instance, signal_map, key) == 0;
+    if (cacheable && build_cache_fresh(cache, path, key))
+    {
+        LOG_INFO("♻️  Instance %s unchanged: %s", instance->name, path);
+        return;
+    }
+
     FILE *f = fopen(path, "w");
     if (!f)
     {
@@ -27,19 +103,23 @@ void emit_instance(Instance *instance, const char *out_dir)
     fprintf(f, "(Instance\n");
     fprintf(f, "  (Name %s)\n", instance->name);
 
+    PortNames ports = {instance, signal_map};
+
     // 🔁 Use the shared helper — preserves parsed-from and roles
-    emit_invocation(f, instance->invocation, 2);
+    emit_invocation_with(f, instance->invocation, &ports, 2);
 
     // Emit Definition
-    emit_definition(f, instance->definition, 2);
+    emit_definition_with(f, instance->definition, &ports, 2);
 
     fprintf(f, ")\n");
     fclose(f);
+    if (cacheable)
+        build_cache_record(cache, path, key);
 
     LOG_INFO("📤 Emitted instance to %s", path);
 }
 
-void emit_all_instances(Block *blk, const char *dir)
+void emit_all_instances(Block *blk, SignalMap *signal_map, const char *dir)
 {
     LOG_INFO("🌀 Emitting all Instances to s-expr: %s", dir);
 
@@ -52,13 +132,44 @@ void emit_all_instances(Block *blk, const char *dir)
             continue;
         }
 
-        emit_instance(instance, dir);
+        emit_instance_cached(blk->cache, instance, signal_map, dir);
     }
 
     LOG_INFO("✅ Done emitting all Instances.");
 }
 
-void emit_input_signals(FILE *out, StringList *inputs, int indent, const char *role_hint)
+void emit_constant_signals(const SignalId *ids, size_t count, SignalMap *signal_map, const char *dir)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, CONSTANTS_FILE);
+
+    FILE *f = fopen(path, "w");
+    if (!f)
+    {
+        LOG_ERROR("❌ Failed to open file for writing: %s", path);
+        return;
+    }
+
+    fprintf(f, ";; Signals fixed at compile time (see const_fold.h)\n");
+    fprintf(f, "(Constants\n");
+    for (size_t i = 0; i < count; ++i)
+    {
+        const char *value = signal_map_get(signal_map, ids[i]);
+        if (!value)
+            continue;
+        fputs("  (Signal ", f);
+        emit_atom(f, signal_map_name(signal_map, ids[i]));
+        fputc(' ', f);
+        emit_atom(f, value);
+        fputs(")\n", f);
+    }
+    fprintf(f, ")\n");
+    fclose(f);
+
+    LOG_INFO("📤 Emitted %zu constant signal(s) to %s", count, path);
+}
+
+static void emit_input_signals_with(FILE *out, const StringList *inputs, const PortNames *ports, int indent, const char *role_hint)
 {
     if (!inputs || string_list_count(inputs) == 0)
         return;
@@ -68,7 +179,7 @@ void emit_input_signals(FILE *out, StringList *inputs, int indent, const char *r
 
     for (size_t i = 0; i < string_list_count(inputs); ++i)
     {
-        const char *signal = string_list_get_by_index(inputs, i);
+        const char *signal = port_name(ports, ports ? ports->instance->def_input_ids : NULL, inputs, i);
         if (!signal)
             continue;
 
@@ -87,7 +198,7 @@ void emit_input_signals(FILE *out, StringList *inputs, int indent, const char *r
     fputs(")\n", out);
 }
 
-void emit_output_signals(FILE *out, StringList *outputs, int indent, const char *role_hint)
+static void emit_output_signals_with(FILE *out, const StringList *outputs, const PortNames *ports, int indent, const char *role_hint)
 {
     if (!outputs || string_list_count(outputs) == 0)
         return;
@@ -97,7 +208,7 @@ void emit_output_signals(FILE *out, StringList *outputs, int indent, const char
 
     for (size_t i = 0; i < string_list_count(outputs); ++i)
     {
-        const char *signal = string_list_get_by_index(outputs, i);
+        const char *signal = port_name(ports, ports ? ports->instance->def_output_ids : NULL, outputs, i);
         if (!signal)
             continue;
 
@@ -116,6 +227,16 @@ void emit_output_signals(FILE *out, StringList *outputs, int indent, const char
     fputs(")\n", out);
 }
 
+void emit_input_signals(FILE *out, StringList *inputs, int indent, const char *role_hint)
+{
+    emit_input_signals_with(out, inputs, NULL, indent, role_hint);
+}
+
+void emit_output_signals(FILE *out, StringList *outputs, int indent, const char *role_hint)
+{
+    emit_output_signals_with(out, outputs, NULL, indent, role_hint);
+}
+
 void emit_place_of_resolution(FILE *out, Definition *def, int indent)
 {
     if (!def || !def->body)
@@ -157,7 +278,7 @@ void emit_place_of_resolution(FILE *out, Definition *def, int indent)
     fputs(")\n", out);
 }
 
-void emit_invocation(FILE *out, Invocation *inv, int indent)
+static void emit_invocation_with(FILE *out, const Invocation *inv, const PortNames *ports, int indent)
 {
     if (!inv)
         return;
@@ -177,15 +298,16 @@ void emit_invocation(FILE *out, Invocation *inv, int indent)
     {
         for (size_t i = 0; i < inv->literal_bindings->count; ++i)
         {
-            LiteralBinding *binding = &inv->literal_bindings->items[i];
-            if (!binding->name || !binding->value)
+            const LiteralBinding *binding = &inv->literal_bindings->items[i];
+            const char *name = ports ? signal_map_name(ports->signal_map, ports->instance->literal_ids[i]) : binding->name;
+            if (!name || !binding->value)
                 continue;
 
-            LOG_INFO("🖨️  Emitting bind(%s = %s)", binding->name, binding->value);
+            LOG_INFO("🖨️  Emitting bind(%s = %s)", name, binding->value);
 
             emit_indent(out, indent + 2);
             fputs("(bind (", out);
-            emit_atom(out, binding->name);
+            emit_atom(out, name);
             fputc(' ', out);
             emit_atom(out, binding->value);
             fputs("))\n", out);
@@ -199,7 +321,7 @@ void emit_invocation(FILE *out, Invocation *inv, int indent)
     fputs("(Inputs", out);
     for (size_t i = 0; i < string_list_count(inv->input_signals); ++i)
     {
-        const char *sig = string_list_get_by_index(inv->input_signals, i);
+        const char *sig = port_name(ports, ports ? ports->instance->input_ids : NULL, inv->input_signals, i);
         fputc(' ', out);
         emit_atom(out, sig);
     }
@@ -212,7 +334,7 @@ void emit_invocation(FILE *out, Invocation *inv, int indent)
     fputs("(Outputs", out);
     for (size_t i = 0; i < string_list_count(inv->output_signals); ++i)
     {
-        const char *sig = string_list_get_by_index(inv->output_signals, i);
+        const char *sig = port_name(ports, ports ? ports->instance->output_ids : NULL, inv->output_signals, i);
         fputc(' ', out);
         emit_atom(out, sig);
     }
@@ -222,7 +344,12 @@ void emit_invocation(FILE *out, Invocation *inv, int indent)
     fputs(")\n", out);
 }
 
-void emit_conditional(FILE *out, ConditionalInvocation *ci, int indent)
+void emit_invocation(FILE *out, Invocation *inv, int indent)
+{
+    emit_invocation_with(out, inv, NULL, indent);
+}
+
+static void emit_conditional_with(FILE *out, const ConditionalInvocation *ci, const PortNames *ports, int indent)
 {
     if (!ci)
         return;
@@ -243,7 +370,11 @@ void emit_conditional(FILE *out, ConditionalInvocation *ci, int indent)
 
     for (size_t i = 0; i < ci->arg_count; ++i)
     {
-        const char *arg = string_list_get_by_index(ci->pattern_args, i);
+        const char *arg = NULL;
+        if (ports)
+            arg = i < ports->instance->pattern_count ? signal_map_name(ports->signal_map, ports->instance->pattern_ids[i]) : NULL;
+        else
+            arg = string_list_get(ci->pattern_args, i);
         if (arg)
         {
             fprintf(out, " %s", arg);
@@ -259,7 +390,7 @@ void emit_conditional(FILE *out, ConditionalInvocation *ci, int indent)
     // Emit Cases
     for (size_t i = 0; i < ci->case_count; ++i)
     {
-        ConditionalCase *c = &ci->cases[i];
+        const ConditionalCase *c = &ci->cases[i];
         if (!c->pattern || !c->result)
             continue;
 
@@ -271,7 +402,12 @@ void emit_conditional(FILE *out, ConditionalInvocation *ci, int indent)
     fputs(") ;; conditional invocation\n", out);
 }
 
-void emit_definition(FILE *out, Definition *def, int indent)
+void emit_conditional(FILE *out, ConditionalInvocation *ci, int indent)
+{
+    emit_conditional_with(out, ci, NULL, indent);
+}
+
+static void emit_definition_with(FILE *out, const Definition *def, const PortNames *ports, int indent)
 {
     if (!def || !def->name)
         return;
@@ -291,12 +427,12 @@ void emit_definition(FILE *out, Definition *def, int indent)
     // Inputs
     emit_indent(out, indent + 2);
     fputs(";; Inputs (from invocation → used inside definition)\n", out);
-    emit_input_signals(out, def->input_signals, indent + 2, "input");
+    emit_input_signals_with(out, def->input_signals, ports, indent + 2, "input");
 
     // Outputs
     emit_indent(out, indent + 2);
     fputs(";; Outputs (from definition → back to invocation)\n", out);
-    emit_output_signals(out, def->output_signals, indent + 2, "output");
+    emit_output_signals_with(out, def->output_signals, ports, indent + 2, "output");
 
     // Body
     emit_indent(out, indent);
@@ -328,12 +464,17 @@ void emit_definition(FILE *out, Definition *def, int indent)
     }
 
     emit_indent(out, indent + 2);
-    emit_conditional(out, def->conditional_invocation, indent);
+    emit_conditional_with(out, def->conditional_invocation, ports, indent);
     fputs(") ;; body\n", out); // End Body
     emit_indent(out, indent);
     fputs(") ;; definition\n", out); // End Definition
 }
 
+void emit_definition(FILE *out, Definition *def, int indent)
+{
+    emit_definition_with(out, def, NULL, indent);
+}
+
 void emit_all_definitions(Block *blk, const char *dirpath)
 {
     // Create the output directory if it doesn't exist
@@ -354,6 +495,14 @@ void emit_all_definitions(Block *blk, const char *dirpath)
         char path[256];
         snprintf(path, sizeof(path), "%s/%s.def.sexpr", dirpath, def->name);
 
+        unsigned char key[BUILD_CACHE_KEY_SIZE];
+        int cacheable = build_cache_source_key(blk->cache, def->origin_sexpr_path, key) == 0;
+        if (cacheable && build_cache_fresh(blk->cache, path, key))
+        {
+            LOG_INFO("♻️  Definition '%s' unchanged: %s", def->name, path);
+            continue;
+        }
+
         FILE *out = fopen(path, "w");
         if (!out)
         {
@@ -364,6 +513,8 @@ void emit_all_definitions(Block *blk, const char *dirpath)
         LOG_INFO("📦 Emitting definition: %s", def->name);
         emit_definition(out, def, 0);
         fclose(out);
+        if (cacheable)
+            build_cache_record(blk->cache, path, key);
 
         LOG_INFO("✅ Wrote definition '%s' to %s", def->name, path);
     }
@@ -382,6 +533,15 @@ void emit_all_invocations(Block *blk, const char *dirpath)
     {
         char path[256];
         snprintf(path, sizeof(path), "%s/%s.inv.sexpr", dirpath, inv->target_name);
+
+        unsigned char key[BUILD_CACHE_KEY_SIZE];
+        int cacheable = build_cache_source_key(blk->cache, inv->origin_sexpr_path, key) == 0;
+        if (cacheable && build_cache_fresh(blk->cache, path, key))
+        {
+            LOG_INFO("♻️  Invocation '%s' unchanged: %s", inv->target_name, path);
+            continue;
+        }
+
         FILE *out = fopen(path, "w");
         if (!out)
         {
@@ -392,6 +552,8 @@ void emit_all_invocations(Block *blk, const char *dirpath)
         // Emit the invocation
         emit_invocation(out, inv, 0);
         fclose(out);
+        if (cacheable)
+            build_cache_record(blk->cache, path, key);
         LOG_INFO("✅ Wrote invocation '%s' to %s", inv->target_name, path);
     }
 }
@@ -2,8 +2,13 @@
 #define EMIT_SEXPR_H
 #include "eval.h"
 #include "stdio.h"
-void emit_instance(Instance *instance, const char *out_dir);
-void emit_all_instances(Block *blk, const char *dir);
+#include "build_cache.h"
+void emit_instance(Instance *instance, SignalMap *signal_map, const char *out_dir);
+void emit_instance_cached(BuildCache *cache, Instance *instance, SignalMap *signal_map, const char *out_dir); // Skips unchanged files
+void emit_all_instances(Block *blk, SignalMap *signal_map, const char *dir);
+
+#define CONSTANTS_FILE "Constants.sexp"
+void emit_constant_signals(const SignalId *ids, size_t count, SignalMap *signal_map, const char *dir); // <dir>/CONSTANTS_FILE
 void emit_invocation(FILE *out, Invocation *inv, int indent);
 void emit_definition(FILE *out, Definition *def, int indent);
 void emit_output_signals(FILE *out, StringList *outputs, int indent, const char *role_hint);
@@ -227,7 +227,7 @@ void emit_conditional_invocation(SPIRVModule *mod, ConditionalInvocation *ci)
   // ─── 2. Input Variables and Loads ────────────────────────────────────
   for (size_t i = 0; i < ci->arg_count; ++i)
   {
-    const char *arg_name = string_list_get_by_index(ci->pattern_args, i);
+    const char *arg_name = string_list_get(ci->pattern_args, i);
     if (!arg_name)
     {
       LOG_WARN("⚠️ Missing pattern arg[%zu] during input loading", i);
@@ -236,7 +236,7 @@ void emit_conditional_invocation(SPIRVModule *mod, ConditionalInvocation *ci)
 
     for (size_t j = 0; j < string_list_count(inv->input_signals); ++j)
     {
-      const char *resolved = string_list_get_by_index(inv->input_signals, j);
+      const char *resolved = string_list_get(inv->input_signals, j);
       if (resolved && strstr(resolved, arg_name))
       {
         char tmp[128];
@@ -253,7 +253,7 @@ void emit_conditional_invocation(SPIRVModule *mod, ConditionalInvocation *ci)
 
   for (size_t i = 0; i < string_list_count(inv->output_signals); ++i)
   {
-    const char *sig = string_list_get_by_index(inv->output_signals, i);
+    const char *sig = string_list_get(inv->output_signals, i);
     if (sig)
     {
       LOG_INFO("🔁 Registering output signal: %s => %%out_var", sig);
@@ -280,13 +280,13 @@ void emit_conditional_invocation(SPIRVModule *mod, ConditionalInvocation *ci)
       char input_var[128];
       snprintf(input_var, sizeof(input_var), "%%fallback");
 
-      const char *arg_name = string_list_get_by_index(ci->pattern_args, i);
+      const char *arg_name = string_list_get(ci->pattern_args, i);
       if (!arg_name)
         continue;
 
       for (size_t j = 0; j < string_list_count(inv->input_signals); ++j)
       {
-        const char *candidate = string_list_get_by_index(inv->input_signals, j);
+        const char *candidate = string_list_get(inv->input_signals, j);
         if (candidate && strstr(candidate, arg_name))
         {
           snprintf(input_var, sizeof(input_var), "%%%s", candidate);
@@ -338,67 +338,118 @@ void emit_conditional_invocation(SPIRVModule *mod, ConditionalInvocation *ci)
   emit_op(mod, "OpFunctionEnd", NULL, 0);
 }
 
-void spirv_parse_block(Block *blk, const char *spirv_out_dir)
+static void emit_spirv_definition(Block *blk, Definition *def, const char *spirv_out_dir)
 {
-  for (Definition *def = blk->definitions; def != NULL; def = def->next)
+  // Register signals from conditional invocation
+  if (def->conditional_invocation)
   {
-    // Register signals from conditional invocation
-    if (def->conditional_invocation)
-    {
-      ConditionalInvocation *ci = def->conditional_invocation;
+    ConditionalInvocation *ci = def->conditional_invocation;
 
-      // Register each signal mentioned in the pattern args
-      for (size_t i = 0; i < ci->arg_count; ++i)
-      {
-        const char *arg = string_list_get_by_index(ci->pattern_args, i); // ✅
-
-        if (!arg)
-          continue;
+    // Register each signal mentioned in the pattern args
+    for (size_t i = 0; i < ci->arg_count; ++i)
+    {
+      const char *arg = string_list_get(ci->pattern_args, i); // ✅
 
-        char *resolved_signal;
-        asprintf(&resolved_signal, "%s.local.%s", def->name, arg);
-        register_external_signal(resolved_signal, resolved_signal); // maps to itself for now
-      }
+      if (!arg)
+        continue;
 
-      // Register output signal
-      if (ci->output)
-      {
-        char *resolved_output;
-        asprintf(&resolved_output, "%s.local.%s", def->name, ci->output);
-        register_external_signal(resolved_output, resolved_output);
-      }
+      char *resolved_signal;
+      asprintf(&resolved_signal, "%s.local.%s", def->name, arg);
+      register_external_signal(resolved_signal, resolved_signal); // maps to itself for now
     }
 
-    // Output file path
-    char path[512];
-    snprintf(path, sizeof(path), "%s/%s.spvasm.sexpr", spirv_out_dir, def->name);
-
-    FILE *f = fopen(path, "w");
-    if (!f)
+    // Register output signal
+    if (ci->output)
     {
-      LOG_ERROR("❌ Failed to open SPIR-V output file for %s", def->name);
-      continue;
+      char *resolved_output;
+      asprintf(&resolved_output, "%s.local.%s", def->name, ci->output);
+      register_external_signal(resolved_output, resolved_output);
     }
+  }
+
+  // Output file path
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s.spvasm.sexpr", spirv_out_dir, def->name);
+
+  // Signals above are registered either way; only the file write is skipped
+  unsigned char key[BUILD_CACHE_KEY_SIZE];
+  int cacheable = build_cache_source_key(blk->cache, def->origin_sexpr_path, key) == 0;
+  if (cacheable && build_cache_fresh(blk->cache, path, key))
+  {
+    LOG_INFO("♻️  SPIR-V for %s unchanged: %s", def->name, path);
+    return;
+  }
+
+  FILE *f = fopen(path, "w");
+  if (!f)
+  {
+    LOG_ERROR("❌ Failed to open SPIR-V output file for %s", def->name);
+    return;
+  }
+
+  LOG_INFO("🌀 Generating SPIR-V S-expression for %s", def->name);
+
+  SPIRVModule mod = {0};
+  mod.current_definition = def;
 
-    LOG_INFO("🌀 Generating SPIR-V S-expression for %s", def->name);
+  emit_spirv_header(&mod);
+
+  if (def->conditional_invocation)
+  {
+    emit_conditional_invocation(&mod, def->conditional_invocation);
+  }
+
+  dedupe_prelude_ops(&mod);
+  write_spirv_module(f, mod.head);
+  fclose(f);
+  free_spirv_module(&mod);
+  if (cacheable)
+    build_cache_record(blk->cache, path, key);
+
+  LOG_INFO("✅ Wrote SPIR-V to %s", path);
+}
+
+void spirv_parse_block(Block *blk, const char *spirv_out_dir)
+{
+  for (Definition *def = blk->definitions; def != NULL; def = def->next)
+    emit_spirv_definition(blk, def, spirv_out_dir);
+}
 
-    SPIRVModule mod = {0};
-    mod.current_definition = def;
+void emit_spirv_instances(Block *blk, const char *spirv_out_dir)
+{
+  // Distinct Definitions in instance order; after constant folding these
+  // include the specialized ones, which are not on blk->definitions
+  size_t capacity = 0, count = 0;
+  const Definition **seen = NULL;
+  for (InstanceList *node = blk->instances; node; node = node->next)
+  {
+    const Definition *def = node->instance ? node->instance->definition : NULL;
+    if (!def)
+      continue;
 
-    emit_spirv_header(&mod);
+    bool emitted = false;
+    for (size_t i = 0; i < count && !emitted; ++i)
+      emitted = seen[i] == def;
+    if (emitted)
+      continue;
 
-    if (def->conditional_invocation)
+    if (count == capacity)
     {
-      emit_conditional_invocation(&mod, def->conditional_invocation);
+      capacity = capacity ? capacity * 2 : 16;
+      const Definition **grown = realloc(seen, sizeof(Definition *) * capacity);
+      if (!grown)
+      {
+        LOG_ERROR("❌ Out of memory collecting definitions for SPIR-V");
+        break;
+      }
+      seen = grown;
     }
+    seen[count++] = def;
 
-    dedupe_prelude_ops(&mod);
-    write_spirv_module(f, mod.head);
-    fclose(f);
-    free_spirv_module(&mod);
-
-    LOG_INFO("✅ Wrote SPIR-V to %s", path);
+    // The emitter only reads the Definition; SPIRVModule just isn't const-qualified
+    emit_spirv_definition(blk, (Definition *)def, spirv_out_dir);
   }
+  free(seen);
 }
 
 void emit_spirv_block(Block *blk, const char *spirv_frag_dir, const char *out_path)
@@ -41,6 +41,7 @@ void emit_op(SPIRVModule *mod, const char *opcode, const char **operands, size_t
 void write_spirv_module(FILE *out, SPIRVOp *head);
 void free_spirv_module(SPIRVModule *mod);
 void spirv_parse_block(Block *blk, const char *spirv_out_dir);
+void emit_spirv_instances(Block *blk, const char *spirv_out_dir); // One module per Definition still in use
 SPIRVOp *build_sample_spirv(void);
 void emit_spirv_header(SPIRVModule *mod);
 SPIRVOp *make_op(const char *opcode, const char **operands, size_t count);
@@ -1,79 +1,160 @@
+#define _POSIX_C_SOURCE 200809L // clock_gettime for the thread scaling report
 #include "log.h"
 #include "block.h"
 #include "block_util.h"
 #include "eval.h"
 #include "eval_util.h"
+#include "fanout.h"
+#include "jit.h"
+#include "netlist.h"
+#include "perf_counter.h"
+#include "bytecode.h"
+#include "schedule.h"
+#include "thread_pool.h"
+#include "truth_table.h"
 #include "instance.h"
 #include "string_list.h"
 #include "signal_map.h"
+#include "signal_store.h"
 #include "signal.h"
 #include "pubsub.h"
 #include "util.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
 #include <unistd.h>
 
 #define MAX_ITERATIONS 5
 
-int evaluate_conditional_logic(Instance *inst, SignalMap *signal_map)
-{
-    if (!inst || !inst->definition || !inst->invocation)
-        return 0;
+// Event mode has no round limit; this caps evaluations per instance so an
+// oscillating feedback loop still terminates.
+#define MAX_EVENTS_PER_INSTANCE 64
 
-    Definition *def = inst->definition;
-    Invocation *inv = inst->invocation;
-    ConditionalInvocation *ci = def->conditional_invocation;
+// Outcomes of a case lookup that are not a case index
+#define CASE_NO_MATCH   (-1)
+#define CASE_NOT_READY  (-2)
+#define CASE_NOT_BITS   (-3)  // Some input is not a single bit; table cannot answer
 
-    if (!ci || !ci->pattern_args || ci->arg_count == 0 || !ci->output)
-        return 0;
+/**
+ * Fast path: pack one bit per template arg and index the compiled table.
+ */
+static int match_case_by_table(const SignalId *pattern_ids, size_t pattern_count, const TruthTable *table, SignalMap *signal_map)
+{
+    uint32_t row = 0;
+    for (size_t i = 0; i < pattern_count; ++i)
+    {
+        uint8_t bit = signal_map_get_bit(signal_map, pattern_ids[i]);
+        if (bit > 1)
+            return bit == SIGNAL_BIT_UNSET ? CASE_NOT_READY : CASE_NOT_BITS;
+        row = (row << 1) | bit;
+    }
 
-    LOG_INFO("🔘 Evaluating conditional logic for: %s", def->name);
+    uint16_t case_index = truth_table_lookup(table, row);
+    return case_index == TRUTH_TABLE_NO_CASE ? CASE_NO_MATCH : (int)case_index;
+}
 
-    // 1. Build pattern from actual signal values
+/**
+ * Debug / fallback path: concatenate the raw values and compare against every
+ * Case pattern in turn.
+ */
+static int match_case_by_pattern(const SignalId *pattern_ids, size_t pattern_count, const ConditionalInvocation *ci, SignalMap *signal_map)
+{
     char pattern[256] = {0};
 
-    LOG_INFO("🧵 Pattern args (%zu):", ci->arg_count);
-    for (size_t i = 0; i < ci->arg_count; ++i)
+    LOG_INFO("🧵 Pattern args (%zu):", pattern_count);
+    for (size_t i = 0; i < pattern_count; ++i)
     {
-        const char *sig = string_list_get_by_index(ci->pattern_args, i);
+        const char *sig = signal_map_name(signal_map, pattern_ids[i]);
         LOG_INFO("    [%zu] %s", i, sig ? sig : "(null)");
     }
 
-    for (size_t i = 0; i < ci->arg_count; ++i)
+    for (size_t i = 0; i < pattern_count; ++i)
     {
-        const char *sig = string_list_get_by_index(ci->pattern_args, i);
-        if (!sig)
-            continue;
-
-        const char *value = get_signal_value(signal_map, sig);
+        const char *value = signal_map_get(signal_map, pattern_ids[i]);
         if (!value)
-        {
-            LOG_WARN("🚫 Signal '%s' not found in signal map", sig);
-            return 0; // 🚫 Bail out early if a signal is missing
-        }
+            return CASE_NOT_READY;
 
         strncat(pattern, value, sizeof(pattern) - strlen(pattern) - 1);
     }
 
     LOG_INFO("🔣 Generated pattern: %s", pattern);
 
-    // 2. Match against conditional cases
     for (size_t i = 0; i < ci->case_count; ++i)
     {
-        ConditionalCase c = ci->cases[i];
-        if (strcmp(c.pattern, pattern) == 0)
-        {
-            LOG_INFO("📤 Matched result: %s → Publishing to %s", c.result, ci->output);
-            publish_signal(signal_map, ci->output, c.result);
-            return 1;
-        }
+        if (strcmp(ci->cases[i].pattern, pattern) == 0)
+            return (int)i;
     }
 
     LOG_WARN("⚠️ No matching case for pattern: %s", pattern);
-    return 0;
+    return CASE_NO_MATCH;
 }
 
+/**
+ * Case lookup shared by the Instance and Netlist paths. `ci` is known to have
+ * pattern args and an output; `name` is only used in messages. Returns the
+ * case index, or a negative CASE_* outcome. Logs nothing on the table path
+ * unless something is wrong.
+ */
+static int find_case(const ConditionalInvocation *ci, const SignalId *pattern_ids, size_t pattern_count,
+                     const char *name, SignalMap *signal_map)
+{
+    // Build with -DEVAL_STRING_MATCH to force the string matcher when debugging tables
+    int case_index = CASE_NOT_BITS;
+#ifndef EVAL_STRING_MATCH
+    if (ci->truth_table)
+    {
+        case_index = match_case_by_table(pattern_ids, pattern_count, ci->truth_table, signal_map);
+        if (case_index == CASE_NO_MATCH)
+            LOG_WARN("⚠️ No matching case in truth table for %s", name);
+    }
+#endif
+    if (case_index == CASE_NOT_BITS)
+        case_index = match_case_by_pattern(pattern_ids, pattern_count, ci, signal_map);
+
+    if (case_index == CASE_NOT_READY)
+    {
+        for (size_t i = 0; i < pattern_count; ++i)
+            if (!signal_map_get(signal_map, pattern_ids[i]))
+                LOG_WARN("🚫 Signal '%s' not found in signal map", signal_map_name(signal_map, pattern_ids[i]));
+        return CASE_NOT_READY; // 🚫 Bail out early if a signal is missing
+    }
+    return case_index;
+}
+
+// Case lookup and publish
+static int apply_conditional_logic(const ConditionalInvocation *ci, const SignalId *pattern_ids, size_t pattern_count,
+                                   SignalId output_id, const char *name, SignalMap *signal_map)
+{
+    int case_index = find_case(ci, pattern_ids, pattern_count, name, signal_map);
+    if (case_index < 0)
+        return 0;
+
+    const ConditionalCase *c = &ci->cases[case_index];
+    if (!publish_signal_id(signal_map, output_id, c->result))
+    {
+        LOG_INFO("💤 Matched result: %s → %s unchanged", c->result, ci->output);
+        return 0;
+    }
+
+    LOG_INFO("📤 Matched result: %s → Published to %s", c->result, ci->output);
+    return 1;
+}
+
+int evaluate_conditional_logic(Instance *inst, SignalMap *signal_map)
+{
+    if (!inst || !inst->definition || !inst->invocation)
+        return 0;
+
+    const Definition *def = inst->definition;
+    const ConditionalInvocation *ci = def->conditional_invocation;
+
+    if (!ci || !ci->pattern_args || ci->arg_count == 0 || !ci->output)
+        return 0;
+
+    LOG_INFO("🔘 Evaluating conditional logic for: %s", def->name);
+    return apply_conditional_logic(ci, inst->pattern_ids, inst->pattern_count, inst->output_id, inst->name, signal_map);
+}
 
 int eval_instance(Instance *instance, Block *blk, SignalMap *signal_map)
 {
@@ -86,29 +167,26 @@ int eval_instance(Instance *instance, Block *blk, SignalMap *signal_map)
     LOG_INFO("Evaluating instance %s", instance->name);
 
     // Publish any literal bindings to signal map
-    Invocation *inv = instance->invocation;
-    if (inv->literal_bindings)
+    const Invocation *inv = instance->invocation;
+    for (size_t i = 0; i < instance->literal_count; ++i)
     {
-        for (size_t i = 0; i < inv->literal_bindings->count; ++i)
-        {
-            LiteralBinding *binding = &inv->literal_bindings->items[i];
+        const LiteralBinding *binding = &inv->literal_bindings->items[i];
 
-            if (!binding->name)
-                LOG_WARN("⚠️ NULL binding name at index %zu", i);
-            if (!binding->value)
-                LOG_WARN("⚠️ NULL binding value at index %zu", i);
+        if (instance->literal_ids[i] == SIGNAL_ID_NONE)
+            LOG_WARN("⚠️ NULL binding name at index %zu", i);
+        if (!binding->value)
+            LOG_WARN("⚠️ NULL binding value at index %zu", i);
 
-            if (!binding->name || !binding->value)
-                continue;
+        if (instance->literal_ids[i] == SIGNAL_ID_NONE || !binding->value)
+            continue;
 
-            update_signal_value(signal_map, binding->name, binding->value);
-            LOG_INFO("📥 Published literal: %s = %s", binding->name, binding->value);
-        }
+        signal_map_set(signal_map, instance->literal_ids[i], binding->value);
+        LOG_INFO("📥 Published literal: %s = %s",
+                 signal_map_name(signal_map, instance->literal_ids[i]), binding->value);
     }
 
     // Now check if inputs are ready
-    StringList *input_names = inv->input_signals;
-    if (!all_signals_ready(input_names, signal_map))
+    if (!all_signal_ids_ready(instance->input_ids, instance->input_count, signal_map))
     {
         LOG_INFO("⏳ Skipping %s — inputs not ready", inv->target_name);
         return 0;
@@ -121,7 +199,71 @@ int eval_instance(Instance *instance, Block *blk, SignalMap *signal_map)
     return changed;
 }
 
-int eval(Block *blk, SignalMap *signal_map)
+typedef struct WorkerChanges WorkerChanges;
+static void record_change(WorkerChanges *sink, SignalId id);
+
+/**
+ * eval_instance for one Netlist row: same literals, readiness rule and case
+ * lookup, read from the row's arrays instead of the Instance graph. With a
+ * sink (pool workers) the output is only stored and its id recorded: no
+ * logging or publishing, which would put every worker on a lock per gate.
+ */
+static int eval_row(const Netlist *net, uint32_t row, SignalMap *signal_map, WorkerChanges *sink)
+{
+    for (uint32_t l = net->literal_first[row]; l < net->literal_first[row + 1]; ++l)
+        signal_map_set(signal_map, net->literal_slots[l], net->literal_values[l]);
+
+    if (!(net->flags[row] & NETLIST_ROW_LOGIC))
+        return 0;
+
+    uint32_t input_count, pattern_count;
+    const SignalId *inputs = netlist_inputs(net, row, &input_count);
+    if (!all_signal_ids_ready(inputs, input_count, signal_map))
+        return 0;
+
+    const SignalId *patterns = netlist_patterns(net, row, &pattern_count);
+    const ConditionalInvocation *ci = net->logic[net->def_index[row]];
+    if (!sink)
+        return apply_conditional_logic(ci, patterns, pattern_count, net->output_slot[row], net->names[row], signal_map);
+
+    int case_index = find_case(ci, patterns, pattern_count, net->names[row], signal_map);
+    if (case_index < 0 || !signal_map_set(signal_map, net->output_slot[row], ci->cases[case_index].result))
+        return 0;
+    record_change(sink, net->output_slot[row]);
+    return 1;
+}
+
+// EvalOptions.poll_budget_ms of the running eval_with_options call
+static int poll_budget_ms = 0;
+
+// Between passes: give monitors a consistent copy, then take in bus traffic.
+// Returns the number of signals other nodes changed; on_change (may be NULL)
+// is called with each of them.
+static int end_of_pass(SignalMap *signal_map, void (*on_change)(void *ctx, SignalId id), void *ctx)
+{
+    signal_store_publish(signal_map->store, signal_map);
+    return poll_pubsub_changes(signal_map, poll_budget_ms, on_change, ctx);
+}
+
+// Ends a pass and tells whether another is due: values injected from the bus
+// only reach their readers if the netlist is evaluated again. Bounded by
+// MAX_ITERATIONS passes per evaluation.
+static int another_pass_due(SignalMap *signal_map, int *passes, void (*on_change)(void *ctx, SignalId id), void *ctx)
+{
+    int injected = end_of_pass(signal_map, on_change, ctx);
+    if (injected == 0)
+        return 0;
+
+    if (++*passes >= MAX_ITERATIONS)
+    {
+        LOG_WARN("⚠️ Bus updates still arriving after %d passes, leaving them for the next evaluation", *passes);
+        return 0;
+    }
+    LOG_INFO("📬 %d signal(s) changed on the bus, evaluating again", injected);
+    return 1;
+}
+
+static int eval_sweep(Block *blk, SignalMap *signal_map)
 {
     int total_changes = 0;
     int iteration = 0;
@@ -148,6 +290,9 @@ int eval(Block *blk, SignalMap *signal_map)
         total_changes += changes_this_round;
         iteration++;
 
+        // Injected values are changes too: the next round has to see them
+        changes_this_round += end_of_pass(signal_map, NULL, NULL);
+
         if (changes_this_round == 0)
         {
             LOG_INFO("🟢 Stable — no changes detected.");
@@ -160,10 +305,880 @@ int eval(Block *blk, SignalMap *signal_map)
             break;
         }
 
-        poll_pubsub(signal_map);
-
     } while (1);
 
     LOG_INFO("🧮 Total changes: %d", total_changes);
     return total_changes;
 }
+
+// FIFO ring of instance ordinals; queued[] keeps each instance in it at most once
+typedef struct Worklist {
+    uint32_t *queue;
+    bool *queued;
+    size_t capacity;
+    size_t head, tail, pending;
+    const FanoutIndex *fanout;
+} Worklist;
+
+static void worklist_push(Worklist *work, uint32_t ordinal)
+{
+    if (work->queued[ordinal])
+        return;
+    work->queue[work->tail] = ordinal;
+    work->tail = (work->tail + 1) % work->capacity;
+    work->queued[ordinal] = true;
+    work->pending++;
+}
+
+static void queue_readers(Worklist *work, SignalId id)
+{
+    size_t reader_count = 0;
+    const uint32_t *readers = fanout_readers(work->fanout, id, &reader_count);
+    for (size_t r = 0; r < reader_count; ++r)
+        worklist_push(work, readers[r]);
+}
+
+static void wake_readers(void *ctx, SignalId id)
+{
+    queue_readers(ctx, id);
+}
+
+static int eval_event_driven(Block *blk, SignalMap *signal_map)
+{
+    FanoutIndex *fanout = build_fanout_index(blk, signal_map);
+    if (!fanout)
+    {
+        LOG_ERROR("❌ Failed to build fan-out index, falling back to sweep evaluation");
+        return eval_sweep(blk, signal_map);
+    }
+
+    size_t n = fanout->instance_count;
+    int total_changes = 0;
+    size_t events = 0;
+    size_t budget = n * MAX_EVENTS_PER_INSTANCE;
+
+    uint32_t *queue = malloc(sizeof(uint32_t) * (n ? n : 1));
+    bool *queued = calloc(n ? n : 1, sizeof(bool));
+    if (!queue || !queued)
+    {
+        LOG_ERROR("❌ Failed to allocate evaluation worklist");
+        free(queue);
+        free(queued);
+        destroy_fanout_index(fanout);
+        return 0;
+    }
+
+    Worklist work = {queue, queued, n, 0, 0, 0, fanout};
+
+    // Every instance gets one initial evaluation, in block order
+    for (size_t i = 0; i < n; ++i)
+        worklist_push(&work, (uint32_t)i);
+
+    LOG_INFO("🔁 Starting event-driven evaluation (%zu instance(s))", n);
+
+    int passes = 0;
+    do
+    {
+        while (work.pending > 0)
+        {
+            if (events >= budget)
+            {
+                LOG_WARN("⚠️ Event budget (%zu) exhausted with %zu instance(s) pending. Evaluation unstable.", budget, work.pending);
+                break;
+            }
+
+            uint32_t ordinal = queue[work.head];
+            work.head = (work.head + 1) % n;
+            queued[ordinal] = false;
+            work.pending--;
+            events++;
+
+            Instance *inst = fanout->instances[ordinal];
+            if (!inst)
+                continue;
+
+            int changed = eval_instance(inst, blk, signal_map);
+            if (!changed)
+                continue;
+
+            total_changes += changed;
+            queue_readers(&work, inst->output_id);
+        }
+
+        if (work.pending == 0)
+            LOG_INFO("🟢 Stable — worklist drained after %zu evaluation(s).", events);
+
+        // Signals changed on the bus wake their readers like any other change
+    } while (another_pass_due(signal_map, &passes, wake_readers, &work) && work.pending > 0 && events < budget);
+
+    free(queue);
+    free(queued);
+    destroy_fanout_index(fanout);
+
+    LOG_INFO("🧮 Total changes: %d", total_changes);
+    return total_changes;
+}
+
+// One feedback loop: re-run its members in block order until none changes
+static int settle_loop(const Netlist *net, const ScheduleStep *step, SignalMap *signal_map, WorkerChanges *sink)
+{
+    int total_changes = 0;
+    for (int round = 0; round < MAX_ITERATIONS; ++round)
+    {
+        int changes_this_round = 0;
+        for (uint32_t i = step->first; i < step->first + step->count; ++i)
+            changes_this_round += eval_row(net, i, signal_map, sink);
+
+        total_changes += changes_this_round;
+        if (changes_this_round == 0)
+            return total_changes;
+    }
+
+    LOG_WARN("⚠️ Feedback loop of %u instance(s) at level %u did not settle in %d rounds.",
+             step->count, step->level, MAX_ITERATIONS);
+    return total_changes;
+}
+
+static Schedule *ensure_schedule(Block *blk, SignalMap *signal_map)
+{
+    // --load has no compile step, so the schedule is built on first use
+    if (!blk->schedule)
+        blk->schedule = build_schedule(blk, signal_map);
+    return blk->schedule;
+}
+
+static Netlist *ensure_netlist(Block *blk, SignalMap *signal_map)
+{
+    Schedule *schedule = ensure_schedule(blk, signal_map);
+    if (schedule && !blk->netlist)
+        blk->netlist = build_netlist(schedule);
+    return blk->netlist;
+}
+
+static int run_levelized_pass(const Schedule *schedule, const Netlist *net, SignalMap *signal_map)
+{
+    int total_changes = 0;
+    for (size_t s = 0; s < schedule->step_count; ++s)
+    {
+        const ScheduleStep *step = &schedule->steps[s];
+        if (step->iterative)
+        {
+            total_changes += settle_loop(net, step, signal_map, NULL);
+            continue;
+        }
+
+        // Every driver of this level ran in an earlier one: a single pass settles it
+        for (uint32_t i = step->first; i < step->first + step->count; ++i)
+            total_changes += eval_row(net, i, signal_map, NULL);
+    }
+    return total_changes;
+}
+
+static int eval_levelized(Block *blk, SignalMap *signal_map)
+{
+    Schedule *schedule = ensure_schedule(blk, signal_map);
+    Netlist *net = ensure_netlist(blk, signal_map);
+    if (!schedule || !net)
+    {
+        LOG_ERROR("❌ No evaluation schedule, falling back to sweep evaluation");
+        return eval_sweep(blk, signal_map);
+    }
+
+    LOG_INFO("🔁 Starting levelized evaluation (%zu level(s), %zu step(s))", schedule->level_count, schedule->step_count);
+
+    int total_changes = 0;
+    int passes = 0;
+    do
+        total_changes += run_levelized_pass(schedule, net, signal_map);
+    while (another_pass_due(signal_map, &passes, NULL, NULL));
+
+    LOG_INFO("🧮 Total changes: %d", total_changes);
+    return total_changes;
+}
+
+// Smallest slice of a level handed to one worker; below this the claim costs more than the gates
+#define PARALLEL_MIN_CHUNK 32
+
+typedef enum {
+    TASK_RANGE,   // A slice of one static step
+    TASK_LOOP     // One feedback loop, settled by a single worker
+} ParallelTaskKind;
+
+typedef struct ParallelTask {
+    ParallelTaskKind kind;
+    uint32_t first;   // First Netlist row (Schedule.order position)
+    uint32_t count;   // Rows
+    uint32_t step;    // TASK_LOOP: the loop's step
+} ParallelTask;
+
+/**
+ * Tasks in schedule order plus the edges between them. Task b waits on task
+ * a when b reads a signal a writes, or when both write it (b is later in
+ * schedule order, so the last writer is the one levelized mode would pick).
+ * Readers always come after writers in schedule.h's levels, except inside a
+ * loop, which is a single task.
+ */
+typedef struct ParallelPlan {
+    ParallelTask *tasks;
+    size_t task_count;
+    uint32_t *dep_count;   // Per task: tasks it waits on
+    uint32_t *succ_first;  // task_count + 1, into succs
+    uint32_t *succs;       // Tasks waiting on each task
+    size_t edge_count;
+} ParallelPlan;
+
+// Signals a worker changed during a pass; published by the calling thread afterwards
+struct WorkerChanges {
+    SignalId *ids;
+    size_t count;
+    size_t capacity;
+    int changes;
+};
+
+static void record_change(WorkerChanges *sink, SignalId id)
+{
+    if (sink->count == sink->capacity)
+    {
+        size_t capacity = sink->capacity ? sink->capacity * 2 : 256;
+        SignalId *grown = realloc(sink->ids, capacity * sizeof(SignalId));
+        if (!grown)
+            return; // Stored but not published; the next pass that changes it will be
+        sink->ids = grown;
+        sink->capacity = capacity;
+    }
+    sink->ids[sink->count++] = id;
+}
+
+// Padded so counters of neighbouring workers do not share a cache line
+typedef union PaddedWorkerChanges {
+    WorkerChanges c;
+    char pad[64];
+} PaddedWorkerChanges;
+
+typedef struct ParallelRun {
+    const Schedule *schedule;
+    const ParallelPlan *plan;
+    const Netlist *net;
+    SignalMap *signal_map;
+    PaddedWorkerChanges *workers;
+} ParallelRun;
+
+static void destroy_parallel_plan(ParallelPlan *plan)
+{
+    free(plan->tasks);
+    free(plan->dep_count);
+    free(plan->succ_first);
+    free(plan->succs);
+    memset(plan, 0, sizeof(*plan));
+}
+
+typedef struct PlanEdges {
+    uint32_t *from;
+    uint32_t *to;
+    size_t count;
+    size_t capacity;
+} PlanEdges;
+
+// Edge from → task unless it is the task itself or already recorded for it
+static int add_plan_edge(PlanEdges *edges, uint32_t *seen, uint32_t from, uint32_t task)
+{
+    if (from == task || seen[from] == task + 1)
+        return 0;
+    seen[from] = task + 1;
+
+    if (edges->count == edges->capacity)
+    {
+        size_t capacity = edges->capacity ? edges->capacity * 2 : 1024;
+        uint32_t *grown_from = realloc(edges->from, capacity * sizeof(uint32_t));
+        if (grown_from)
+            edges->from = grown_from;
+        uint32_t *grown_to = realloc(edges->to, capacity * sizeof(uint32_t));
+        if (grown_to)
+            edges->to = grown_to;
+        if (!grown_from || !grown_to)
+            return -1;
+        edges->capacity = capacity;
+    }
+    edges->from[edges->count] = from;
+    edges->to[edges->count] = task;
+    edges->count++;
+    return 0;
+}
+
+// Tasks that read each signal since it was last written. The next writer
+// waits for all of them, so a multiply-driven signal or a literal slot is
+// never overwritten before an earlier reader has seen the old value.
+typedef struct PlanReaders {
+    uint32_t *head;     // By SignalId: newest node + 1, 0 = none
+    uint32_t *task;     // By node
+    uint32_t *next;     // By node: older node + 1, 0 = end
+    size_t count;
+    size_t capacity;
+} PlanReaders;
+
+static int add_plan_reader(PlanReaders *readers, SignalId id, uint32_t t)
+{
+    if (readers->head[id] && readers->task[readers->head[id] - 1] == t)
+        return 0; // Same task, another port
+
+    if (readers->count == readers->capacity)
+    {
+        size_t capacity = readers->capacity ? readers->capacity * 2 : 1024;
+        uint32_t *task = realloc(readers->task, capacity * sizeof(uint32_t));
+        if (task)
+            readers->task = task;
+        uint32_t *next = realloc(readers->next, capacity * sizeof(uint32_t));
+        if (next)
+            readers->next = next;
+        if (!task || !next)
+            return -1;
+        readers->capacity = capacity;
+    }
+    readers->task[readers->count] = t;
+    readers->next[readers->count] = readers->head[id];
+    readers->head[id] = (uint32_t)++readers->count;
+    return 0;
+}
+
+// Reads first, then writes, so a task never waits on itself through a signal
+// it both reads and writes. Each write waits for the previous writer
+// (write-after-write) and for every reader since then (write-after-read).
+static int link_task(const Netlist *net, const ParallelTask *task, uint32_t t, uint32_t *writer,
+                     PlanReaders *readers, uint32_t *seen, size_t signal_count, PlanEdges *edges)
+{
+    for (uint32_t row = task->first; row < task->first + task->count; ++row)
+        for (uint32_t p = net->port_first[row]; p < net->port_first[row + 1]; ++p)
+        {
+            SignalId id = net->ports[p];
+            if (id >= signal_count)
+                continue;
+            if (writer[id] && add_plan_edge(edges, seen, writer[id] - 1, t) != 0)
+                return -1;
+            if (add_plan_reader(readers, id, t) != 0)
+                return -1;
+        }
+
+    for (uint32_t row = task->first; row < task->first + task->count; ++row)
+        for (uint32_t w = net->literal_first[row]; w <= net->literal_first[row + 1]; ++w)
+        {
+            SignalId id = w < net->literal_first[row + 1] ? net->literal_slots[w] : net->output_slot[row];
+            if (id >= signal_count)
+                continue;
+            if (writer[id] && add_plan_edge(edges, seen, writer[id] - 1, t) != 0)
+                return -1;
+            for (uint32_t node = readers->head[id]; node; node = readers->next[node - 1])
+                if (add_plan_edge(edges, seen, readers->task[node - 1], t) != 0)
+                    return -1;
+            readers->head[id] = 0;
+            writer[id] = t + 1;
+        }
+    return 0;
+}
+
+static int build_parallel_plan(const Schedule *schedule, const Netlist *net, const SignalMap *signal_map,
+                               size_t threads, ParallelPlan *plan)
+{
+    memset(plan, 0, sizeof(*plan));
+
+    // Static steps are split into chunks, so there are never more tasks than instances + steps
+    size_t max_tasks = schedule->instance_count + schedule->step_count;
+    plan->tasks = malloc(sizeof(ParallelTask) * (max_tasks ? max_tasks : 1));
+    if (!plan->tasks)
+        return -1;
+
+    for (size_t k = 0; k < schedule->step_count; ++k)
+    {
+        const ScheduleStep *step = &schedule->steps[k];
+        if (step->iterative)
+        {
+            plan->tasks[plan->task_count++] = (ParallelTask){TASK_LOOP, step->first, step->count, (uint32_t)k};
+            continue;
+        }
+
+        uint32_t chunk = (uint32_t)(step->count / (threads * 4));
+        if (chunk < PARALLEL_MIN_CHUNK)
+            chunk = PARALLEL_MIN_CHUNK;
+        for (uint32_t i = 0; i < step->count; i += chunk)
+        {
+            uint32_t count = step->count - i < chunk ? step->count - i : chunk;
+            plan->tasks[plan->task_count++] = (ParallelTask){TASK_RANGE, step->first + i, count, (uint32_t)k};
+        }
+    }
+
+    size_t n = plan->task_count;
+    uint32_t *writer = calloc(signal_map->count ? signal_map->count : 1, sizeof(uint32_t)); // Last writing task + 1
+    uint32_t *seen = calloc(n ? n : 1, sizeof(uint32_t));  // Task + 1 that last linked to each predecessor
+    PlanReaders readers = {0};
+    readers.head = calloc(signal_map->count ? signal_map->count : 1, sizeof(uint32_t));
+    PlanEdges edges = {0};
+    plan->dep_count = calloc(n ? n : 1, sizeof(uint32_t));
+    plan->succ_first = calloc(n + 1, sizeof(uint32_t));
+    int status = writer && seen && readers.head && plan->dep_count && plan->succ_first ? 0 : -1;
+
+    for (uint32_t t = 0; status == 0 && t < n; ++t)
+        status = link_task(net, &plan->tasks[t], t, writer, &readers, seen, signal_map->count, &edges);
+    free(readers.head);
+    free(readers.task);
+    free(readers.next);
+
+    // Edges are produced per successor; regroup them by predecessor for the pool
+    if (status == 0)
+    {
+        plan->succs = malloc(sizeof(uint32_t) * (edges.count ? edges.count : 1));
+        status = plan->succs ? 0 : -1;
+    }
+    if (status == 0)
+    {
+        for (size_t e = 0; e < edges.count; ++e)
+        {
+            plan->succ_first[edges.from[e] + 1]++;
+            plan->dep_count[edges.to[e]]++;
+        }
+        for (size_t t = 0; t < n; ++t)
+            plan->succ_first[t + 1] += plan->succ_first[t];
+
+        memset(seen, 0, sizeof(uint32_t) * (n ? n : 1)); // Reused as a fill cursor
+        for (size_t e = 0; e < edges.count; ++e)
+            plan->succs[plan->succ_first[edges.from[e]] + seen[edges.from[e]]++] = edges.to[e];
+        plan->edge_count = edges.count;
+    }
+
+    free(edges.from);
+    free(edges.to);
+    free(seen);
+    free(writer);
+    if (status != 0)
+        destroy_parallel_plan(plan);
+    return status;
+}
+
+static void run_parallel_task(void *ctx, size_t index, size_t worker)
+{
+    ParallelRun *run = ctx;
+    const ParallelTask *task = &run->plan->tasks[index];
+    WorkerChanges *sink = &run->workers[worker].c;
+
+    if (task->kind == TASK_LOOP)
+    {
+        sink->changes += settle_loop(run->net, &run->schedule->steps[task->step], run->signal_map, sink);
+        return;
+    }
+    for (uint32_t i = task->first; i < task->first + task->count; ++i)
+        sink->changes += eval_row(run->net, i, run->signal_map, sink);
+}
+
+/**
+ * One levelized pass on the pool. Workers only write the signals of the
+ * instances they evaluate, and tasks that share a signal are ordered by the
+ * plan's edges, so the signal map needs no locking. Changes are published
+ * here once the pool is done. Does not poll pubsub.
+ */
+static int run_parallel_pass(const Schedule *schedule, const ParallelPlan *plan, ThreadPool *pool,
+                             const Netlist *net, SignalMap *signal_map)
+{
+    size_t threads = thread_pool_size(pool);
+    PaddedWorkerChanges *workers = calloc(threads, sizeof(PaddedWorkerChanges));
+    if (!workers)
+    {
+        LOG_ERROR("❌ Failed to allocate per-worker change lists");
+        return 0;
+    }
+
+    ParallelRun run = {schedule, plan, net, signal_map, workers};
+    thread_pool_run_graph(pool, plan->task_count, plan->dep_count, plan->succ_first, plan->succs,
+                          run_parallel_task, &run);
+
+    int total_changes = 0;
+    for (size_t w = 0; w < threads; ++w)
+    {
+        total_changes += workers[w].c.changes;
+        publish_stored_signals(signal_map, workers[w].c.ids, workers[w].c.count);
+        free(workers[w].c.ids);
+    }
+    free(workers);
+    return total_changes;
+}
+
+static int eval_parallel(Block *blk, SignalMap *signal_map, size_t threads)
+{
+    Schedule *schedule = ensure_schedule(blk, signal_map);
+    Netlist *net = ensure_netlist(blk, signal_map);
+    if (!schedule || !net)
+    {
+        LOG_ERROR("❌ No evaluation schedule, falling back to sweep evaluation");
+        return eval_sweep(blk, signal_map);
+    }
+
+    ThreadPool *pool = thread_pool_create(threads);
+    ParallelPlan plan;
+    if (!pool || build_parallel_plan(schedule, net, signal_map, thread_pool_size(pool), &plan) != 0)
+    {
+        LOG_ERROR("❌ Failed to set up parallel evaluation, falling back to levelized evaluation");
+        thread_pool_destroy(pool);
+        return eval_levelized(blk, signal_map);
+    }
+
+    LOG_INFO("🔁 Starting parallel evaluation (%zu thread(s), %zu level(s), %zu task(s), %zu dependency edge(s))",
+             thread_pool_size(pool), schedule->level_count, plan.task_count, plan.edge_count);
+
+    int total_changes = 0;
+    int passes = 0;
+    do
+        total_changes += run_parallel_pass(schedule, &plan, pool, net, signal_map);
+    while (another_pass_due(signal_map, &passes, NULL, NULL));
+
+    destroy_parallel_plan(&plan);
+    thread_pool_destroy(pool);
+
+    LOG_INFO("🧮 Total changes: %d", total_changes);
+    return total_changes;
+}
+
+static int eval_native(Block *blk, SignalMap *signal_map, const char *cache_dir)
+{
+    Schedule *schedule = ensure_schedule(blk, signal_map);
+    Netlist *net = ensure_netlist(blk, signal_map);
+    if (schedule && net && !blk->jit)
+        blk->jit = jit_compile(schedule, net, signal_map, cache_dir);
+    if (!blk->jit)
+    {
+        LOG_WARN("⚠️ No native code for this netlist, falling back to levelized evaluation");
+        return eval_levelized(blk, signal_map);
+    }
+
+    LOG_INFO("🔁 Starting native evaluation (%zu level(s))", schedule->level_count);
+
+    int total_changes = 0;
+    int passes = 0;
+    do
+    {
+        int changes = jit_eval(blk->jit, signal_map);
+        if (changes < 0)
+        {
+            LOG_INFO("↩️ Wide signal values present, using levelized evaluation for this pass");
+            return total_changes + eval_levelized(blk, signal_map);
+        }
+        total_changes += changes;
+    } while (another_pass_due(signal_map, &passes, NULL, NULL));
+
+    LOG_INFO("🧮 Total changes: %d", total_changes);
+    return total_changes;
+}
+
+static int eval_bytecode(Block *blk, SignalMap *signal_map)
+{
+    Schedule *schedule = ensure_schedule(blk, signal_map);
+    Netlist *net = ensure_netlist(blk, signal_map);
+    if (schedule && net && !blk->bytecode)
+        blk->bytecode = bytecode_compile(schedule, net, signal_map);
+    if (!blk->bytecode)
+    {
+        LOG_WARN("⚠️ No bytecode for this netlist, falling back to levelized evaluation");
+        return eval_levelized(blk, signal_map);
+    }
+
+    LOG_INFO("🔁 Starting bytecode evaluation (%zu level(s))", schedule->level_count);
+
+    int total_changes = 0;
+    int passes = 0;
+    do
+    {
+        int changes = bytecode_eval(blk->bytecode, signal_map);
+        if (changes < 0)
+        {
+            LOG_INFO("↩️ Wide signal values present, using levelized evaluation for this pass");
+            return total_changes + eval_levelized(blk, signal_map);
+        }
+        total_changes += changes;
+    } while (another_pass_due(signal_map, &passes, NULL, NULL));
+
+    LOG_INFO("🧮 Total changes: %d", total_changes);
+    return total_changes;
+}
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+}
+
+#define BENCH_REPEATS 3
+
+// Signal values to restore before each benchmark run. Names and the lookup
+// index are left alone: a reserved id named during a run stays named.
+typedef struct SignalSnapshot {
+    const char **values;
+    uint8_t *bits;
+    size_t count;
+} SignalSnapshot;
+
+static int take_snapshot(const SignalMap *signal_map, SignalSnapshot *snapshot)
+{
+    size_t count = signal_map->count;
+    snapshot->values = malloc(sizeof(const char *) * (count ? count : 1));
+    snapshot->bits = malloc(count ? count : 1);
+    snapshot->count = count;
+    if (!snapshot->values || !snapshot->bits)
+    {
+        free(snapshot->values);
+        free(snapshot->bits);
+        return -1;
+    }
+    for (size_t id = 0; id < count; ++id)
+        snapshot->values[id] = signal_map->entries[id].value;
+    memcpy(snapshot->bits, signal_map->bits, count);
+    return 0;
+}
+
+static void restore_snapshot(SignalMap *signal_map, const SignalSnapshot *snapshot)
+{
+    for (size_t id = 0; id < snapshot->count; ++id)
+        signal_map->entries[id].value = snapshot->values[id];
+    memcpy(signal_map->bits, snapshot->bits, snapshot->count);
+
+    // Signals first interned during a run start undriven again
+    for (size_t id = snapshot->count; id < signal_map->count; ++id)
+    {
+        signal_map->entries[id].value = NULL;
+        signal_map->bits[id] = SIGNAL_BIT_UNSET;
+    }
+}
+
+static void free_snapshot(SignalSnapshot *snapshot)
+{
+    free(snapshot->values);
+    free(snapshot->bits);
+}
+
+int eval_bench_threads(Block *blk, SignalMap *signal_map, size_t max_threads)
+{
+    if (!blk || !signal_map)
+        return -1;
+
+    if (max_threads == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        max_threads = cpus > 0 ? (size_t)cpus : 1;
+    }
+
+    Schedule *schedule = ensure_schedule(blk, signal_map);
+    Netlist *net = ensure_netlist(blk, signal_map);
+    if (!schedule || !net)
+        return -1;
+
+    // Every run starts from the same signal values
+    SignalSnapshot saved;
+    if (take_snapshot(signal_map, &saved) != 0)
+        return -1;
+
+    LOG_INFO("📈 Thread scaling: %zu instance(s) in %zu level(s), best of %d run(s), up to %zu thread(s)",
+             schedule->instance_count, schedule->level_count, BENCH_REPEATS, max_threads);
+
+    // Per-gate logging would serialize every worker on the log lock
+    LogLevel saved_level = log_get_level();
+    log_set_level(saved_level > LOG_LEVEL_WARN ? saved_level : LOG_LEVEL_WARN);
+
+    double base_ms = 0.0;
+    for (size_t threads = 1;;)
+    {
+        ThreadPool *pool = thread_pool_create(threads);
+        ParallelPlan plan;
+        if (!pool || build_parallel_plan(schedule, net, signal_map, thread_pool_size(pool), &plan) != 0)
+        {
+            thread_pool_destroy(pool);
+            log_set_level(saved_level);
+            LOG_ERROR("❌ Failed to set up a %zu-thread run", threads);
+            break;
+        }
+
+        double best_ms = 0.0;
+        for (int r = 0; r < BENCH_REPEATS; ++r)
+        {
+            restore_snapshot(signal_map, &saved);
+
+            double start = now_ms();
+            run_parallel_pass(schedule, &plan, pool, net, signal_map);
+            double elapsed = now_ms() - start;
+            if (r == 0 || elapsed < best_ms)
+                best_ms = elapsed;
+        }
+
+        size_t actual = thread_pool_size(pool);
+        destroy_parallel_plan(&plan);
+        thread_pool_destroy(pool);
+
+        if (threads == 1)
+            base_ms = best_ms;
+        double speedup = best_ms > 0.0 ? base_ms / best_ms : 0.0;
+        LOG_WARN("📈 threads=%zu time=%.3f ms speedup=%.2fx efficiency=%.0f%%",
+                 actual, best_ms, speedup, 100.0 * speedup / (double)actual);
+
+        if (threads >= max_threads)
+            break;
+        threads = threads * 2 < max_threads ? threads * 2 : max_threads;
+    }
+
+    log_set_level(saved_level);
+    poll_pubsub(signal_map, 0);
+
+    free_snapshot(&saved);
+    return 0;
+}
+
+// The pre-Netlist loop, walking Instance pointers; the baseline for eval_bench_layout
+static int run_levelized_pass_instances(const Schedule *schedule, Block *blk, SignalMap *signal_map)
+{
+    int total_changes = 0;
+    for (size_t s = 0; s < schedule->step_count; ++s)
+    {
+        const ScheduleStep *step = &schedule->steps[s];
+        for (int round = 0; round < (step->iterative ? MAX_ITERATIONS : 1); ++round)
+        {
+            int changes_this_round = 0;
+            for (uint32_t i = step->first; i < step->first + step->count; ++i)
+                changes_this_round += eval_instance(schedule->instances[schedule->order[i]], blk, signal_map);
+            total_changes += changes_this_round;
+            if (changes_this_round == 0)
+                break;
+        }
+    }
+    return total_changes;
+}
+
+typedef struct LayoutResult {
+    double best_ms;
+    uint64_t counts[PERF_COUNTER_COUNT]; // Mean per pass
+} LayoutResult;
+
+static void bench_layout(bool use_netlist, const Schedule *schedule, const Netlist *net, Block *blk,
+                         SignalMap *signal_map, const SignalSnapshot *saved, PerfCounters *counters, LayoutResult *result)
+{
+    uint64_t totals[PERF_COUNTER_COUNT] = {0};
+    result->best_ms = 0.0;
+    for (int r = 0; r < BENCH_REPEATS; ++r)
+    {
+        restore_snapshot(signal_map, saved);
+
+        double start = now_ms();
+        perf_counters_start(counters);
+        if (use_netlist)
+            run_levelized_pass(schedule, net, signal_map);
+        else
+            run_levelized_pass_instances(schedule, blk, signal_map);
+        perf_counters_stop(counters);
+        double elapsed = now_ms() - start;
+
+        if (r == 0 || elapsed < result->best_ms)
+            result->best_ms = elapsed;
+        for (int k = 0; k < PERF_COUNTER_COUNT; ++k)
+            totals[k] += counters->values[k];
+    }
+    for (int k = 0; k < PERF_COUNTER_COUNT; ++k)
+        result->counts[k] = totals[k] / BENCH_REPEATS;
+}
+
+int eval_bench_layout(Block *blk, SignalMap *signal_map)
+{
+    if (!blk || !signal_map)
+        return -1;
+
+    Schedule *schedule = ensure_schedule(blk, signal_map);
+    Netlist *net = ensure_netlist(blk, signal_map);
+    if (!schedule || !net)
+        return -1;
+
+    SignalSnapshot saved;
+    if (take_snapshot(signal_map, &saved) != 0)
+        return -1;
+
+    PerfCounters counters;
+    int available = perf_counters_open(&counters);
+    LOG_INFO("📐 Layout benchmark: %zu instance(s), mean of %d levelized pass(es), %d hardware counter(s)",
+             schedule->instance_count, BENCH_REPEATS, available);
+    if (available == 0)
+        LOG_WARN("⚠️ perf_event_open unavailable here (see /proc/sys/kernel/perf_event_paranoid); timing only");
+
+    // Formatting a log line per gate would swamp the memory traffic being measured
+    LogLevel saved_level = log_get_level();
+    log_set_level(saved_level > LOG_LEVEL_WARN ? saved_level : LOG_LEVEL_WARN);
+
+    LayoutResult results[2];
+    bench_layout(false, schedule, net, blk, signal_map, &saved, &counters, &results[0]);
+    bench_layout(true, schedule, net, blk, signal_map, &saved, &counters, &results[1]);
+
+    for (int layout = 0; layout < 2; ++layout)
+    {
+        char line[512];
+        int used = snprintf(line, sizeof(line), "📐 %-9s time=%.3f ms", layout ? "netlist" : "instances", results[layout].best_ms);
+        for (int k = 0; k < PERF_COUNTER_COUNT && used > 0 && (size_t)used < sizeof(line); ++k)
+        {
+            if (perf_counter_available(&counters, (PerfCounterKind)k))
+                used += snprintf(line + used, sizeof(line) - (size_t)used, " %s=%llu",
+                                 perf_counter_name((PerfCounterKind)k), (unsigned long long)results[layout].counts[k]);
+        }
+        LOG_WARN("%s", line);
+    }
+    if (results[1].best_ms > 0.0)
+        LOG_WARN("📐 netlist speedup=%.2fx", results[0].best_ms / results[1].best_ms);
+
+    log_set_level(saved_level);
+    perf_counters_close(&counters);
+    poll_pubsub(signal_map, 0);
+
+    free_snapshot(&saved);
+    return 0;
+}
+
+int eval_with_options(Block *blk, SignalMap *signal_map, const EvalOptions *options)
+{
+    if (!blk || !signal_map)
+        return 0;
+
+    EvalMode mode = options ? options->mode : EVAL_MODE_SWEEP;
+    poll_budget_ms = options && options->poll_budget_ms > 0 ? options->poll_budget_ms : 0;
+    switch (mode)
+    {
+    case EVAL_MODE_EVENT:
+        return eval_event_driven(blk, signal_map);
+    case EVAL_MODE_LEVELIZED:
+        return eval_levelized(blk, signal_map);
+    case EVAL_MODE_PARALLEL:
+        return eval_parallel(blk, signal_map, options->threads);
+    case EVAL_MODE_NATIVE:
+        return eval_native(blk, signal_map, options->jit_cache_dir);
+    case EVAL_MODE_BYTECODE:
+        return eval_bytecode(blk, signal_map);
+    case EVAL_MODE_SWEEP:
+    default:
+        return eval_sweep(blk, signal_map);
+    }
+}
+
+int eval(Block *blk, SignalMap *signal_map)
+{
+    return eval_with_options(blk, signal_map, NULL);
+}
+
+int parse_eval_mode(const char *name, EvalMode *out)
+{
+    if (!name || !out)
+        return -1;
+
+    if (strcmp(name, "sweep") == 0)
+        *out = EVAL_MODE_SWEEP;
+    else if (strcmp(name, "event") == 0)
+        *out = EVAL_MODE_EVENT;
+    else if (strcmp(name, "levelized") == 0)
+        *out = EVAL_MODE_LEVELIZED;
+    else if (strcmp(name, "parallel") == 0)
+        *out = EVAL_MODE_PARALLEL;
+    else if (strcmp(name, "native") == 0)
+        *out = EVAL_MODE_NATIVE;
+    else if (strcmp(name, "bytecode") == 0)
+        *out = EVAL_MODE_BYTECODE;
+    else
+        return -1;
+
+    return 0;
+}
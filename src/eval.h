@@ -9,7 +9,32 @@
 #include <netinet/in.h> // For in6_addr
 #define SAFETY_GUARD
 
+typedef enum {
+    EVAL_MODE_SWEEP,  // Re-evaluate every instance each round, up to MAX_ITERATIONS rounds
+    EVAL_MODE_EVENT,  // Worklist: re-evaluate only the readers of signals that were written
+    EVAL_MODE_LEVELIZED, // Static schedule: each level once, feedback loops until stable
+    EVAL_MODE_PARALLEL, // Levelized, with the instances of a level spread over a thread pool
+    EVAL_MODE_NATIVE,   // Levelized schedule compiled to C and loaded with dlopen (see jit.h)
+    EVAL_MODE_BYTECODE  // Levelized schedule compiled for the in-process VM (see bytecode.h)
+} EvalMode;
+
+typedef struct EvalOptions {
+    EvalMode mode;
+    size_t threads;   // EVAL_MODE_PARALLEL only; 0 → one per online CPU
+    const char *jit_cache_dir; // EVAL_MODE_NATIVE only; where generated .c/.so files live (NULL → see jit.h)
+    int poll_budget_ms; // Longest wait for bus traffic after each pass; 0 → never block
+} EvalOptions;
 
 int eval(Block *blk, SignalMap *signal_map);
+int eval_with_options(Block *blk, SignalMap *signal_map, const EvalOptions *options);
+int parse_eval_mode(const char *name, EvalMode *out);
+
+// Times parallel passes at 1, 2, 4, ... max_threads threads (0 → online CPUs),
+// restoring the signal map before each, and logs time, speedup and efficiency
+int eval_bench_threads(Block *blk, SignalMap *signal_map, size_t max_threads);
+
+// Times a levelized pass over the Instance graph and over the Netlist arrays,
+// with cache-miss counts where perf_event_open is permitted
+int eval_bench_layout(Block *blk, SignalMap *signal_map);
 
 #endif
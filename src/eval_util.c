@@ -4,6 +4,7 @@
 #include "block.h"
 #include "instance.h"
 #include "invocation.h"
+#include "body_template.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -14,78 +15,7 @@
 
 Definition *find_definition_by_name(Block *blk, const char *name)
 {
-    if (!blk || !name)
-        return NULL;
-
-    for (Definition *def = blk->definitions; def != NULL; def = def->next)
-    {
-        if (def->name && strcmp(def->name, name) == 0)
-        {
-            return def;
-        }
-    }
-
-    return NULL; // Not found
-}
-
-
-
-int expand_embedded_invocations(Block *blk, Instance *parent_instance, SignalMap *signal_map)
-{
-    if (!parent_instance || !parent_instance->definition)
-        return 0;
-
-    BodyItem *body = parent_instance->definition->body;
-    size_t sub_index = 0;
-    int added = 0;
-
-    while (body)
-    {
-        if (body->type == BODY_INVOCATION)
-        {
-            Invocation *sub_inv = body->data.invocation;
-
-            sub_inv->instance_id = sub_index;
-
-            Definition *sub_def = find_definition_by_name(blk, sub_inv->target_name);
-            if (!sub_def)
-            {
-                LOG_WARN("⚠️ No definition for nested invocation %s", sub_inv->target_name);
-                body = body->next;
-                continue;
-            }
-
-            // 👍 Correct create_instance call
-            Instance *sub_instance = create_instance(
-                sub_inv->target_name,   // def_name
-                sub_index,              // instance_id
-                sub_def,                // definition
-                sub_inv,                // invocation
-                parent_instance->name , // parent prefix
-                signal_map
-            );
-
-            if (!sub_instance)
-            {
-                LOG_ERROR("❌ Failed to create nested instance: %s.%s.%zu",
-                          parent_instance->name, sub_inv->target_name, sub_index);
-                body = body->next;
-                continue;
-            }
-
-            // All input rewrites are no longer needed here if qualify_* handled them
-            block_add_instance(blk, sub_instance);
-            LOG_INFO("🧩 Created embedded instance: %s (target=%s)", sub_instance->name, sub_inv->target_name);
-
-            // Recurse
-            added += 1 + expand_embedded_invocations(blk, sub_instance, signal_map);
-        }
-
-        body = body->next;
-        sub_index++;
-    }
-
-    return added;
+    return block_find_definition(blk, name); // Hashed once block_index_definitions has run
 }
 
 
@@ -100,16 +30,17 @@ void publish_all_literal_bindings(Block *blk, SignalMap *signal_map)
     for (InstanceList *node = blk->instances; node; node = node->next)
     {
         Instance *inst = node->instance;
-        if (!inst || !inst->invocation || !inst->invocation->literal_bindings)
+        if (!inst || !inst->invocation)
             continue;
 
-        for (size_t i = 0; i < inst->invocation->literal_bindings->count; ++i)
+        for (size_t i = 0; i < inst->literal_count; ++i)
         {
-            LiteralBinding *b = &inst->invocation->literal_bindings->items[i];
-            if (b->name && b->value)
+            const LiteralBinding *b = &inst->invocation->literal_bindings->items[i];
+            SignalId id = inst->literal_ids[i];
+            if (id != SIGNAL_ID_NONE && b->value)
             {
-                update_signal_value(signal_map, b->name, b->value);
-                LOG_INFO("📥 Published literal binding: %s = %s", b->name, b->value);
+                signal_map_set(signal_map, id, b->value);
+                LOG_INFO("📥 Published literal binding: %s = %s", signal_map_name(signal_map, id), b->value);
             }
         }
     }
@@ -127,12 +58,18 @@ void unify_invocations(Block *blk, SignalMap *signal_map)
     size_t count = 0;
     size_t embedded_count = 0;
 
+    // Each Definition body is bound once; nested instances are stamped out from it
+    BodyTemplates *templates = create_body_templates(blk, signal_map);
+    if (!templates)
+    {
+        LOG_ERROR("❌ Failed to allocate body templates");
+        return;
+    }
+
     for (Invocation *inv = blk->invocations; inv; inv = inv->next)
     {
         // Find matching definition
-        Definition *def = blk->definitions;
-        while (def && strcmp(def->name, inv->target_name) != 0)
-            def = def->next;
+        Definition *def = find_definition_by_name(blk, inv->target_name);
 
         if (!def)
         {
@@ -147,7 +84,8 @@ void unify_invocations(Block *blk, SignalMap *signal_map)
             def,                  // definition
             inv,                  // invocation
             NULL ,                // parent_prefix
-            signal_map
+            signal_map,
+            blk->arena
         );
 
         if (!instance)
@@ -159,9 +97,9 @@ void unify_invocations(Block *blk, SignalMap *signal_map)
         block_add_instance(blk, instance);
         count++;
 
-        size_t added = expand_embedded_invocations(blk, instance, signal_map);
-        embedded_count += added;
+        embedded_count += instantiate_body(templates, instance);
     }
+    destroy_body_templates(templates);
 
     LOG_INFO("✅ Built %zu instance(s)", count + embedded_count);
 }
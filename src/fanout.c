@@ -0,0 +1,127 @@
+#include "fanout.h"
+#include "log.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Collects the distinct signals an instance reads (inputs + template args)
+static size_t instance_reads(const Instance *inst, SignalId *out)
+{
+    size_t n = 0;
+    const SignalId *lists[2] = {inst->input_ids, inst->pattern_ids};
+    const size_t counts[2] = {inst->input_count, inst->pattern_count};
+
+    for (int l = 0; l < 2; ++l)
+    {
+        for (size_t i = 0; i < counts[l]; ++i)
+        {
+            SignalId id = lists[l][i];
+            bool seen = false;
+            for (size_t j = 0; j < n && !seen; ++j)
+                seen = out[j] == id;
+            if (!seen && id != SIGNAL_ID_NONE)
+                out[n++] = id;
+        }
+    }
+    return n;
+}
+
+FanoutIndex *build_fanout_index(Block *blk, SignalMap *signal_map)
+{
+    FanoutIndex *index = calloc(1, sizeof(FanoutIndex));
+    if (!index)
+        return NULL;
+
+    for (InstanceList *node = blk->instances; node; node = node->next)
+        index->instance_count++;
+
+    index->signal_count = signal_map->count;
+    index->instances = malloc(sizeof(Instance *) * (index->instance_count ? index->instance_count : 1));
+    index->offsets = calloc(index->signal_count + 1, sizeof(uint32_t));
+    if (!index->instances || !index->offsets)
+    {
+        destroy_fanout_index(index);
+        return NULL;
+    }
+
+    size_t max_reads = 0;
+    size_t ordinal = 0;
+    for (InstanceList *node = blk->instances; node; node = node->next)
+    {
+        Instance *inst = node->instance;
+        index->instances[ordinal++] = inst;
+        if (inst && inst->input_count + inst->pattern_count > max_reads)
+            max_reads = inst->input_count + inst->pattern_count;
+    }
+
+    SignalId *reads = malloc(sizeof(SignalId) * (max_reads ? max_reads : 1));
+    if (!reads)
+    {
+        destroy_fanout_index(index);
+        return NULL;
+    }
+
+    // Pass 1: count readers per signal
+    for (size_t i = 0; i < index->instance_count; ++i)
+    {
+        if (!index->instances[i])
+            continue;
+        size_t n = instance_reads(index->instances[i], reads);
+        for (size_t r = 0; r < n; ++r)
+            if (reads[r] < index->signal_count)
+                index->offsets[reads[r] + 1]++;
+    }
+
+    for (size_t s = 0; s < index->signal_count; ++s)
+        index->offsets[s + 1] += index->offsets[s];
+
+    index->readers = malloc(sizeof(uint32_t) * (index->offsets[index->signal_count] ? index->offsets[index->signal_count] : 1));
+    uint32_t *cursor = malloc(sizeof(uint32_t) * (index->signal_count ? index->signal_count : 1));
+    if (!index->readers || !cursor)
+    {
+        free(cursor);
+        free(reads);
+        destroy_fanout_index(index);
+        return NULL;
+    }
+    memcpy(cursor, index->offsets, sizeof(uint32_t) * index->signal_count);
+
+    // Pass 2: fill
+    for (size_t i = 0; i < index->instance_count; ++i)
+    {
+        if (!index->instances[i])
+            continue;
+        size_t n = instance_reads(index->instances[i], reads);
+        for (size_t r = 0; r < n; ++r)
+            if (reads[r] < index->signal_count)
+                index->readers[cursor[reads[r]]++] = (uint32_t)i;
+    }
+
+    free(cursor);
+    free(reads);
+
+    LOG_INFO("🕸️  Fan-out index: %zu instance(s), %zu signal(s), %u edge(s)",
+             index->instance_count, index->signal_count, index->offsets[index->signal_count]);
+    return index;
+}
+
+const uint32_t *fanout_readers(const FanoutIndex *index, SignalId id, size_t *count)
+{
+    if (!index || id >= index->signal_count)
+    {
+        *count = 0;
+        return NULL;
+    }
+    *count = index->offsets[id + 1] - index->offsets[id];
+    return &index->readers[index->offsets[id]];
+}
+
+void destroy_fanout_index(FanoutIndex *index)
+{
+    if (!index)
+        return;
+    free(index->instances);
+    free(index->offsets);
+    free(index->readers);
+    free(index);
+}
@@ -0,0 +1,23 @@
+#ifndef FANOUT_H
+#define FANOUT_H
+#include "block.h"
+#include "signal_map.h"
+#include <stdint.h>
+
+// Reverse index: SignalId → ordinals of the instances that read it.
+// Stored CSR-style so a signal's readers are one contiguous slice.
+typedef struct FanoutIndex {
+    Instance **instances;     // Instance ordinal → Instance (block list order)
+    size_t instance_count;
+    size_t signal_count;      // Signals interned when the index was built
+    uint32_t *offsets;        // signal_count + 1 entries into readers
+    uint32_t *readers;        // Instance ordinals
+} FanoutIndex;
+
+FanoutIndex *build_fanout_index(Block *blk, SignalMap *signal_map);
+void destroy_fanout_index(FanoutIndex *index);
+
+// Readers of a signal; *count is 0 for signals interned after the build
+const uint32_t *fanout_readers(const FanoutIndex *index, SignalId id, size_t *count);
+
+#endif
@@ -4,3 +4,70 @@
 #include <string.h>
 #include "gap.h"  // Assumes GAPPacket and related defs are here
 
+
+static const char *batch_text(const GAPSignalBatch *batch)
+{
+    return (const char *)&batch->updates[batch->count];
+}
+
+static int is_bit_value(const char *value)
+{
+    return (value[0] == '0' || value[0] == '1') && value[1] == '\0';
+}
+
+size_t gap_value_text_len(const char *value)
+{
+    return is_bit_value(value) ? 0 : strlen(value) + 1;
+}
+
+size_t gap_signal_batch_size(size_t count, size_t text_len)
+{
+    return sizeof(GAPSignalBatch) + count * sizeof(GAPSignalUpdate) + text_len;
+}
+
+void gap_encode_signal_batch(GAPSignalBatch *batch, uint64_t signal_table, const GAPUpdateValue *values,
+                             size_t count)
+{
+    batch->signal_table = signal_table;
+    batch->count = (uint32_t)count;
+    char *text = (char *)&batch->updates[count];
+    uint32_t offset = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const char *value = values[i].value;
+        batch->updates[i].id = values[i].id;
+        if (is_bit_value(value))
+        {
+            batch->updates[i].value = (uint32_t)(value[0] - '0');
+            continue;
+        }
+        size_t len = strlen(value) + 1;
+        memcpy(text + offset, value, len);
+        batch->updates[i].value = GAP_VALUE_TEXT | offset;
+        offset += (uint32_t)len;
+    }
+    batch->text_len = offset;
+}
+
+const GAPSignalBatch *gap_signal_batch(const GAPPacket *packet)
+{
+    if (!packet || packet->type != GAP_SIGNAL_BATCH || packet->payload_len < sizeof(GAPSignalBatch))
+        return NULL;
+
+    const GAPSignalBatch *batch = (const GAPSignalBatch *)packet->payload;
+    size_t needed = sizeof(GAPSignalBatch) + (size_t)batch->count * sizeof(GAPSignalUpdate) + batch->text_len;
+    if (needed > packet->payload_len)
+        return NULL;
+    if (batch->text_len > 0 && batch_text(batch)[batch->text_len - 1] != '\0')
+        return NULL; // Last value would run off the end
+    return batch;
+}
+
+const char *gap_update_value(const GAPSignalBatch *batch, const GAPSignalUpdate *update)
+{
+    if (!(update->value & GAP_VALUE_TEXT))
+        return update->value ? "1" : "0";
+
+    uint32_t offset = update->value & ~GAP_VALUE_TEXT;
+    return offset < batch->text_len ? batch_text(batch) + offset : NULL;
+}
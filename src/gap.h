@@ -8,6 +8,7 @@ typedef enum {
     GAP_INVOKE    = 0,  // Used for sending an evaluation request
     GAP_RESPONSE  = 1,  // Used to reply to an invocation
     GAP_SIGNAL    = 2,  // Direct signal propagation (e.g., OUT<1>
+    GAP_SIGNAL_BATCH = 3, // One eval round of signal updates (GAPSignalBatch)
 } GAPPacketType;
 
 typedef struct {
@@ -21,6 +22,43 @@ typedef struct {
     uint8_t payload[];         // Encoded S-expression or binary
 } __attribute__((aligned)) GAPPacket;
 
+// GAP_SIGNAL_BATCH payload: fixed-size updates, then the NUL-terminated
+// text of any value that is not a single bit. Ids are SignalIds of the
+// publishing node's signal map, which signal_table identifies; a receiver
+// whose own signal_map_fingerprint differs must not apply them.
+#define GAP_VALUE_TEXT 0x80000000u // Update value flag: low bits are an offset into the text
+
+typedef struct {
+    uint32_t id;
+    uint32_t value;            // 0 or 1, or GAP_VALUE_TEXT | text offset
+} GAPSignalUpdate;
+
+typedef struct {
+    uint64_t signal_table;     // signal_map_fingerprint of the sender's map
+    uint32_t count;
+    uint32_t text_len;
+    GAPSignalUpdate updates[]; // count of them, followed by text_len bytes of text
+} GAPSignalBatch;
+
+// One update to encode; values other than "0" and "1" are copied into the text
+typedef struct {
+    uint32_t id;
+    const char *value;
+} GAPUpdateValue;
+
+// Text bytes value takes in a batch: 0 for a bit, else its length with the NUL
+size_t gap_value_text_len(const char *value);
+// Payload bytes of a batch of count updates with text_len bytes of text
+size_t gap_signal_batch_size(size_t count, size_t text_len);
+// Encodes in place; batch must hold gap_signal_batch_size(count, the values' text_len) bytes
+void gap_encode_signal_batch(GAPSignalBatch *batch, uint64_t signal_table, const GAPUpdateValue *values,
+                             size_t count);
+
+// The batch inside packet, or NULL if it is another type or does not fit payload_len
+const GAPSignalBatch *gap_signal_batch(const GAPPacket *packet);
+// Points into the batch (or a static "0"/"1"); NULL for a bad text offset
+const char *gap_update_value(const GAPSignalBatch *batch, const GAPSignalUpdate *update);
+
 typedef struct {
     struct in6_addr addr;
     psi128_t psi;
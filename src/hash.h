@@ -0,0 +1,30 @@
+#ifndef HASH_H
+#define HASH_H
+#include <stdint.h>
+#include <stddef.h>
+
+// FNV-1a: short dotted signal names hash well and it needs no setup
+
+static inline uint32_t hash_bytes(const char *s, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; ++i)
+    {
+        h ^= (uint8_t)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static inline uint32_t hash_string(const char *s)
+{
+    uint32_t h = 2166136261u;
+    while (*s)
+    {
+        h ^= (uint8_t)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+#endif
@@ -1,182 +1,135 @@
 #include "instance.h"
 #include "invocation.h"
 #include "eval_util.h"
-#include "rewrite_util.h"
+#include "intern.h"
 #include "log.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-void qualify_invocation_signals(Invocation *inv, const char *instance_name)
+/**
+ * Bind a template signal name to this instance: names that are already
+ * qualified (contain a '.') pass through, everything else gets the
+ * instance name as prefix.
+ */
+static SignalId bind_qualified(SignalMap *signal_map, const char *instance_name, const char *name)
 {
-    if (!inv || !instance_name)
-        return;
-
-    // Inputs
-    for (size_t i = 0; i < string_list_count(inv->input_signals); ++i)
-    {
-        const char *old = string_list_get_by_index(inv->input_signals, i);
-        if (!old)
-            continue;
-
-        if (strchr(old, '.'))
-            continue;
+    if (!name)
+        return SIGNAL_ID_NONE;
 
-        char qualified[256];
-        snprintf(qualified, sizeof(qualified), "%s.%s", instance_name, old);
-        string_list_set_by_index(inv->input_signals, i, strdup(qualified));
-    }
-
-    // Outputs
-    for (size_t i = 0; i < string_list_count(inv->output_signals); ++i)
-    {
-        const char *old = string_list_get_by_index(inv->output_signals, i);
-        if (!old)
-            continue;
+    if (strchr(name, '.'))
+        return signal_map_intern(signal_map, name);
 
-        if (strchr(old, '.'))
-            continue;
-
-        char qualified[256];
-        snprintf(qualified, sizeof(qualified), "%s.%s", instance_name, old);
-        string_list_set_by_index(inv->output_signals, i, strdup(qualified));
-    }
-
-    // Literal bindings
-    if (inv->literal_bindings)
-    {
-        for (size_t i = 0; i < inv->literal_bindings->count; ++i)
-        {
-            LiteralBinding *bind = &inv->literal_bindings->items[i];
-            if (!bind || !bind->name)
-                continue;
-
-            if (strchr(bind->name, '.'))
-                continue;
-
-            char qualified[256];
-            snprintf(qualified, sizeof(qualified), "%s.%s", instance_name, bind->name);
+    char qualified[256];
+    snprintf(qualified, sizeof(qualified), "%s.%s", instance_name, name);
+    return signal_map_intern(signal_map, qualified);
+}
 
-            free(bind->name);
-            bind->name = strdup(qualified);
-        }
-    }
+static size_t binding_count(const Invocation *inv)
+{
+    return inv->literal_bindings ? inv->literal_bindings->count : 0;
 }
 
 /**
- * Qualify all signal names in the given Definition with a unique prefix.
+ * Resolve every port of the instance to a SignalId.
  *
- * - Inputs and outputs are prefixed with the instance name if not already qualified.
- * This ensures that all signals are globally unique and correctly mapped to external inputs.
+ * Definition inputs take the invocation's (qualified) inputs by position,
+ * and template args naming a definition input follow it to the same signal.
+ * The conditional output is left unqualified, so instances that share an
+ * output name drive the same signal.
  */
-void qualify_definition_signals(Definition *def, const char *instance_name)
+static int bind_instance_ports(Instance *instance, SignalMap *signal_map, Arena *arena)
 {
-    if (!def || !instance_name)
-        return;
-
-    // Inputs
-    for (size_t i = 0; i < string_list_count(def->input_signals); ++i)
-    {
-        const char *name = string_list_get_by_index(def->input_signals, i);
-        if (!name)
-            continue;
-
-        if (strchr(name, '.'))
-        {
-            LOG_INFO("✅ Input signal already qualified, left unchanged: %s", name);
-            continue;
-        }
-
-        char buf[256];
-        snprintf(buf, sizeof(buf), "%s.%s", instance_name, name);
-        string_list_set_by_index(def->input_signals, i, strdup(buf));
-        LOG_INFO("🔁 Definition input signal qualified: %s → %s", name, buf);
-    }
-
-    // Outputs
-    for (size_t i = 0; i < string_list_count(def->output_signals); ++i)
+    const Definition *def = instance->definition;
+    const Invocation *inv = instance->invocation;
+    const ConditionalInvocation *ci = def->conditional_invocation;
+
+    instance->input_count = string_list_count(inv->input_signals);
+    instance->output_count = string_list_count(inv->output_signals);
+    instance->literal_count = binding_count(inv);
+    instance->def_input_count = string_list_count(def->input_signals);
+    instance->def_output_count = string_list_count(def->output_signals);
+    instance->pattern_count = ci ? string_list_count(ci->pattern_args) : 0;
+
+    instance->port_count = instance->input_count + instance->output_count + instance->literal_count +
+                           instance->def_input_count + instance->def_output_count + instance->pattern_count;
+    instance->ports = arena_alloc(arena, sizeof(SignalId) * (instance->port_count ? instance->port_count : 1));
+    if (!instance->ports)
+        return -1;
+
+    SignalId *cursor = instance->ports;
+    instance->input_ids = cursor;
+    cursor += instance->input_count;
+    instance->output_ids = cursor;
+    cursor += instance->output_count;
+    instance->literal_ids = cursor;
+    cursor += instance->literal_count;
+    instance->def_input_ids = cursor;
+    cursor += instance->def_input_count;
+    instance->def_output_ids = cursor;
+    cursor += instance->def_output_count;
+    instance->pattern_ids = cursor;
+
+    for (size_t i = 0; i < instance->input_count; ++i)
+        instance->input_ids[i] = bind_qualified(signal_map, instance->name, string_list_get(inv->input_signals, i));
+
+    for (size_t i = 0; i < instance->output_count; ++i)
+        instance->output_ids[i] = bind_qualified(signal_map, instance->name, string_list_get(inv->output_signals, i));
+
+    for (size_t i = 0; i < instance->literal_count; ++i)
+        instance->literal_ids[i] = bind_qualified(signal_map, instance->name, inv->literal_bindings->items[i].name);
+
+    for (size_t i = 0; i < instance->def_input_count; ++i)
     {
-        const char *name = string_list_get_by_index(def->output_signals, i);
-        if (!name)
-            continue;
-
-        if (strchr(name, '.'))
+        if (i < instance->input_count)
         {
-            LOG_INFO("✅ Output signal already qualified, left unchanged: %s", name);
-            continue;
-        }
-
-        char buf[256];
-        snprintf(buf, sizeof(buf), "%s.%s", instance_name, name);
-        string_list_set_by_index(def->output_signals, i, strdup(buf));
-        LOG_INFO("🔁 Definition output signal qualified: %s → %s", name, buf);
-    }
-}
-
-void remap_definition_inputs_to_invocation(Definition *def, Invocation *inv)
-{
-    if (!def || !inv)
-        return;
-
-    size_t n_inputs = string_list_count(def->input_signals);
-
-    // Save old input signals to compare
-    StringList *old_inputs = string_list_clone(def->input_signals);
-
-    for (size_t i = 0; i < n_inputs; ++i)
-    {
-        const char *qualified_inv_signal = string_list_get_by_index(inv->input_signals, i);
-        if (qualified_inv_signal)
-        {
-            string_list_set_by_index(def->input_signals, i, strdup(qualified_inv_signal));
-            LOG_INFO("🔁 Remapped definition input[%zu]: → %s", i, qualified_inv_signal);
+            instance->def_input_ids[i] = instance->input_ids[i];
+            LOG_INFO("🔁 Remapped definition input[%zu]: → %s", i, signal_map_name(signal_map, instance->input_ids[i]));
         }
         else
         {
             LOG_WARN("⚠️ Invocation input[%zu] missing while remapping definition input", i);
+            instance->def_input_ids[i] = bind_qualified(signal_map, instance->name, string_list_get(def->input_signals, i));
         }
     }
 
-    // Also remap ConditionalInvocation pattern args
-    if (def->conditional_invocation && def->conditional_invocation->pattern_args)
+    for (size_t i = 0; i < instance->def_output_count; ++i)
+        instance->def_output_ids[i] = bind_qualified(signal_map, instance->name, string_list_get(def->output_signals, i));
+
+    for (size_t i = 0; i < instance->pattern_count; ++i)
     {
-        for (size_t i = 0; i < string_list_count(def->conditional_invocation->pattern_args); ++i)
-        {
-            const char *arg = string_list_get_by_index(def->conditional_invocation->pattern_args, i);
-            if (!arg)
-                continue;
+        const char *arg = string_list_get(ci->pattern_args, i);
+        SignalId id = SIGNAL_ID_NONE;
 
-            bool remapped = false;
-            // Compare against old input names
-            for (size_t j = 0; j < n_inputs; ++j)
+        // Interned names: a template arg naming a definition input is the same pointer
+        for (size_t j = 0; j < instance->def_input_count && j < instance->input_count; ++j)
+        {
+            if (string_list_get(def->input_signals, j) == arg)
             {
-                const char *old_input = string_list_get_by_index(old_inputs, j);
-                if (old_input && strcmp(arg, old_input) == 0)
-                {
-                    const char *new_signal = string_list_get_by_index(inv->input_signals, j);
-                    if (new_signal)
-                    {
-                        string_list_set_by_index(def->conditional_invocation->pattern_args, i, strdup(new_signal));
-                        LOG_INFO("🔁 CI pattern arg remapped: %s → %s", arg, new_signal);
-                        remapped = true;
-                        break;
-                    }
-                }
+                id = instance->input_ids[j];
+                LOG_INFO("🔁 CI pattern arg remapped: %s → %s", arg, signal_map_name(signal_map, id));
+                break;
             }
+        }
 
-            if (!remapped)
-            {
-                LOG_INFO("✅ CI pattern arg left unchanged: %s", arg);
-            }
+        if (id == SIGNAL_ID_NONE)
+        {
+            LOG_INFO("✅ CI pattern arg left unchanged: %s", arg);
+            id = signal_map_intern(signal_map, arg);
         }
+        instance->pattern_ids[i] = id;
     }
 
-    destroy_string_list(old_inputs);
+    instance->output_id = ci ? signal_map_intern(signal_map, ci->output) : SIGNAL_ID_NONE;
+    return 0;
 }
 
-Instance *create_instance(const char *def_name, int instance_id, Definition *def, Invocation *inv, const char *parent_prefix, SignalMap *signal_map)
+Instance *create_instance(const char *def_name, int instance_id, const Definition *def, const Invocation *inv, const char *parent_prefix, SignalMap *signal_map, Arena *arena)
 {
-    Instance *instance = malloc(sizeof(Instance));
+    if (!def || !inv || !signal_map)
+        return NULL;
+
+    Instance *instance = arena_calloc(arena, 1, sizeof(Instance));
     if (!instance)
         return NULL;
 
@@ -190,93 +143,18 @@ Instance *create_instance(const char *def_name, int instance_id, Definition *def
     {
         snprintf(buf, sizeof(buf), "INV.%s.%d", def_name, instance_id);
     }
-    instance->name = strdup(buf);
+    instance->name = intern(buf);
 
-    // Clone definition and invocation
-    instance->invocation = clone_invocation(inv);
-    // Rewrite invocation signals to be fully qualified
-    qualify_invocation_signals(instance->invocation, instance->name);
+    // Share the template; only the port bindings are per instance
+    instance->definition = def;
+    instance->invocation = inv;
 
-    instance->definition = clone_definition(def);
-    remap_definition_inputs_to_invocation(instance->definition, instance->invocation);
-
-    // Rewrite definition signals to be fully qualified
-    qualify_definition_signals(instance->definition, instance->name);
-
-    dump_literal_bindings(instance->invocation);
-
-    return instance;
-}
-
-void destroy_instance(Instance *inst)
-{
-    if (!inst)
-        return;
-
-    // Free Invocation
-    if (inst->invocation)
+    if (bind_instance_ports(instance, signal_map, arena) != 0)
     {
-        if (inst->invocation->input_signals)
-            destroy_string_list(inst->invocation->input_signals);
-        if (inst->invocation->output_signals)
-            destroy_string_list(inst->invocation->output_signals);
-        if (inst->invocation->literal_bindings)
-        {
-            free(inst->invocation->literal_bindings->items);
-            free(inst->invocation->literal_bindings);
-        }
-        free(inst->invocation->target_name);
-        free(inst->invocation);
-    }
-
-    // Free Definition
-    if (inst->definition)
-    {
-        if (inst->definition->input_signals)
-            destroy_string_list(inst->definition->input_signals);
-        if (inst->definition->output_signals)
-            destroy_string_list(inst->definition->output_signals);
-
-        // Free ConditionalInvocation
-        if (inst->definition->conditional_invocation)
-        {
-            ConditionalInvocation *ci = inst->definition->conditional_invocation;
-            destroy_string_list(ci->pattern_args);
-            free(ci->output);
-            free(ci->cases);
-            free(ci);
-        }
-
-        // Free Body items
-        BodyItem *item = inst->definition->body;
-        while (item)
-        {
-            BodyItem *next_item = item->next;
-            if (item->type == BODY_SIGNAL_INPUT || item->type == BODY_SIGNAL_OUTPUT)
-                free(item->data.signal_name);
-            // Note: BODY_INVOCATION embedded instances are expanded elsewhere, no free here.
-            free(item);
-            item = next_item;
-        }
-
-        free(inst->definition->name);
-        free(inst->definition->origin_sexpr_path);
-        free(inst->definition->sexpr_logic);
-        free(inst->definition);
+        LOG_ERROR("❌ Failed to bind ports for instance %s", instance->name);
+        arena_free(arena, instance);
+        return NULL;
     }
 
-    free(inst->name);
-    free(inst);
-}
-
-void free_instance_list(InstanceList *list)
-{
-    while (list)
-    {
-        InstanceList *next = list->next;
-        if (list->instance)
-            destroy_instance(list->instance);
-        free(list);
-        list = next;
-    }
+    return instance;
 }
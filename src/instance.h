@@ -2,11 +2,32 @@
 #define INSTANCE_H
 #include "invocation.h"
 #include "signal_map.h"
+#include "arena.h"
 
+// An instance is a flyweight: the Definition and the source Invocation are
+// shared by every instance of the same template and never modified. All that
+// is per-instance is the name and the qualified signal bound to each port.
 typedef struct Instance {
-   char *name;
-   Definition *definition;
-   Invocation *invocation;
+   const char *name;                // Interned
+   const Definition *definition;    // Shared, owned by the Block
+   const Invocation *invocation;    // Shared, owned by the Block (or a Definition body)
+
+   // Port bindings, one allocation; the ranges below point into `ports`
+   SignalId *ports;
+   size_t port_count;
+   SignalId *input_ids;      // invocation->input_signals
+   size_t input_count;
+   SignalId *output_ids;     // invocation->output_signals
+   size_t output_count;
+   SignalId *literal_ids;    // invocation->literal_bindings, by index
+   size_t literal_count;
+   SignalId *def_input_ids;  // definition->input_signals
+   size_t def_input_count;
+   SignalId *def_output_ids; // definition->output_signals
+   size_t def_output_count;
+   SignalId *pattern_ids;    // conditional_invocation->pattern_args
+   size_t pattern_count;
+   SignalId output_id;       // conditional_invocation->output
 } Instance;
 
 typedef struct InstanceList {
@@ -15,8 +36,7 @@ typedef struct InstanceList {
 }  InstanceList;
 
 
-Instance *create_instance(const char *def_name, int instance_id, Definition *def, Invocation *inv, const char *parent_prefix, SignalMap* signal_map);
-
-void destroy_instance(Instance *inst);
+// Allocated from arena (normally the Block's netlist arena) and released with it
+Instance *create_instance(const char *def_name, int instance_id, const Definition *def, const Invocation *inv, const char *parent_prefix, SignalMap* signal_map, Arena *arena);
 
 #endif
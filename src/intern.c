@@ -0,0 +1,184 @@
+#include "intern.h"
+#include "hash.h"
+#include "log.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INTERN_CHUNK_SIZE (64 * 1024)
+#define INTERN_INITIAL_SLOTS 1024
+#define INTERN_JOIN_BUFFER 512 // intern_join falls back to the heap above this
+
+// Strings are bump-allocated into chunks that are never moved or freed,
+// which is what keeps interned pointers stable.
+typedef struct InternChunk {
+    struct InternChunk *next;
+    size_t used;
+    size_t size;
+    char data[];
+} InternChunk;
+
+static InternChunk *chunks = NULL;
+static const char **slots = NULL;   // Open addressing; NULL = empty
+static size_t slot_count = 0;
+static size_t string_count = 0;
+static size_t string_bytes = 0;
+
+// Held for every probe/insert; the parse workers intern concurrently
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static char *pool_alloc(size_t len)
+{
+    // Header (hash, length) + text + NUL, rounded up to keep headers aligned
+    size_t need = (2 * sizeof(uint32_t) + len + 1 + 3) & ~(size_t)3;
+
+    if (!chunks || chunks->size - chunks->used < need)
+    {
+        size_t size = need > INTERN_CHUNK_SIZE ? need : INTERN_CHUNK_SIZE;
+        InternChunk *chunk = malloc(sizeof(InternChunk) + size);
+        if (!chunk)
+            return NULL;
+        chunk->next = chunks;
+        chunk->used = 0;
+        chunk->size = size;
+        chunks = chunk;
+    }
+
+    char *p = chunks->data + chunks->used;
+    chunks->used += need;
+    string_bytes += need;
+    return p;
+}
+
+static size_t probe(const char *s, size_t len, uint32_t hash)
+{
+    size_t mask = slot_count - 1;
+    size_t slot = hash & mask;
+    while (slots[slot])
+    {
+        const char *cur = slots[slot];
+        if (intern_hash(cur) == hash && intern_length(cur) == len && memcmp(cur, s, len) == 0)
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static int grow(void)
+{
+    size_t new_count = slot_count ? slot_count * 2 : INTERN_INITIAL_SLOTS;
+    const char **new_slots = calloc(new_count, sizeof(const char *));
+    if (!new_slots)
+        return -1;
+
+    size_t mask = new_count - 1;
+    for (size_t i = 0; i < slot_count; ++i)
+    {
+        if (!slots[i])
+            continue;
+        size_t slot = intern_hash(slots[i]) & mask;
+        while (new_slots[slot])
+            slot = (slot + 1) & mask;
+        new_slots[slot] = slots[i];
+    }
+
+    free(slots);
+    slots = new_slots;
+    slot_count = new_count;
+    return 0;
+}
+
+static const char *intern_locked(const char *s, size_t len, uint32_t hash)
+{
+    if ((string_count + 1) * 2 > slot_count && grow() != 0)
+    {
+        LOG_ERROR("❌ Intern pool: failed to grow index");
+        return NULL;
+    }
+
+    size_t slot = probe(s, len, hash);
+    if (slots[slot])
+        return slots[slot];
+
+    char *p = pool_alloc(len);
+    if (!p)
+    {
+        LOG_ERROR("❌ Intern pool: out of memory");
+        return NULL;
+    }
+
+    uint32_t header[2] = {hash, (uint32_t)len};
+    memcpy(p, header, sizeof(header));
+    char *text = p + sizeof(header);
+    memcpy(text, s, len);
+    text[len] = '\0';
+
+    slots[slot] = text;
+    string_count++;
+    return text;
+}
+
+const char *intern_n(const char *s, size_t len)
+{
+    if (!s)
+        return NULL;
+
+    uint32_t hash = hash_bytes(s, len); // outside the lock
+    pthread_mutex_lock(&pool_lock);
+    const char *text = intern_locked(s, len, hash);
+    pthread_mutex_unlock(&pool_lock);
+    return text;
+}
+
+const char *intern(const char *s)
+{
+    return s ? intern_n(s, strlen(s)) : NULL;
+}
+
+const char *intern_join(const char *prefix, char sep, const char *suffix)
+{
+    if (!prefix || !suffix)
+        return NULL;
+
+    size_t prefix_len = intern_length(prefix), suffix_len = intern_length(suffix);
+    size_t len = prefix_len + 1 + suffix_len;
+    char stack_buf[INTERN_JOIN_BUFFER];
+    char *buf = len < sizeof(stack_buf) ? stack_buf : malloc(len + 1);
+    if (!buf)
+        return NULL;
+
+    memcpy(buf, prefix, prefix_len);
+    buf[prefix_len] = sep;
+    memcpy(buf + prefix_len + 1, suffix, suffix_len);
+    const char *text = intern_n(buf, len);
+    if (buf != stack_buf)
+        free(buf);
+    return text;
+}
+
+const char *intern_lookup(const char *s)
+{
+    return s ? intern_lookup_n(s, strlen(s)) : NULL;
+}
+
+const char *intern_lookup_n(const char *s, size_t len)
+{
+    if (!s)
+        return NULL;
+
+    uint32_t hash = hash_bytes(s, len);
+    pthread_mutex_lock(&pool_lock);
+    const char *text = slot_count ? slots[probe(s, len, hash)] : NULL;
+    pthread_mutex_unlock(&pool_lock);
+    return text;
+}
+
+size_t intern_pool_count(void)
+{
+    return string_count;
+}
+
+size_t intern_pool_bytes(void)
+{
+    return string_bytes;
+}
@@ -0,0 +1,31 @@
+#ifndef INTERN_H
+#define INTERN_H
+#include <stddef.h>
+#include <stdint.h>
+
+// Process-wide pool of immutable, NUL-terminated strings. Interning the same
+// text twice yields the same pointer, so interned names compare with ==.
+// Pointers stay valid for the life of the process. Safe to call from
+// several threads (the pool is guarded by a mutex).
+
+const char *intern(const char *s);                  // NULL → NULL
+const char *intern_n(const char *s, size_t len);    // s need not be NUL-terminated
+const char *intern_lookup(const char *s);           // NULL if never interned; never inserts
+const char *intern_lookup_n(const char *s, size_t len);
+const char *intern_join(const char *prefix, char sep, const char *suffix); // Both interned; e.g. "a" '.' "b" → "a.b"
+
+size_t intern_pool_count(void);
+size_t intern_pool_bytes(void);
+
+// Each pooled string is preceded by its hash and length
+static inline uint32_t intern_hash(const char *interned)
+{
+    return ((const uint32_t *)(const void *)interned)[-2];
+}
+
+static inline size_t intern_length(const char *interned)
+{
+    return ((const uint32_t *)(const void *)interned)[-1];
+}
+
+#endif
@@ -1,13 +1,15 @@
 #include "block.h"
 #include "invocation.h"
+#include "truth_table.h"
+#include "intern.h"
 #include <stdlib.h>
 
 Definition *create_definition(const char *name, const char *sexpr_path, const char *logic) {
     Definition *def = malloc(sizeof(Definition));
     if (!def) return NULL;
 
-    def->name = strdup(name);
-    def->origin_sexpr_path = sexpr_path ? strdup(sexpr_path) : NULL;
+    def->name = intern(name);
+    def->origin_sexpr_path = intern(sexpr_path);
     def->sexpr_logic = logic ? strdup(logic) : NULL;
 
     def->input_signals = create_string_list();
@@ -23,8 +25,9 @@ Definition *clone_definition(const Definition *src) {
     Definition *def = malloc(sizeof(Definition));
     if (!def) return NULL;
 
-    def->name = src->name ? strdup(src->name) : NULL;
-    def->origin_sexpr_path = src->origin_sexpr_path ? strdup(src->origin_sexpr_path) : NULL;
+    // Names are interned, so clones share them
+    def->name = src->name;
+    def->origin_sexpr_path = src->origin_sexpr_path;
     def->sexpr_logic = src->sexpr_logic ? strdup(src->sexpr_logic) : NULL;
 
     def->input_signals = string_list_clone(src->input_signals);
@@ -38,7 +41,7 @@ Definition *clone_definition(const Definition *src) {
         item->next = NULL;
 
         if (cur->type == BODY_SIGNAL_INPUT || cur->type == BODY_SIGNAL_OUTPUT) {
-            item->data.signal_name = cur->data.signal_name ? strdup(cur->data.signal_name) : NULL;
+            item->data.signal_name = cur->data.signal_name;
         } else if (cur->type == BODY_INVOCATION) {
             item->data.invocation = malloc(sizeof(Invocation));
             memcpy(item->data.invocation, cur->data.invocation, sizeof(Invocation));
@@ -53,18 +56,16 @@ Definition *clone_definition(const Definition *src) {
         ConditionalInvocation *ci = malloc(sizeof(ConditionalInvocation));
         ci->arg_count = src_ci->arg_count;
         ci->pattern_args = string_list_clone(src_ci->pattern_args);
-        ci->output = src_ci->output ? strdup(src_ci->output) : NULL;
+        ci->output = src_ci->output;
 
         ci->case_count = src_ci->case_count;
         if (ci->case_count > 0) {
             ci->cases = calloc(ci->case_count, sizeof(ConditionalCase));
-            for (size_t i = 0; i < ci->case_count; ++i) {
-                ci->cases[i].pattern = strdup(src_ci->cases[i].pattern);
-                ci->cases[i].result = strdup(src_ci->cases[i].result);
-            }
+            memcpy(ci->cases, src_ci->cases, ci->case_count * sizeof(ConditionalCase));
         } else {
             ci->cases = NULL;
         }
+        ci->truth_table = src_ci->truth_table ? compile_truth_table(ci, NULL) : NULL;
 
         def->conditional_invocation = ci;
     } else {
@@ -78,8 +79,6 @@ Definition *clone_definition(const Definition *src) {
 void destroy_definition(Definition *def) {
     if (!def) return;
 
-    free(def->name);
-    free(def->origin_sexpr_path);
     free(def->sexpr_logic);
 
     destroy_string_list(def->input_signals);
@@ -89,9 +88,7 @@ void destroy_definition(Definition *def) {
     while (cur) {
         BodyItem *next = cur->next;
 
-        if (cur->type == BODY_SIGNAL_INPUT || cur->type == BODY_SIGNAL_OUTPUT) {
-            free(cur->data.signal_name);
-        } else if (cur->type == BODY_INVOCATION) {
+        if (cur->type == BODY_INVOCATION) {
             destroy_invocation(cur->data.invocation);
         }
 
@@ -103,14 +100,8 @@ void destroy_definition(Definition *def) {
         ConditionalInvocation *ci = def->conditional_invocation;
 
         destroy_string_list(ci->pattern_args);
-        free(ci->output);
-
-        for (size_t i = 0; i < ci->case_count; ++i) {
-            free(ci->cases[i].pattern);
-            free(ci->cases[i].result);
-        }
-
         free(ci->cases);
+        destroy_truth_table(ci->truth_table);
         free(ci);
     }
 
@@ -121,7 +112,7 @@ Invocation *create_invocation(const char *target_name, psi128_t psi, psi128_t to
     Invocation *inv = malloc(sizeof(Invocation));
     if (!inv) return NULL;
 
-    inv->target_name = strdup(target_name);
+    inv->target_name = intern(target_name);
     inv->psi = psi;
     inv->to = to;
 
@@ -137,7 +128,9 @@ Invocation *clone_invocation(const Invocation *src) {
     Invocation *inv = malloc(sizeof(Invocation));
     if (!inv) return NULL;
 
-    inv->target_name = src->target_name ? strdup(src->target_name) : NULL;
+    inv->target_name = src->target_name;
+    inv->origin_sexpr_path = src->origin_sexpr_path;
+    inv->instance_id = src->instance_id;
     inv->psi = src->psi;
     inv->to = src->to;
 
@@ -149,10 +142,8 @@ Invocation *clone_invocation(const Invocation *src) {
         inv->literal_bindings->count = src->literal_bindings->count;
         inv->literal_bindings->items = malloc(sizeof(LiteralBinding) * inv->literal_bindings->count);
 
-        for (size_t i = 0; i < inv->literal_bindings->count; ++i) {
-            inv->literal_bindings->items[i].name = strdup(src->literal_bindings->items[i].name);
-            inv->literal_bindings->items[i].value = strdup(src->literal_bindings->items[i].value);
-        }
+        memcpy(inv->literal_bindings->items, src->literal_bindings->items,
+               sizeof(LiteralBinding) * inv->literal_bindings->count);
     } else {
         inv->literal_bindings = NULL;
     }
@@ -164,16 +155,10 @@ Invocation *clone_invocation(const Invocation *src) {
 void destroy_invocation(Invocation *inv) {
     if (!inv) return;
 
-    free(inv->target_name);
-
     destroy_string_list(inv->input_signals);
     destroy_string_list(inv->output_signals);
 
     if (inv->literal_bindings) {
-        for (size_t i = 0; i < inv->literal_bindings->count; ++i) {
-            free(inv->literal_bindings->items[i].name);
-            free(inv->literal_bindings->items[i].value);
-        }
         free(inv->literal_bindings->items);
         free(inv->literal_bindings);
     }
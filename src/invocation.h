@@ -7,9 +7,10 @@
 
 typedef struct in6_addr  psi128_t;
 
+// Interned (see intern.h); not owned
 typedef struct {
-    char *name;
-    char *value;
+    const char *name;
+    const char *value;
 } LiteralBinding;
 
 typedef struct {
@@ -20,8 +21,8 @@ typedef struct {
 
 typedef struct Invocation
 {
-    char *target_name;
-    char* origin_sexpr_path;
+    const char *target_name;       // Interned
+    const char *origin_sexpr_path; // Interned
     int instance_id;
     psi128_t psi;
     psi128_t to;                // target block psi
@@ -34,17 +35,20 @@ typedef struct Invocation
 
 typedef struct
 {
-    char *pattern;
-    char *result;
+    const char *pattern;  // Interned
+    const char *result;   // Interned
 } ConditionalCase;
 
+struct TruthTable;
+
 typedef struct ConditionalInvocation
 {
     StringList *pattern_args;         // Array of input names like ["A", "B"]
     size_t arg_count;            // Number of pattern arguments
-    char *output;                // Output signal name
+    const char *output;          // Output signal name (interned)
     ConditionalCase *cases;      // Case list for pattern → result
     size_t case_count;           // Number of conditional cases
+    struct TruthTable *truth_table; // Compiled at instance creation; NULL → string matching
 } ConditionalInvocation;
 
 
@@ -57,7 +61,7 @@ typedef enum {
 typedef struct BodyItem {
     BodyItemType type;
     union {
-        char *signal_name;       // For input/output signals
+        const char *signal_name; // For input/output signals (interned)
         Invocation *invocation;  // For invocations
     } data;
     struct BodyItem *next;
@@ -65,8 +69,8 @@ typedef struct BodyItem {
 
 typedef struct Definition
 {
-    char *name;                  // e.g., "AND", "XOR"
-    char *origin_sexpr_path;     // Path to original S-expression source
+    const char *name;              // e.g., "AND", "XOR" (interned)
+    const char *origin_sexpr_path; // Path to original S-expression source (interned)
     char *sexpr_logic;           // The actual logic (e.g., (COND ...))
     StringList *input_signals;   // Ordered signal names used as inputs
     StringList *output_signals; // Ordered set of output signal names
@@ -0,0 +1,516 @@
+#define _POSIX_C_SOURCE 200809L // open_memstream, clock_gettime
+#include "jit.h"
+#include "build_cache.h"
+#include "emit_util.h"
+#include "log.h"
+#include "pubsub.h"
+#include "truth_table.h"
+#include <dlfcn.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define JIT_ENTRY_SYMBOL "rc_jit_eval"
+#define JIT_COUNT_SYMBOL "rc_jit_signal_count"
+
+// Same cap as MAX_ITERATIONS in eval.c
+#define JIT_LOOP_ROUNDS 5
+
+// Written into generated truth tables for "no Case matches this row"
+#define JIT_NO_CASE 0xFF
+
+// Straight-line code is split into non-inlined functions of at most this
+// many gates. Compile time grows faster than linearly with function size.
+#define JIT_GATES_PER_FUNCTION 32
+
+// Part of the cache key along with $CC, so changing either rebuilds
+#define JIT_CFLAGS "-O2 -shared -fPIC"
+
+typedef void (*JitEntry)(uint8_t *state);
+
+struct JitModule {
+    void *handle;
+    JitEntry entry;
+    size_t signal_count;    // Signals the code was generated for
+    uint8_t *published;     // By SignalId: 1 for instance outputs (published), 0 for literals
+    uint8_t *state;         // Scratch copy of the bit array
+};
+
+typedef struct TableRef {
+    const ConditionalInvocation *ci;
+    uint32_t row;
+} TableRef;
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+}
+
+static int single_bit(const char *value)
+{
+    if (value && (value[0] == '0' || value[0] == '1') && value[1] == '\0')
+        return value[0] - '0';
+    return -1;
+}
+
+static bool id_valid(SignalId id, size_t signal_count)
+{
+    return id != SIGNAL_ID_NONE && id < signal_count;
+}
+
+// Whether the row can ever write its output (see eval_instance)
+static bool row_fires(const Netlist *net, uint32_t row, size_t signal_count)
+{
+    if (!(net->flags[row] & NETLIST_ROW_LOGIC) || !id_valid(net->output_slot[row], signal_count))
+        return false;
+    for (uint32_t p = net->port_first[row]; p < net->port_first[row + 1]; ++p)
+        if (!id_valid(net->ports[p], signal_count))
+            return false;
+    return true;
+}
+
+static int check_row(const Netlist *net, uint32_t row)
+{
+    for (uint32_t l = net->literal_first[row]; l < net->literal_first[row + 1]; ++l)
+    {
+        if (single_bit(net->literal_values[l]) < 0)
+        {
+            LOG_WARN("⚠️ JIT: %s literal %u is not a single bit", net->names[row], l - net->literal_first[row]);
+            return -1;
+        }
+    }
+
+    if (!(net->flags[row] & NETLIST_ROW_LOGIC))
+        return 0;
+    const ConditionalInvocation *ci = net->logic[net->def_index[row]];
+    uint32_t pattern_count;
+    netlist_patterns(net, row, &pattern_count);
+    if (!ci->truth_table || ci->arg_count != pattern_count)
+    {
+        LOG_WARN("⚠️ JIT: %s has no truth table", net->names[row]);
+        return -1;
+    }
+    for (size_t c = 0; c < ci->case_count; ++c)
+    {
+        if (single_bit(ci->cases[c].result) < 0)
+        {
+            LOG_WARN("⚠️ JIT: %s case %zu result is not a single bit", net->names[row], c);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int table_value(const ConditionalInvocation *ci, size_t row)
+{
+    uint16_t c = truth_table_lookup(ci->truth_table, (uint32_t)row);
+    return c == TRUTH_TABLE_NO_CASE ? -1 : single_bit(ci->cases[c].result);
+}
+
+// Orders by table contents, so identical tables from different Definitions end up adjacent
+static int compare_tables(const ConditionalInvocation *x, const ConditionalInvocation *y)
+{
+    if (x == y)
+        return 0;
+    if (x->arg_count != y->arg_count)
+        return x->arg_count < y->arg_count ? -1 : 1;
+    for (size_t row = 0; row < ((size_t)1 << x->arg_count); ++row)
+    {
+        int a = table_value(x, row), b = table_value(y, row);
+        if (a != b)
+            return a < b ? -1 : 1;
+    }
+    return 0;
+}
+
+static int compare_table_refs(const void *a, const void *b)
+{
+    const TableRef *x = a, *y = b;
+    int order = compare_tables(x->ci, y->ci);
+    if (order != 0)
+        return order;
+    return x->row < y->row ? -1 : (x->row > y->row);
+}
+
+// Instance names go into C comments; keep them to a safe alphabet
+static void emit_comment_name(FILE *out, const char *name)
+{
+    for (const char *p = name ? name : "(null)"; *p; ++p)
+        fputc((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z') || (*p >= '0' && *p <= '9') || *p == '.' || *p == '_' ? *p : '?', out);
+}
+
+static void emit_gate(FILE *out, const Netlist *net, uint32_t row, uint32_t table, size_t signal_count, bool in_loop)
+{
+    const char *indent = in_loop ? "        " : "    ";
+
+    fprintf(out, "%s/* ", indent);
+    emit_comment_name(out, net->names[row]);
+    fprintf(out, " */\n");
+
+    for (uint32_t l = net->literal_first[row]; l < net->literal_first[row + 1]; ++l)
+        if (id_valid(net->literal_slots[l], signal_count))
+            fprintf(out, "%ss[%u] = %d;\n", indent, net->literal_slots[l], single_bit(net->literal_values[l]));
+
+    if (!row_fires(net, row, signal_count))
+        return;
+
+    uint32_t input_count, pattern_count;
+    const SignalId *inputs = netlist_inputs(net, row, &input_count);
+    const SignalId *patterns = netlist_patterns(net, row, &pattern_count);
+    SignalId output = net->output_slot[row];
+
+    // Ready: every input driven and every template arg a single bit (which implies driven)
+    fprintf(out, "%sif (", indent);
+    for (uint32_t i = 0; i < input_count; ++i)
+    {
+        bool is_pattern = false;
+        for (uint32_t j = 0; j < pattern_count && !is_pattern; ++j)
+            is_pattern = patterns[j] == inputs[i];
+        if (!is_pattern)
+            fprintf(out, "s[%u] != U && ", inputs[i]);
+    }
+    for (uint32_t j = 0; j < pattern_count; ++j)
+        fprintf(out, "s[%u] <= 1%s", patterns[j], j + 1 < pattern_count ? " && " : "");
+    fprintf(out, ") {\n%s    v = T%u[", indent, table);
+    for (uint32_t j = 0; j < pattern_count; ++j)
+    {
+        uint32_t shift = pattern_count - 1 - j;
+        if (shift)
+            fprintf(out, "s[%u] << %u | ", patterns[j], shift);
+        else
+            fprintf(out, "s[%u]", patterns[j]);
+    }
+    fprintf(out, "];\n");
+    if (in_loop)
+        fprintf(out, "%s    if (v != NC && s[%u] != v) { s[%u] = v; changed = 1; }\n", indent, output, output);
+    else
+        fprintf(out, "%s    if (v != NC) s[%u] = v;\n", indent, output);
+    fprintf(out, "%s}\n", indent);
+}
+
+static int generate_source(const Schedule *schedule, const Netlist *net, size_t signal_count, char **source, size_t *length)
+{
+    size_t n = net->row_count;
+    TableRef *refs = malloc(sizeof(TableRef) * (n ? n : 1));
+    uint32_t *table_of = malloc(sizeof(uint32_t) * (n ? n : 1));
+    FILE *out = open_memstream(source, length);
+    if (!refs || !table_of || !out)
+    {
+        free(refs);
+        free(table_of);
+        if (out)
+            fclose(out);
+        return -1;
+    }
+
+    fprintf(out, "/* Generated by rcnode from %zu instance(s) in %zu level(s). Do not edit. */\n", n, schedule->level_count);
+    fprintf(out, "#include <stdint.h>\n\n#define U 0x%02X\n#define NC 0x%02X\n\n", SIGNAL_BIT_UNSET, JIT_NO_CASE);
+    fprintf(out, "#if defined(__GNUC__)\n#define SLICE static __attribute__((noinline)) void\n#else\n#define SLICE static void\n#endif\n\n");
+    fprintf(out, "const uint32_t %s = %zu;\n\n", JIT_COUNT_SYMBOL, signal_count);
+
+    // One table per distinct ConditionalInvocation (rows share their Definition's)
+    size_t ref_count = 0;
+    for (uint32_t r = 0; r < n; ++r)
+        if (row_fires(net, r, signal_count))
+            refs[ref_count++] = (TableRef){net->logic[net->def_index[r]], r};
+    qsort(refs, ref_count, sizeof(TableRef), compare_table_refs);
+
+    uint32_t table_count = 0;
+    for (size_t r = 0; r < ref_count; ++r)
+    {
+        if (r == 0 || compare_tables(refs[r].ci, refs[r - 1].ci) != 0)
+        {
+            const ConditionalInvocation *ci = refs[r].ci;
+            size_t rows = (size_t)1 << ci->arg_count;
+            fprintf(out, "static const uint8_t T%u[%zu] = {", table_count, rows);
+            for (size_t row = 0; row < rows; ++row)
+            {
+                int bit = table_value(ci, row);
+                fprintf(out, "%s%s", row ? ", " : "", bit < 0 ? "NC" : bit ? "1" : "0");
+            }
+            fprintf(out, "};\n");
+            table_count++;
+        }
+        table_of[refs[r].row] = table_count - 1;
+    }
+
+    // F<k> covers a slice of one step: a static step is cut every
+    // JIT_GATES_PER_FUNCTION gates, a feedback loop stays in one function
+    uint32_t function_count = 0;
+    for (size_t k = 0; k < schedule->step_count; ++k)
+    {
+        const ScheduleStep *step = &schedule->steps[k];
+        uint32_t slice = step->iterative ? step->count : JIT_GATES_PER_FUNCTION;
+        for (uint32_t first = step->first; first < step->first + step->count; first += slice)
+        {
+            uint32_t end = step->first + step->count - first > slice ? first + slice : step->first + step->count;
+            fprintf(out, "\n/* level %u%s */\nSLICE F%u(uint8_t *restrict s)\n{\n    uint8_t v;\n    (void)v;\n",
+                    step->level, step->iterative ? ", feedback loop" : "", function_count++);
+            if (step->iterative)
+                fprintf(out, "    for (int round = 0; round < %d; ++round) {\n        uint8_t changed = 0;\n", JIT_LOOP_ROUNDS);
+
+            for (uint32_t i = first; i < end; ++i)
+                emit_gate(out, net, i, table_of[i], signal_count, step->iterative);
+
+            if (step->iterative)
+                fprintf(out, "        if (!changed)\n            break;\n    }\n");
+            fprintf(out, "}\n");
+        }
+    }
+
+    fprintf(out, "\nvoid %s(uint8_t *restrict s)\n{\n", JIT_ENTRY_SYMBOL);
+    for (uint32_t f = 0; f < function_count; ++f)
+        fprintf(out, "    F%u(s);\n", f);
+    fprintf(out, "}\n");
+
+    free(refs);
+    free(table_of);
+    return fclose(out) == 0 ? 0 : -1;
+}
+
+static int write_file(const char *path, const char *data, size_t length)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+        return -1;
+    size_t written = fwrite(data, 1, length, f);
+    return fclose(f) == 0 && written == length ? 0 : -1;
+}
+
+static const char *jit_compiler(void)
+{
+    const char *cc = getenv("CC");
+    return cc && *cc ? cc : "cc";
+}
+
+// $XDG_CACHE_HOME/rcnode/jit, else ~/.cache/rcnode/jit; never a shared directory like /tmp
+static int default_cache_dir(char *out, size_t size)
+{
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    int len = -1;
+    if (xdg && xdg[0] == '/')
+        len = snprintf(out, size, "%s/rcnode/jit", xdg);
+    else if (home && home[0] == '/')
+        len = snprintf(out, size, "%s/.cache/rcnode/jit", home);
+    return len > 0 && (size_t)len < size ? 0 : -1;
+}
+
+// Anyone who can write here can get code loaded into this process
+static bool private_to_us(const struct stat *st)
+{
+    return st->st_uid == geteuid() && !(st->st_mode & (S_IWGRP | S_IWOTH));
+}
+
+// Creates dir 0700 if needed; fails unless it is a real directory of ours that nobody else can write
+static int ensure_private_dir(const char *dir)
+{
+    if (mkdir(dir, 0700) != 0 && errno == ENOENT)
+    {
+        if (mkdir_p(dir) != 0)
+            return -1;
+        chmod(dir, 0700); // mkdir_p uses 0755
+    }
+
+    struct stat st;
+    if (lstat(dir, &st) != 0 || !S_ISDIR(st.st_mode))
+        return -1;
+    if (st.st_uid != geteuid())
+        return -1;
+    if (!private_to_us(&st) && (chmod(dir, 0700) != 0 || lstat(dir, &st) != 0 || !private_to_us(&st)))
+        return -1;
+    return 0;
+}
+
+static int build_shared_object(const char *cc, const char *source_path, const char *so_path)
+{
+    // Quoted for /bin/sh; the paths are ours, but the cache dir may not be
+    if (strchr(source_path, '\'') || strchr(so_path, '\'') || strchr(cc, '\''))
+    {
+        LOG_ERROR("❌ JIT: refusing to quote a path containing '");
+        return -1;
+    }
+
+    char tmp_path[1024 + 64], command[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%ld.tmp", so_path, (long)getpid());
+    int len = snprintf(command, sizeof(command), "'%s' " JIT_CFLAGS " -o '%s' '%s' 2>'%s.log'",
+                       cc, tmp_path, source_path, so_path);
+    if (len < 0 || (size_t)len >= sizeof(command))
+        return -1;
+
+    int status = system(command);
+    if (status != 0)
+    {
+        LOG_ERROR("❌ JIT: '%s' failed (status %d), see %s.log", cc, status, so_path);
+        unlink(tmp_path);
+        return -1;
+    }
+
+    // Whole file or nothing, so a concurrent run never loads a partial .so
+    if (rename(tmp_path, so_path) != 0)
+    {
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+JitModule *jit_compile(const Schedule *schedule, const Netlist *net, const SignalMap *signal_map, const char *cache_dir)
+{
+    if (!schedule || !net || !signal_map)
+        return NULL;
+
+    char default_dir[1024];
+    if (!cache_dir)
+    {
+        if (default_cache_dir(default_dir, sizeof(default_dir)) != 0)
+        {
+            LOG_WARN("⚠️ JIT: no private cache directory (set XDG_CACHE_HOME or HOME, or pass --jit-cache)");
+            return NULL;
+        }
+        cache_dir = default_dir;
+    }
+
+    size_t signal_count = signal_map->count;
+    for (uint32_t r = 0; r < net->row_count; ++r)
+        if (check_row(net, r) != 0)
+            return NULL;
+
+    double start = now_ms();
+    char *source = NULL;
+    size_t length = 0;
+    if (generate_source(schedule, net, signal_count, &source, &length) != 0)
+    {
+        LOG_ERROR("❌ JIT: failed to generate source");
+        free(source);
+        return NULL;
+    }
+
+    BuildCacheKey key;
+    unsigned char digest[BUILD_CACHE_KEY_SIZE];
+    if (build_cache_key_begin(&key) != 0)
+    {
+        free(source);
+        return NULL;
+    }
+    const char *cc = jit_compiler();
+    build_cache_key_add(&key, cc);
+    build_cache_key_add(&key, JIT_CFLAGS);
+    build_cache_key_add(&key, source);
+    if (build_cache_key_finish(&key, digest) != 0)
+    {
+        free(source);
+        return NULL;
+    }
+
+    char hex[2 * BUILD_CACHE_KEY_SIZE + 1];
+    for (size_t i = 0; i < BUILD_CACHE_KEY_SIZE; ++i)
+        snprintf(hex + 2 * i, 3, "%02x", digest[i]);
+
+    char source_path[1024 + 32], so_path[1024 + 32]; // Room for the directory plus the rcjit-<hash> name
+    snprintf(source_path, sizeof(source_path), "%s/rcjit-%.16s.c", cache_dir, hex);
+    snprintf(so_path, sizeof(so_path), "%s/rcjit-%.16s.so", cache_dir, hex);
+
+    if (ensure_private_dir(cache_dir) != 0)
+    {
+        LOG_ERROR("❌ JIT: %s is not a private directory owned by this user; not loading native code from it", cache_dir);
+        free(source);
+        return NULL;
+    }
+
+    struct stat st;
+    bool cached = lstat(so_path, &st) == 0;
+    if (cached && (!S_ISREG(st.st_mode) || !private_to_us(&st)))
+    {
+        LOG_ERROR("❌ JIT: %s is not a regular file written by this user; refusing to load it", so_path);
+        free(source);
+        return NULL;
+    }
+    if (!cached)
+    {
+        if (write_file(source_path, source, length) != 0 || build_shared_object(cc, source_path, so_path) != 0)
+        {
+            free(source);
+            return NULL;
+        }
+    }
+    free(source);
+
+    JitModule *jit = calloc(1, sizeof(JitModule));
+    if (!jit)
+        return NULL;
+
+    jit->handle = dlopen(so_path, RTLD_NOW | RTLD_LOCAL);
+    if (!jit->handle)
+    {
+        LOG_ERROR("❌ JIT: dlopen %s: %s", so_path, dlerror());
+        jit_release(jit);
+        return NULL;
+    }
+
+    // Casting through a union: ISO C has no object-to-function pointer conversion
+    union { void *object; JitEntry function; } symbol;
+    symbol.object = dlsym(jit->handle, JIT_ENTRY_SYMBOL);
+    jit->entry = symbol.function;
+    const uint32_t *count = dlsym(jit->handle, JIT_COUNT_SYMBOL);
+    if (!jit->entry || !count || *count != signal_count)
+    {
+        LOG_ERROR("❌ JIT: %s does not match this netlist", so_path);
+        jit_release(jit);
+        return NULL;
+    }
+
+    jit->signal_count = signal_count;
+    jit->published = calloc(signal_count ? signal_count : 1, 1);
+    jit->state = malloc(signal_count ? signal_count : 1);
+    if (!jit->published || !jit->state)
+    {
+        jit_release(jit);
+        return NULL;
+    }
+    for (uint32_t r = 0; r < net->row_count; ++r)
+        if (row_fires(net, r, signal_count))
+            jit->published[net->output_slot[r]] = 1;
+
+    if (cached)
+        LOG_INFO("♻️ JIT: reusing %s", so_path);
+    else
+        LOG_INFO("⚙️ JIT: compiled %zu instance(s) to %s in %.1f ms", schedule->instance_count, so_path, now_ms() - start);
+    return jit;
+}
+
+void jit_release(JitModule *jit)
+{
+    if (!jit)
+        return;
+    if (jit->handle)
+        dlclose(jit->handle);
+    free(jit->published);
+    free(jit->state);
+    free(jit);
+}
+
+int jit_eval(JitModule *jit, SignalMap *signal_map)
+{
+    if (!jit || !signal_map || signal_map->count < jit->signal_count)
+        return -1;
+
+    // The generated tables only know 0 and 1; a wide value needs the string matcher
+    for (size_t id = 0; id < jit->signal_count; ++id)
+        if (signal_map->bits[id] == SIGNAL_BIT_WIDE)
+            return -1;
+
+    memcpy(jit->state, signal_map->bits, jit->signal_count);
+    jit->entry(jit->state);
+
+    // Bring the strings and subscribers up to date with the final bits
+    return publish_bit_changes(signal_map, jit->state, jit->published, jit->signal_count);
+}
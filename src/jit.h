@@ -0,0 +1,28 @@
+#ifndef JIT_H
+#define JIT_H
+#include "netlist.h"
+#include "schedule.h"
+#include "signal_map.h"
+
+// Native backend: the levelized schedule is lowered to one straight-line C
+// function over the SignalMap's bit array (0, 1 or SIGNAL_BIT_UNSET per
+// signal). It is built with the system C compiler ($CC, default cc) as a
+// shared object and loaded with dlopen. Artifacts are named by the SHA-256
+// of the compiler, its flags and the generated source, so an unchanged
+// netlist reuses its .so. The cache directory must belong to this user and
+// be closed to writes by anyone else; it is created 0700.
+
+typedef struct JitModule JitModule;
+
+// cache_dir NULL → $XDG_CACHE_HOME/rcnode/jit or ~/.cache/rcnode/jit.
+// NULL if some instance has no bitwise form, the compiler fails or the cache
+// directory is not private; the caller then stays on the interpreter.
+JitModule *jit_compile(const Schedule *schedule, const Netlist *net, const SignalMap *signal_map, const char *cache_dir);
+void jit_release(JitModule *jit);
+
+// One evaluation pass, publishing changed outputs like eval_instance does.
+// Returns the number of changed outputs, or -1 if the current signal values
+// are outside what the native code handles (wide values); nothing is written then.
+int jit_eval(JitModule *jit, SignalMap *signal_map);
+
+#endif
@@ -0,0 +1,291 @@
+#include "liveness.h"
+#include "log.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct LiveState {
+    SignalMap *signal_map;
+    Instance **insts;         // Block list order
+    size_t instance_count;
+    uint32_t *writer_offsets; // CSR: signal → ordinals of the instances that write it
+    uint32_t *writers;
+    uint8_t *live_signal;     // By SignalId
+    bool *live_instance;      // By ordinal
+    SignalId *queue;          // Live signals whose writers are not visited yet
+    size_t queue_len;
+    size_t roots;
+} LiveState;
+
+static bool id_valid(const LiveState *st, SignalId id)
+{
+    return id != SIGNAL_ID_NONE && id < st->signal_map->count;
+}
+
+// Same condition as eval: only a gate with inputs ever drives its output
+static bool writes_output(const Instance *inst)
+{
+    const ConditionalInvocation *ci = inst->definition ? inst->definition->conditional_invocation : NULL;
+    return ci && ci->pattern_args && ci->arg_count > 0 && ci->output && inst->input_count > 0 &&
+           inst->output_id != SIGNAL_ID_NONE;
+}
+
+static bool writes_literal(const Instance *inst, size_t l)
+{
+    const LiteralBindingList *list = inst->invocation ? inst->invocation->literal_bindings : NULL;
+    return list && l < list->count && list->items[l].value && inst->literal_ids[l] != SIGNAL_ID_NONE;
+}
+
+static void mark_signal(LiveState *st, SignalId id)
+{
+    if (!id_valid(st, id) || st->live_signal[id])
+        return;
+    st->live_signal[id] = 1;
+    st->queue[st->queue_len++] = id; // Each signal is queued at most once
+}
+
+static void mark_root(LiveState *st, SignalId id)
+{
+    if (id_valid(st, id) && !st->live_signal[id])
+        st->roots++;
+    mark_signal(st, id);
+}
+
+static void mark_instance(LiveState *st, size_t ordinal)
+{
+    if (st->live_instance[ordinal])
+        return;
+    st->live_instance[ordinal] = true;
+
+    const Instance *inst = st->insts[ordinal];
+    for (size_t i = 0; i < inst->input_count; ++i)
+        mark_signal(st, inst->input_ids[i]);
+    for (size_t j = 0; j < inst->pattern_count; ++j)
+        mark_signal(st, inst->pattern_ids[j]);
+}
+
+static int build_writers(LiveState *st)
+{
+    size_t signal_count = st->signal_map->count;
+    st->writer_offsets = calloc(signal_count + 1, sizeof(uint32_t));
+    if (!st->writer_offsets)
+        return -1;
+
+    // Count into offsets[id + 1], prefix-sum, then fill through a copy of the offsets
+    for (size_t i = 0; i < st->instance_count; ++i)
+    {
+        const Instance *inst = st->insts[i];
+        if (writes_output(inst) && id_valid(st, inst->output_id))
+            st->writer_offsets[inst->output_id + 1]++;
+        for (size_t l = 0; l < inst->literal_count; ++l)
+            if (writes_literal(inst, l) && id_valid(st, inst->literal_ids[l]))
+                st->writer_offsets[inst->literal_ids[l] + 1]++;
+    }
+    for (size_t id = 0; id < signal_count; ++id)
+        st->writer_offsets[id + 1] += st->writer_offsets[id];
+
+    st->writers = malloc(sizeof(uint32_t) * (st->writer_offsets[signal_count] ? st->writer_offsets[signal_count] : 1));
+    uint32_t *cursor = malloc(sizeof(uint32_t) * (signal_count ? signal_count : 1));
+    if (!st->writers || !cursor)
+    {
+        free(cursor);
+        return -1;
+    }
+    memcpy(cursor, st->writer_offsets, sizeof(uint32_t) * signal_count);
+
+    for (size_t i = 0; i < st->instance_count; ++i)
+    {
+        const Instance *inst = st->insts[i];
+        if (writes_output(inst) && id_valid(st, inst->output_id))
+            st->writers[cursor[inst->output_id]++] = (uint32_t)i;
+        for (size_t l = 0; l < inst->literal_count; ++l)
+            if (writes_literal(inst, l) && id_valid(st, inst->literal_ids[l]))
+                st->writers[cursor[inst->literal_ids[l]]++] = (uint32_t)i;
+    }
+    free(cursor);
+    return 0;
+}
+
+static int compare_ptr(const void *a, const void *b)
+{
+    const void *x = *(const void *const *)a, *y = *(const void *const *)b;
+    return x < y ? -1 : x > y;
+}
+
+// Unqualified outputs are global names: look them up, never intern new ones
+static void mark_named_roots(LiveState *st, const StringList *names)
+{
+    for (size_t k = 0; k < string_list_count(names); ++k)
+        mark_root(st, signal_map_find(st->signal_map, string_list_get(names, k)));
+}
+
+/**
+ * Top-level instances are the block's interface: they stay, and their
+ * invocation and definition outputs are what the outside world observes.
+ */
+static int mark_observed(LiveState *st, Block *blk)
+{
+    size_t top_count = 0;
+    for (Invocation *inv = blk->invocations; inv; inv = inv->next)
+        top_count++;
+    const Invocation **top = malloc(sizeof(Invocation *) * (top_count ? top_count : 1));
+    if (!top)
+        return -1;
+    size_t k = 0;
+    for (Invocation *inv = blk->invocations; inv; inv = inv->next)
+        top[k++] = inv;
+    qsort(top, top_count, sizeof(Invocation *), compare_ptr);
+
+    for (size_t i = 0; i < st->instance_count; ++i)
+    {
+        const Instance *inst = st->insts[i];
+        if (!bsearch(&inst->invocation, top, top_count, sizeof(Invocation *), compare_ptr))
+            continue;
+
+        for (size_t o = 0; o < inst->output_count; ++o)
+            mark_root(st, inst->output_ids[o]);
+        for (size_t o = 0; o < inst->def_output_count; ++o)
+            mark_root(st, inst->def_output_ids[o]);
+        if (writes_output(inst))
+            mark_root(st, inst->output_id);
+        mark_named_roots(st, inst->invocation->output_signals);
+        mark_named_roots(st, inst->definition->output_signals);
+        mark_instance(st, i);
+    }
+    free(top);
+    return 0;
+}
+
+static void walk(LiveState *st)
+{
+    // The queue only grows, so a plain cursor visits every live signal once
+    for (size_t q = 0; q < st->queue_len; ++q)
+    {
+        SignalId id = st->queue[q];
+        for (uint32_t w = st->writer_offsets[id]; w < st->writer_offsets[id + 1]; ++w)
+            mark_instance(st, st->writers[w]);
+    }
+}
+
+static void keep_ports(uint8_t *keep, const Instance *inst)
+{
+    for (size_t p = 0; p < inst->port_count; ++p)
+        if (inst->ports[p] != SIGNAL_ID_NONE)
+            keep[inst->ports[p]] = 1;
+    if (inst->output_id != SIGNAL_ID_NONE)
+        keep[inst->output_id] = 1;
+}
+
+static void remap_ports(Instance *inst, const SignalId *remap)
+{
+    for (size_t p = 0; p < inst->port_count; ++p)
+        if (inst->ports[p] != SIGNAL_ID_NONE)
+            inst->ports[p] = remap[inst->ports[p]];
+    if (inst->output_id != SIGNAL_ID_NONE)
+        inst->output_id = remap[inst->output_id];
+}
+
+int trim_unobserved(Block *blk, SignalMap *signal_map, LivenessReport *report)
+{
+    if (!blk || !signal_map || !report)
+        return -1;
+    memset(report, 0, sizeof(*report));
+
+    size_t n = 0;
+    for (InstanceList *node = blk->instances; node; node = node->next)
+        if (node->instance)
+            n++;
+
+    size_t signal_count = signal_map->count;
+    LiveState st = {0};
+    st.signal_map = signal_map;
+    st.instance_count = n;
+    st.insts = malloc(sizeof(Instance *) * (n ? n : 1));
+    st.live_signal = calloc(signal_count ? signal_count : 1, sizeof(uint8_t));
+    st.live_instance = calloc(n ? n : 1, sizeof(bool));
+    st.queue = malloc(sizeof(SignalId) * (signal_count ? signal_count : 1));
+    uint8_t *keep = NULL;
+    SignalId *remap = NULL;
+    int status = 0;
+    if (!st.insts || !st.live_signal || !st.live_instance || !st.queue)
+    {
+        status = -1;
+        goto done;
+    }
+
+    size_t i = 0;
+    for (InstanceList *node = blk->instances; node; node = node->next)
+        if (node->instance)
+            st.insts[i++] = node->instance;
+
+    if (build_writers(&st) != 0 || mark_observed(&st, blk) != 0)
+    {
+        status = -1;
+        goto done;
+    }
+
+    report->roots = st.roots;
+    report->instance_count = n;
+    report->signal_count = signal_count;
+    if (st.roots == 0)
+    {
+        LOG_WARN("⚠️ Liveness: no observed outputs; keeping all %zu instance(s)", n);
+        goto done;
+    }
+
+    walk(&st);
+    keep = calloc(signal_count ? signal_count : 1, sizeof(uint8_t));
+    remap = malloc(sizeof(SignalId) * (signal_count ? signal_count : 1));
+    if (!keep || !remap)
+    {
+        status = -1;
+        goto done;
+    }
+
+    // Drop dead instances, reusing the list nodes
+    InstanceList **link = &blk->instances, *tail = NULL;
+    i = 0;
+    for (InstanceList *node = blk->instances; node; node = node->next)
+    {
+        if (node->instance && !st.live_instance[i++])
+        {
+            report->instances_removed++;
+            continue;
+        }
+        *link = node;
+        link = &node->next;
+        tail = node;
+    }
+    *link = NULL;
+    blk->instances_tail = tail;
+
+    // A signal survives if a live instance refers to it, it is observed, or it already has a value
+    for (i = 0; i < n; ++i)
+        if (st.live_instance[i])
+            keep_ports(keep, st.insts[i]);
+    for (SignalId id = 0; id < signal_count; ++id)
+        keep[id] |= st.live_signal[id] || signal_map->entries[id].value;
+
+    report->signals_removed = signal_map_compact(signal_map, keep, remap);
+    if (report->signals_removed)
+        for (i = 0; i < n; ++i)
+            if (st.live_instance[i])
+                remap_ports(st.insts[i], remap);
+
+    LOG_INFO("🌿 Liveness: %zu observed signal(s); kept %zu of %zu instance(s) and %zu of %zu signal(s)",
+             report->roots, n - report->instances_removed, n,
+             signal_count - report->signals_removed, signal_count);
+
+done:
+    if (status != 0)
+        LOG_ERROR("❌ Liveness pass ran out of memory; the netlist is left untrimmed");
+    free(st.insts);
+    free(st.writer_offsets);
+    free(st.writers);
+    free(st.live_signal);
+    free(st.live_instance);
+    free(st.queue);
+    free(keep);
+    free(remap);
+    return status;
+}
@@ -0,0 +1,25 @@
+#ifndef LIVENESS_H
+#define LIVENESS_H
+#include "block.h"
+#include "signal_map.h"
+#include <stddef.h>
+
+// Dead-instance and dead-signal elimination, run right after
+// unify_invocations. The block's externally observed outputs are the
+// outputs of its top-level invocations and of their definitions; an
+// instance is live when it writes (gate output or literal binding) a signal
+// that is observed or read by a live instance. Everything else is dropped
+// from the instance list, and signals no live instance refers to are
+// removed from the signal map (the survivors are renumbered).
+
+typedef struct LivenessReport {
+    size_t roots;              // Observed signals the walk started from
+    size_t instance_count;     // Before trimming
+    size_t instances_removed;
+    size_t signal_count;       // Before trimming
+    size_t signals_removed;
+} LivenessReport;
+
+int trim_unobserved(Block *blk, SignalMap *signal_map, LivenessReport *report); // 0 on success; logs a summary
+
+#endif
@@ -1,3 +1,4 @@
+#include <pthread.h>
 #include <stdio.h>
 #include <stdarg.h>
 #include <time.h>
@@ -12,8 +13,27 @@
 static const char *level_str[] = {"INFO", "WARN", "ERROR"};
 static const char *level_color[] = {COLOR_INFO, COLOR_WARN, COLOR_ERROR};
 
+// One line at a time, even when parse workers log concurrently
+static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+static volatile LogLevel min_level = LOG_LEVEL_INFO;
+
+void log_set_level(LogLevel level)
+{
+    min_level = level;
+}
+
+LogLevel log_get_level(void)
+{
+    return min_level;
+}
+
 void log_msg(LogLevel level, const char *fmt, ...)
 {
+    if (level < min_level)
+        return;
+
+    pthread_mutex_lock(&log_lock);
+
     time_t now = time(NULL);
     struct tm *tm_info = localtime(&now);
     char time_buf[20];
@@ -36,4 +56,5 @@ void log_msg(LogLevel level, const char *fmt, ...)
     }
 
     va_end(args);
+    pthread_mutex_unlock(&log_lock);
 }
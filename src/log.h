@@ -11,6 +11,8 @@ typedef enum {
 
 // ─── Core Logging Function ───────────────────────────────────
 void log_msg(LogLevel level, const char *fmt, ...);
+void log_set_level(LogLevel min_level); // Drop messages below min_level (default: everything)
+LogLevel log_get_level(void);
 
 // ─── Convenience Macros ──────────────────────────────────────
 #define LOG_INFO(...)  log_msg(LOG_LEVEL_INFO,  __VA_ARGS__)
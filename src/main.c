@@ -1,3 +1,6 @@
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -10,12 +13,42 @@
 #include "block_util.h"
 #include "signal.h"
 #include "signal_map.h"
+#include "signal_store.h"
+#include "signal_export.h"
+#include "osc.h"
+#include "sexpr_parser.h"
+#include "netlist_image.h"
+#include "batch_eval.h"
+#include "thread_pool.h"
 
+// Reads the decimal number given to flag into *out if it is within [min, max];
+// otherwise says what flag expects and returns -1. Signs and trailing text are refused.
+static int parse_flag_number(const char *flag, const char *arg, unsigned long long min, unsigned long long max,
+                             unsigned long long *out) {
+    char *end = NULL;
+    errno = 0;
+    unsigned long long value = isdigit((unsigned char)arg[0]) ? strtoull(arg, &end, 10) : 0;
+    if (!end || *end != '\0' || errno == ERANGE || value < min || value > max) {
+        fprintf(stderr, "❌ %s expects a number from %llu to %llu, got '%s'\n", flag, min, max, arg);
+        return -1;
+    }
+    *out = value;
+    return 0;
+}
 
 int main(int argc, char *argv[]) {
     const char *inv_dir = NULL;
     const char *out_dir = NULL;
+    const char *image_path = NULL;
     int compile_mode = 0;
+    EvalOptions eval_options = { .mode = EVAL_MODE_SWEEP };
+    int bench_threads = -1;
+    int bench_layout = 0;
+    int batch_mode = 0;
+    BatchOptions batch_options = {0};
+    const char *export_path = NULL;
+    int export_interval_ms = SIGNAL_EXPORT_DEFAULT_INTERVAL_MS;
+    int osc_mode = 0;
 
     // 🎛️ Parse command-line arguments
     for (int i = 1; i < argc; ++i) {
@@ -25,6 +58,61 @@ int main(int argc, char *argv[]) {
             out_dir = argv[++i];
         } else if (strcmp(argv[i], "--compile") == 0) {
             compile_mode = 1;
+        } else if (strcmp(argv[i], "--eval-mode") == 0 && i + 1 < argc) {
+            if (parse_eval_mode(argv[++i], &eval_options.mode) != 0) {
+                fprintf(stderr, "❌ Unknown eval mode '%s' (expected sweep, event, levelized, parallel, native or bytecode)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--eval-threads") == 0 && i + 1 < argc) {
+            unsigned long long threads;
+            if (parse_flag_number("--eval-threads", argv[++i], 1, THREAD_POOL_MAX_THREADS, &threads) != 0)
+                return 1;
+            eval_options.threads = (size_t)threads;
+        } else if (strcmp(argv[i], "--bench-threads") == 0 && i + 1 < argc) {
+            unsigned long long threads; // 0 → up to one per online CPU
+            if (parse_flag_number("--bench-threads", argv[++i], 0, THREAD_POOL_MAX_THREADS, &threads) != 0)
+                return 1;
+            bench_threads = (int)threads;
+        } else if (strcmp(argv[i], "--bench-layout") == 0) {
+            bench_layout = 1;
+        } else if (strcmp(argv[i], "--jit-cache") == 0 && i + 1 < argc) {
+            eval_options.jit_cache_dir = argv[++i];
+        } else if (strcmp(argv[i], "--poll-budget") == 0 && i + 1 < argc) {
+            unsigned long long budget_ms; // A negative wait would block the poll forever
+            if (parse_flag_number("--poll-budget", argv[++i], 0, INT_MAX, &budget_ms) != 0)
+                return 1;
+            eval_options.poll_budget_ms = (int)budget_ms;
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch_mode = 1;
+            batch_options.stimuli_path = argv[++i];
+        } else if (strcmp(argv[i], "--batch-random") == 0 && i + 1 < argc) {
+            batch_mode = 1;
+            unsigned long long vectors;
+            if (parse_flag_number("--batch-random", argv[++i], 1, BATCH_MAX_RANDOM_VECTORS, &vectors) != 0)
+                return 1;
+            batch_options.random_vectors = (size_t)vectors;
+        } else if (strcmp(argv[i], "--batch-out") == 0 && i + 1 < argc) {
+            batch_options.output_path = argv[++i];
+        } else if (strcmp(argv[i], "--parse-threads") == 0 && i + 1 < argc) {
+            unsigned long long threads; // 0 → one per online CPU
+            if (parse_flag_number("--parse-threads", argv[++i], 0, THREAD_POOL_MAX_THREADS, &threads) != 0)
+                return 1;
+            set_parse_threads((int)threads);
+        } else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) {
+            image_path = argv[++i];
+        } else if (strcmp(argv[i], "--no-cache") == 0) {
+            set_build_cache_enabled(0);
+        } else if (strcmp(argv[i], "--no-trim") == 0) {
+            set_trim_enabled(0);
+        } else if (strcmp(argv[i], "--export") == 0 && i + 1 < argc) {
+            export_path = argv[++i];
+        } else if (strcmp(argv[i], "--export-interval") == 0 && i + 1 < argc) {
+            unsigned long long interval_ms;
+            if (parse_flag_number("--export-interval", argv[++i], 1, INT_MAX, &interval_ms) != 0)
+                return 1;
+            export_interval_ms = (int)interval_ms;
+        } else if (strcmp(argv[i], "--osc") == 0) {
+            osc_mode = 1;
         }
     }
 
@@ -33,24 +121,74 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
+    if (compile_mode && image_path) {
+        fprintf(stderr, "❌ --compile and --load are mutually exclusive\n");
+        return 1;
+    }
+
     // 🛰️ Setup PubSub + Global Signal Table
     init_pubsub();
     SignalMap *global_signal_map = create_signal_map();
+    global_signal_map->store = create_signal_store(); // Published after each eval pass
+
+    // ⚙️ Native code lives next to the other build outputs unless told otherwise
+    char jit_dir[1024];
+    if (!eval_options.jit_cache_dir && out_dir) {
+        snprintf(jit_dir, sizeof(jit_dir), "%s/jit", out_dir);
+        eval_options.jit_cache_dir = jit_dir;
+    }
 
     // 🔧 Compile Invocation Block (if requested)
     Block blk = {0};
     if (compile_mode) {
         blk.psi = mkrand_generate_ipv6();
         compile_block(&blk, global_signal_map, inv_dir, out_dir);
+    } else if (image_path) {
+        // 📦 Start from a previously compiled netlist instead of S-expressions
+        blk.image = netlist_image_load(image_path, &blk, global_signal_map);
+        if (!blk.image) {
+            destroy_signal_store(global_signal_map->store);
+            destroy_signal_map(global_signal_map);
+            cleanup_pubsub();
+            return 1;
+        }
     }
 
     print_signal_map(global_signal_map);
 
-    eval(&blk, global_signal_map);
+    // 📤 Readers of the signal store run beside evaluation and never stall it
+    SignalExporter *exporter = NULL;
+    if (export_path) {
+        exporter = start_signal_exporter(global_signal_map->store, global_signal_map, export_path, export_interval_ms);
+        if (!exporter)
+            fprintf(stderr, "⚠️ Could not start exporting to %s\n", export_path);
+    }
+    if (osc_mode)
+        start_osc_listener(&blk, global_signal_map->store);
+
+    int status = 0;
+    if (batch_mode) {
+        // 🧪 Many stimuli in one bit-sliced pass; the signal map is left as compiled
+        status = batch_eval(&blk, global_signal_map, &batch_options) == 0 ? 0 : 1;
+    } else if (bench_threads >= 0) {
+        // 📈 Scaling report instead of a normal evaluation
+        eval_bench_threads(&blk, global_signal_map, (size_t)bench_threads);
+    } else if (bench_layout) {
+        // 📐 Instance graph vs. Netlist arrays, same levelized pass
+        eval_bench_layout(&blk, global_signal_map);
+    } else {
+        eval_with_options(&blk, global_signal_map, &eval_options);
+    }
     
+    if (osc_mode)
+        stop_osc_listener();
+    stop_signal_exporter(exporter);
+
     print_signal_map(global_signal_map);
     // 🧼 Cleanup
+    block_release(&blk); // Closes the image last: instances pointed into it
+    destroy_signal_store(global_signal_map->store);
     destroy_signal_map(global_signal_map);
     cleanup_pubsub();
-    return 0;
+    return status;
 }
@@ -0,0 +1,191 @@
+#include "netlist.h"
+#include "log.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Arrays are carved from one block at 8-byte boundaries
+#define NETLIST_ALIGN(bytes) (((bytes) + 7) & ~(size_t)7)
+
+static void *carve(char **cursor, size_t bytes)
+{
+    void *p = *cursor;
+    *cursor += NETLIST_ALIGN(bytes);
+    return p;
+}
+
+static bool instance_complete(const Instance *inst)
+{
+    return inst && inst->definition && inst->invocation;
+}
+
+static size_t usable_literals(const Instance *inst)
+{
+    const LiteralBinding *bindings = inst->invocation->literal_bindings ? inst->invocation->literal_bindings->items : NULL;
+    size_t n = 0;
+    for (size_t l = 0; l < inst->literal_count; ++l)
+        n += bindings && inst->literal_ids[l] != SIGNAL_ID_NONE && bindings[l].value;
+    return n;
+}
+
+static size_t hash_pointer(const void *p)
+{
+    uintptr_t x = (uintptr_t)p;
+    x ^= x >> 17;
+    x *= (uintptr_t)0x9E3779B97F4A7C15ull;
+    return (size_t)(x ^ (x >> 29));
+}
+
+Netlist *build_netlist(const Schedule *schedule)
+{
+    if (!schedule)
+        return NULL;
+
+    size_t n = schedule->instance_count;
+    size_t port_total = 0, literal_total = 0;
+    for (size_t r = 0; r < n; ++r)
+    {
+        const Instance *inst = schedule->instances[schedule->order[r]];
+        if (!instance_complete(inst))
+            continue;
+        port_total += inst->input_count + inst->pattern_count;
+        literal_total += usable_literals(inst);
+    }
+    if (port_total > UINT32_MAX || literal_total > UINT32_MAX)
+    {
+        LOG_ERROR("❌ Netlist too large for 32-bit port offsets");
+        return NULL;
+    }
+
+    // Distinct Definitions, found through a scratch pointer hash
+    size_t slot_count = 16;
+    while (slot_count < 2 * n)
+        slot_count *= 2;
+    const Definition **slot_def = calloc(slot_count, sizeof(Definition *));
+    uint32_t *slot_index = malloc(sizeof(uint32_t) * slot_count);
+    const Definition **found = malloc(sizeof(Definition *) * (n ? n : 1));
+    uint32_t *row_def = malloc(sizeof(uint32_t) * (n ? n : 1));
+    if (!slot_def || !slot_index || !found || !row_def)
+    {
+        free(slot_def);
+        free(slot_index);
+        free(found);
+        free(row_def);
+        return NULL;
+    }
+
+    size_t def_count = 0;
+    for (size_t r = 0; r < n; ++r)
+    {
+        const Instance *inst = schedule->instances[schedule->order[r]];
+        if (!instance_complete(inst))
+        {
+            row_def[r] = NETLIST_NO_DEF;
+            continue;
+        }
+        size_t slot = hash_pointer(inst->definition) & (slot_count - 1);
+        while (slot_def[slot] && slot_def[slot] != inst->definition)
+            slot = (slot + 1) & (slot_count - 1);
+        if (!slot_def[slot])
+        {
+            slot_def[slot] = inst->definition;
+            slot_index[slot] = (uint32_t)def_count;
+            found[def_count++] = inst->definition;
+        }
+        row_def[r] = slot_index[slot];
+    }
+    free(slot_def);
+    free(slot_index);
+
+    size_t bytes = NETLIST_ALIGN(sizeof(Netlist))
+                 + NETLIST_ALIGN(sizeof(const char *) * n)
+                 + NETLIST_ALIGN(sizeof(uint32_t) * n)
+                 + NETLIST_ALIGN(sizeof(SignalId) * n)
+                 + NETLIST_ALIGN(n)
+                 + NETLIST_ALIGN(sizeof(uint32_t) * (n + 1))
+                 + NETLIST_ALIGN(sizeof(uint32_t) * n)
+                 + NETLIST_ALIGN(sizeof(SignalId) * port_total)
+                 + NETLIST_ALIGN(sizeof(uint32_t) * (n + 1))
+                 + NETLIST_ALIGN(sizeof(SignalId) * literal_total)
+                 + NETLIST_ALIGN(sizeof(const char *) * literal_total)
+                 + NETLIST_ALIGN(sizeof(const Definition *) * def_count)
+                 + NETLIST_ALIGN(sizeof(const ConditionalInvocation *) * def_count);
+    char *cursor = calloc(1, bytes);
+    if (!cursor)
+    {
+        free(found);
+        free(row_def);
+        return NULL;
+    }
+
+    Netlist *net = carve(&cursor, sizeof(Netlist));
+    net->row_count = n;
+    net->names = carve(&cursor, sizeof(const char *) * n);
+    net->def_index = carve(&cursor, sizeof(uint32_t) * n);
+    net->output_slot = carve(&cursor, sizeof(SignalId) * n);
+    net->flags = carve(&cursor, n);
+    net->port_first = carve(&cursor, sizeof(uint32_t) * (n + 1));
+    net->input_count = carve(&cursor, sizeof(uint32_t) * n);
+    net->ports = carve(&cursor, sizeof(SignalId) * port_total);
+    net->literal_first = carve(&cursor, sizeof(uint32_t) * (n + 1));
+    net->literal_slots = carve(&cursor, sizeof(SignalId) * literal_total);
+    net->literal_values = carve(&cursor, sizeof(const char *) * literal_total);
+    net->defs = carve(&cursor, sizeof(const Definition *) * def_count);
+    net->logic = carve(&cursor, sizeof(const ConditionalInvocation *) * def_count);
+    net->def_count = def_count;
+
+    for (size_t d = 0; d < def_count; ++d)
+    {
+        const ConditionalInvocation *ci = found[d]->conditional_invocation;
+        net->defs[d] = found[d];
+        net->logic[d] = ci && ci->pattern_args && ci->arg_count > 0 && ci->output ? ci : NULL;
+    }
+
+    uint32_t port = 0, literal = 0;
+    for (size_t r = 0; r < n; ++r)
+    {
+        const Instance *inst = schedule->instances[schedule->order[r]];
+        net->port_first[r] = port;
+        net->literal_first[r] = literal;
+        net->def_index[r] = row_def[r];
+        net->output_slot[r] = SIGNAL_ID_NONE;
+        if (inst)
+            net->names[r] = inst->name;
+        if (!instance_complete(inst))
+            continue;
+
+        memcpy(net->ports + port, inst->input_ids, sizeof(SignalId) * inst->input_count);
+        memcpy(net->ports + port + inst->input_count, inst->pattern_ids, sizeof(SignalId) * inst->pattern_count);
+        net->input_count[r] = (uint32_t)inst->input_count;
+        port += (uint32_t)(inst->input_count + inst->pattern_count);
+
+        const LiteralBinding *bindings = inst->invocation->literal_bindings ? inst->invocation->literal_bindings->items : NULL;
+        for (size_t l = 0; l < inst->literal_count; ++l)
+        {
+            if (!bindings || inst->literal_ids[l] == SIGNAL_ID_NONE || !bindings[l].value)
+                continue;
+            net->literal_slots[literal] = inst->literal_ids[l];
+            net->literal_values[literal] = bindings[l].value;
+            literal++;
+        }
+
+        if (net->logic[row_def[r]] && inst->input_count > 0)
+        {
+            net->flags[r] |= NETLIST_ROW_LOGIC;
+            net->output_slot[r] = inst->output_id;
+        }
+    }
+    net->port_first[n] = port;
+    net->literal_first[n] = literal;
+
+    free(found);
+    free(row_def);
+
+    LOG_INFO("🧱 Netlist: %zu row(s), %zu definition(s), %u port(s), %u literal(s) in %zu bytes",
+             n, def_count, port, literal, bytes);
+    return net;
+}
+
+void destroy_netlist(Netlist *netlist)
+{
+    free(netlist); // The arrays follow the header in the same block
+}
@@ -0,0 +1,55 @@
+#ifndef NETLIST_H
+#define NETLIST_H
+#include "schedule.h"
+#include "signal_map.h"
+#include <stdint.h>
+
+// Structure-of-arrays form of a scheduled Block, for the hot evaluation
+// loops. Row r is the instance at Schedule.order[r], so a levelized pass
+// walks every array front to back and ScheduleStep.first/count index rows
+// directly. Everything lives in one allocation; nothing points back into
+// InstanceList, Invocation or StringList except the shared Definitions.
+
+#define NETLIST_ROW_LOGIC 0x01  // Has a conditional invocation and at least one input
+#define NETLIST_NO_DEF UINT32_MAX // def_index of an incomplete instance
+
+typedef struct Netlist {
+    size_t row_count;
+    const char **names;       // Row → interned instance name (log messages only)
+    uint32_t *def_index;      // Row → defs / logic, or NETLIST_NO_DEF
+    SignalId *output_slot;    // Row → conditional_invocation->output
+    uint8_t *flags;           // Row → NETLIST_ROW_*
+
+    // Ports of row r: ports[port_first[r] .. port_first[r + 1]), inputs
+    // first (input_count[r] of them), then the template args
+    uint32_t *port_first;     // row_count + 1
+    uint32_t *input_count;
+    SignalId *ports;
+
+    // Literal bindings of row r: literal_first[r] .. literal_first[r + 1]
+    uint32_t *literal_first;  // row_count + 1
+    SignalId *literal_slots;
+    const char **literal_values; // Interned
+
+    const Definition **defs;  // Distinct Definitions, in first-use order
+    const ConditionalInvocation **logic; // By def index; NULL if the Definition has none
+    size_t def_count;
+} Netlist;
+
+Netlist *build_netlist(const Schedule *schedule); // Logs the footprint
+void destroy_netlist(Netlist *netlist);
+
+static inline const SignalId *netlist_inputs(const Netlist *net, uint32_t row, uint32_t *count)
+{
+    *count = net->input_count[row];
+    return net->ports + net->port_first[row];
+}
+
+static inline const SignalId *netlist_patterns(const Netlist *net, uint32_t row, uint32_t *count)
+{
+    uint32_t first = net->port_first[row] + net->input_count[row];
+    *count = net->port_first[row + 1] - first;
+    return net->ports + first;
+}
+
+#endif
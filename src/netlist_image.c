@@ -0,0 +1,785 @@
+#include "netlist_image.h"
+#include "instance.h"
+#include "intern.h"
+#include "string_list.h"
+#include "truth_table.h"
+#include "log.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define IMAGE_BYTE_ORDER 0x01020304u
+#define IMAGE_ALIGN(n) (((n) + 7) & ~(size_t)7)
+
+static const size_t section_elem_size[IMAGE_SECTION_COUNT] = {
+    [IMAGE_SECTION_STRINGS] = sizeof(char),
+    [IMAGE_SECTION_NAMES] = sizeof(uint32_t),
+    [IMAGE_SECTION_SIGNALS] = sizeof(ImageSignal),
+    [IMAGE_SECTION_DEFINITIONS] = sizeof(ImageDefinition),
+    [IMAGE_SECTION_CASES] = sizeof(ImageCase),
+    [IMAGE_SECTION_ROWS] = sizeof(uint16_t),
+    [IMAGE_SECTION_INVOCATIONS] = sizeof(ImageInvocation),
+    [IMAGE_SECTION_INSTANCES] = sizeof(ImageInstance),
+    [IMAGE_SECTION_PORTS] = sizeof(SignalId),
+};
+
+// ─── Writer ─────────────────────────────────────────────────────────
+
+typedef struct ImageBuffer {
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+} ImageBuffer;
+
+// Pointer → uint32, for deduplicating interned strings and shared templates
+typedef struct PointerIndex {
+    const void **keys;
+    uint32_t *values;
+    size_t slot_count;    // Power of two, or 0 before first insert
+    size_t count;
+} PointerIndex;
+
+typedef struct ImageWriter {
+    ImageBuffer sections[IMAGE_SECTION_COUNT];
+    PointerIndex strings;
+    PointerIndex definitions;
+    PointerIndex invocations;
+    int failed;
+} ImageWriter;
+
+static size_t pointer_slot(const void *key, size_t slot_count)
+{
+    uint64_t h = (uint64_t)(uintptr_t)key * 0x9E3779B97F4A7C15ull;
+    return (size_t)(h >> 32) & (slot_count - 1);
+}
+
+static uint32_t pointer_index_get(const PointerIndex *index, const void *key)
+{
+    if (!index->slot_count)
+        return NETLIST_IMAGE_NONE;
+    for (size_t slot = pointer_slot(key, index->slot_count); index->keys[slot]; slot = (slot + 1) & (index->slot_count - 1))
+        if (index->keys[slot] == key)
+            return index->values[slot];
+    return NETLIST_IMAGE_NONE;
+}
+
+static int pointer_index_put(PointerIndex *index, const void *key, uint32_t value)
+{
+    if ((index->count + 1) * 2 > index->slot_count)
+    {
+        size_t new_count = index->slot_count ? index->slot_count * 2 : 256;
+        const void **keys = calloc(new_count, sizeof(void *));
+        uint32_t *values = malloc(sizeof(uint32_t) * new_count);
+        if (!keys || !values)
+        {
+            free(keys);
+            free(values);
+            return -1;
+        }
+        for (size_t i = 0; i < index->slot_count; ++i)
+        {
+            if (!index->keys[i])
+                continue;
+            size_t slot = pointer_slot(index->keys[i], new_count);
+            while (keys[slot])
+                slot = (slot + 1) & (new_count - 1);
+            keys[slot] = index->keys[i];
+            values[slot] = index->values[i];
+        }
+        free(index->keys);
+        free(index->values);
+        index->keys = keys;
+        index->values = values;
+        index->slot_count = new_count;
+    }
+
+    size_t slot = pointer_slot(key, index->slot_count);
+    while (index->keys[slot])
+        slot = (slot + 1) & (index->slot_count - 1);
+    index->keys[slot] = key;
+    index->values[slot] = value;
+    index->count++;
+    return 0;
+}
+
+static void pointer_index_free(PointerIndex *index)
+{
+    free(index->keys);
+    free(index->values);
+}
+
+// Appends zeroed space for count elements and returns the index of the first.
+// *out is NULL when count is 0 or on failure (which also sets w->failed).
+static uint32_t writer_push(ImageWriter *w, int section, size_t count, void **out)
+{
+    ImageBuffer *buf = &w->sections[section];
+    size_t elem = section_elem_size[section];
+    size_t first = buf->size / elem;
+    size_t need = buf->size + count * elem;
+
+    *out = NULL;
+    if (w->failed || first + count >= NETLIST_IMAGE_NONE)
+    {
+        w->failed = 1;
+        return NETLIST_IMAGE_NONE;
+    }
+    if (count == 0)
+        return (uint32_t)first;
+
+    if (need > buf->capacity)
+    {
+        size_t capacity = buf->capacity ? buf->capacity : 1024;
+        while (capacity < need)
+            capacity *= 2;
+        uint8_t *data = realloc(buf->data, capacity);
+        if (!data)
+        {
+            w->failed = 1;
+            return NETLIST_IMAGE_NONE;
+        }
+        buf->data = data;
+        buf->capacity = capacity;
+    }
+
+    *out = buf->data + buf->size;
+    memset(*out, 0, count * elem);
+    buf->size = need;
+    return (uint32_t)first;
+}
+
+static uint32_t writer_string(ImageWriter *w, const char *s)
+{
+    if (!s)
+        return NETLIST_IMAGE_NONE;
+
+    s = intern(s);
+    uint32_t offset = pointer_index_get(&w->strings, s);
+    if (offset != NETLIST_IMAGE_NONE)
+        return offset;
+
+    void *dst;
+    size_t len = intern_length(s) + 1;
+    offset = writer_push(w, IMAGE_SECTION_STRINGS, len, &dst);
+    if (!dst)
+        return NETLIST_IMAGE_NONE;
+    memcpy(dst, s, len);
+
+    if (pointer_index_put(&w->strings, s, offset) != 0)
+        w->failed = 1;
+    return offset;
+}
+
+static uint32_t writer_names(ImageWriter *w, const StringList *list, uint32_t *count)
+{
+    *count = (uint32_t)string_list_count(list);
+    void *dst;
+    uint32_t first = writer_push(w, IMAGE_SECTION_NAMES, *count, &dst);
+    for (uint32_t i = 0; dst && i < *count; ++i)
+        ((uint32_t *)dst)[i] = writer_string(w, string_list_get(list, i));
+    return first;
+}
+
+static uint32_t writer_definition(ImageWriter *w, const Definition *def)
+{
+    uint32_t index = pointer_index_get(&w->definitions, def);
+    if (index != NETLIST_IMAGE_NONE)
+        return index;
+
+    ImageDefinition rec = {0};
+    rec.name = writer_string(w, def->name);
+    rec.input_first = writer_names(w, def->input_signals, &rec.input_count);
+    rec.output_first = writer_names(w, def->output_signals, &rec.output_count);
+    rec.output = NETLIST_IMAGE_NONE;
+    rec.row_first = NETLIST_IMAGE_NONE;
+
+    const ConditionalInvocation *ci = def->conditional_invocation;
+    if (ci)
+    {
+        rec.arg_first = writer_names(w, ci->pattern_args, &rec.arg_count);
+        rec.output = writer_string(w, ci->output);
+
+        void *dst;
+        rec.case_count = (uint32_t)ci->case_count;
+        rec.case_first = writer_push(w, IMAGE_SECTION_CASES, ci->case_count, &dst);
+        for (size_t i = 0; dst && i < ci->case_count; ++i)
+        {
+            ((ImageCase *)dst)[i].pattern = writer_string(w, ci->cases[i].pattern);
+            ((ImageCase *)dst)[i].result = writer_string(w, ci->cases[i].result);
+        }
+
+        if (ci->truth_table)
+        {
+            size_t row_count = (size_t)1 << ci->truth_table->arg_count;
+            rec.row_first = writer_push(w, IMAGE_SECTION_ROWS, row_count, &dst);
+            if (dst)
+                memcpy(dst, ci->truth_table->rows, sizeof(uint16_t) * row_count);
+        }
+    }
+
+    void *dst;
+    index = writer_push(w, IMAGE_SECTION_DEFINITIONS, 1, &dst);
+    if (dst)
+        memcpy(dst, &rec, sizeof(rec));
+    if (index != NETLIST_IMAGE_NONE && pointer_index_put(&w->definitions, def, index) != 0)
+        w->failed = 1;
+    return index;
+}
+
+static uint32_t writer_invocation(ImageWriter *w, const Invocation *inv)
+{
+    uint32_t index = pointer_index_get(&w->invocations, inv);
+    if (index != NETLIST_IMAGE_NONE)
+        return index;
+
+    ImageInvocation rec = {0};
+    rec.target_name = writer_string(w, inv->target_name);
+    rec.input_first = writer_names(w, inv->input_signals, &rec.input_count);
+    rec.output_first = writer_names(w, inv->output_signals, &rec.output_count);
+
+    void *dst;
+    rec.literal_count = inv->literal_bindings ? (uint32_t)inv->literal_bindings->count : 0;
+    rec.literal_first = writer_push(w, IMAGE_SECTION_NAMES, 2 * (size_t)rec.literal_count, &dst);
+    for (uint32_t i = 0; dst && i < rec.literal_count; ++i)
+    {
+        const LiteralBinding *b = &inv->literal_bindings->items[i];
+        ((uint32_t *)dst)[2 * i] = writer_string(w, b->name);
+        ((uint32_t *)dst)[2 * i + 1] = writer_string(w, b->value);
+    }
+
+    index = writer_push(w, IMAGE_SECTION_INVOCATIONS, 1, &dst);
+    if (dst)
+        memcpy(dst, &rec, sizeof(rec));
+    if (index != NETLIST_IMAGE_NONE && pointer_index_put(&w->invocations, inv, index) != 0)
+        w->failed = 1;
+    return index;
+}
+
+static void writer_instance(ImageWriter *w, const Instance *inst)
+{
+    ImageInstance rec = {0};
+    rec.name = writer_string(w, inst->name);
+    rec.definition = writer_definition(w, inst->definition);
+    rec.invocation = writer_invocation(w, inst->invocation);
+    rec.output_id = inst->output_id;
+
+    void *dst;
+    rec.port_first = writer_push(w, IMAGE_SECTION_PORTS, inst->port_count, &dst);
+    if (dst)
+        memcpy(dst, inst->ports, sizeof(SignalId) * inst->port_count);
+
+    writer_push(w, IMAGE_SECTION_INSTANCES, 1, &dst);
+    if (dst)
+        memcpy(dst, &rec, sizeof(rec));
+}
+
+static int write_sections(ImageWriter *w, FILE *out)
+{
+    NetlistImageHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, NETLIST_IMAGE_MAGIC, sizeof(header.magic));
+    header.version = NETLIST_IMAGE_VERSION;
+    header.byte_order = IMAGE_BYTE_ORDER;
+
+    size_t offset = IMAGE_ALIGN(sizeof(header));
+    for (int s = 0; s < IMAGE_SECTION_COUNT; ++s)
+    {
+        header.sections[s].offset = offset;
+        header.sections[s].count = w->sections[s].size / section_elem_size[s];
+        offset += IMAGE_ALIGN(w->sections[s].size);
+    }
+    header.file_size = offset;
+
+    static const uint8_t padding[8] = {0};
+    if (fwrite(&header, sizeof(header), 1, out) != 1 ||
+        fwrite(padding, 1, IMAGE_ALIGN(sizeof(header)) - sizeof(header), out) != IMAGE_ALIGN(sizeof(header)) - sizeof(header))
+        return -1;
+
+    for (int s = 0; s < IMAGE_SECTION_COUNT; ++s)
+    {
+        size_t size = w->sections[s].size;
+        if (size && fwrite(w->sections[s].data, 1, size, out) != size)
+            return -1;
+        if (fwrite(padding, 1, IMAGE_ALIGN(size) - size, out) != IMAGE_ALIGN(size) - size)
+            return -1;
+    }
+    return 0;
+}
+
+int netlist_image_write(const Block *blk, SignalMap *signal_map, const char *path)
+{
+    if (!blk || !signal_map || !path)
+        return -1;
+
+    ImageWriter w;
+    memset(&w, 0, sizeof(w));
+
+    // The string section must end in NUL even when empty, so offsets are always terminated
+    writer_string(&w, "");
+
+    void *dst;
+    writer_push(&w, IMAGE_SECTION_SIGNALS, signal_map->count, &dst);
+    for (size_t i = 0; dst && i < signal_map->count; ++i)
+    {
+        ((ImageSignal *)dst)[i].name = writer_string(&w, signal_map_name(signal_map, (SignalId)i));
+        ((ImageSignal *)dst)[i].value = writer_string(&w, signal_map->entries[i].value);
+    }
+
+    size_t instance_count = 0;
+    for (const InstanceList *node = blk->instances; node; node = node->next)
+    {
+        if (!node->instance || !node->instance->definition || !node->instance->invocation)
+            continue; // eval skips these too
+        writer_instance(&w, node->instance);
+        instance_count++;
+    }
+
+    int status = -1;
+    char tmp_path[512];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    if (w.failed)
+    {
+        LOG_ERROR("❌ Netlist too large or out of memory while building image");
+    }
+    else
+    {
+        FILE *out = fopen(tmp_path, "wb");
+        if (!out)
+        {
+            LOG_ERROR("❌ Failed to open netlist image for writing: %s", tmp_path);
+        }
+        else
+        {
+            int written = write_sections(&w, out) == 0;
+            if (fclose(out) != 0) // Always closed; it also flushes, so a full disk shows up here
+                written = 0;
+
+            if (!written)
+                LOG_ERROR("❌ Failed to write netlist image: %s", tmp_path);
+            else if (rename(tmp_path, path) != 0)
+                LOG_ERROR("❌ Failed to move netlist image into place: %s", path);
+            else
+                status = 0;
+
+            if (status != 0)
+                remove(tmp_path); // Never leave a partial image behind
+        }
+    }
+
+    if (status == 0)
+        LOG_INFO("💾 Wrote netlist image %s (%zu signals, %zu instances, %zu string bytes)",
+                 path, signal_map->count, instance_count, w.sections[IMAGE_SECTION_STRINGS].size);
+
+    for (int s = 0; s < IMAGE_SECTION_COUNT; ++s)
+        free(w.sections[s].data);
+    pointer_index_free(&w.strings);
+    pointer_index_free(&w.definitions);
+    pointer_index_free(&w.invocations);
+    return status;
+}
+
+// ─── Loader ─────────────────────────────────────────────────────────
+
+struct NetlistImage {
+    void *map;
+    size_t size;
+};
+
+typedef struct ImageReader {
+    const char *path;
+    const uint8_t *base;
+    const NetlistImageHeader *header;
+    const char *error;
+} ImageReader;
+
+static const void *reader_section(const ImageReader *r, int section)
+{
+    return r->base + r->header->sections[section].offset;
+}
+
+static uint32_t reader_count(const ImageReader *r, int section)
+{
+    return (uint32_t)r->header->sections[section].count;
+}
+
+static int reader_fail(ImageReader *r, const char *error)
+{
+    if (!r->error)
+        r->error = error;
+    return -1;
+}
+
+// Interned, or NULL for NETLIST_IMAGE_NONE
+static const char *reader_string(ImageReader *r, uint32_t offset)
+{
+    if (offset == NETLIST_IMAGE_NONE)
+        return NULL;
+    if (offset >= reader_count(r, IMAGE_SECTION_STRINGS))
+    {
+        reader_fail(r, "string offset out of range");
+        return NULL;
+    }
+    return intern((const char *)reader_section(r, IMAGE_SECTION_STRINGS) + offset);
+}
+
+static int reader_range(ImageReader *r, int section, uint32_t first, uint64_t count)
+{
+    if (count == 0)
+        return 0;
+    if (first == NETLIST_IMAGE_NONE || (uint64_t)first + count > reader_count(r, section))
+        return reader_fail(r, "record slice out of range");
+    return 0;
+}
+
+static StringList *reader_names(ImageReader *r, Arena *arena, uint32_t first, uint32_t count)
+{
+    StringList *list = create_string_list_in(arena);
+    if (!list || reader_range(r, IMAGE_SECTION_NAMES, first, count) != 0)
+        return list;
+
+    const uint32_t *names = reader_section(r, IMAGE_SECTION_NAMES);
+    for (uint32_t i = 0; i < count; ++i)
+        string_list_add(list, reader_string(r, names[first + i]));
+    return list;
+}
+
+static int validate_header(ImageReader *r, size_t file_size)
+{
+    if (file_size < sizeof(NetlistImageHeader))
+        return reader_fail(r, "file too small");
+
+    const NetlistImageHeader *h = r->header;
+    if (memcmp(h->magic, NETLIST_IMAGE_MAGIC, sizeof(h->magic)) != 0)
+        return reader_fail(r, "not a netlist image");
+    if (h->version != NETLIST_IMAGE_VERSION)
+        return reader_fail(r, "unsupported image version");
+    if (h->byte_order != IMAGE_BYTE_ORDER)
+        return reader_fail(r, "image was written on a machine with different byte order");
+    if (h->file_size != file_size)
+        return reader_fail(r, "truncated image");
+
+    for (int s = 0; s < IMAGE_SECTION_COUNT; ++s)
+    {
+        uint64_t offset = h->sections[s].offset;
+        uint64_t count = h->sections[s].count;
+        if (offset % 8 != 0 || offset > file_size || count >= NETLIST_IMAGE_NONE ||
+            count > (file_size - offset) / section_elem_size[s])
+            return reader_fail(r, "section out of bounds");
+    }
+
+    uint32_t string_bytes = reader_count(r, IMAGE_SECTION_STRINGS);
+    if (string_bytes == 0 || ((const char *)reader_section(r, IMAGE_SECTION_STRINGS))[string_bytes - 1] != '\0')
+        return reader_fail(r, "unterminated string section");
+    return 0;
+}
+
+static int load_signals(ImageReader *r, SignalMap *signal_map)
+{
+    if (signal_map->count != 0)
+        return reader_fail(r, "signal map is not empty");
+
+    const ImageSignal *signals = reader_section(r, IMAGE_SECTION_SIGNALS);
+    uint32_t count = reader_count(r, IMAGE_SECTION_SIGNALS);
+
+    // SignalIds in the port vectors are only valid if the map is rebuilt in the same order
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const char *name = reader_string(r, signals[i].name);
+        if (!name || signal_map_intern(signal_map, name) != i)
+            return reader_fail(r, "signal table has missing or duplicate names");
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+        if (signals[i].value != NETLIST_IMAGE_NONE)
+            signal_map_set(signal_map, i, reader_string(r, signals[i].value));
+
+    return r->error ? -1 : 0;
+}
+
+static Definition *load_definitions(ImageReader *r, Block *blk)
+{
+    const ImageDefinition *recs = reader_section(r, IMAGE_SECTION_DEFINITIONS);
+    uint32_t count = reader_count(r, IMAGE_SECTION_DEFINITIONS);
+    Definition *defs = arena_calloc(blk->arena, count ? count : 1, sizeof(Definition));
+    if (!defs)
+        return NULL;
+
+    const char *origin = intern(r->path);
+    Definition **tail = &blk->definitions;
+
+    for (uint32_t d = 0; d < count && !r->error; ++d)
+    {
+        const ImageDefinition *rec = &recs[d];
+        Definition *def = &defs[d];
+        def->name = reader_string(r, rec->name);
+        def->origin_sexpr_path = origin;
+        def->input_signals = reader_names(r, blk->arena, rec->input_first, rec->input_count);
+        def->output_signals = reader_names(r, blk->arena, rec->output_first, rec->output_count);
+
+        if (rec->output != NETLIST_IMAGE_NONE)
+        {
+            ConditionalInvocation *ci = arena_calloc(blk->arena, 1, sizeof(ConditionalInvocation));
+            if (!ci)
+            {
+                reader_fail(r, "out of memory");
+                break;
+            }
+            if (reader_range(r, IMAGE_SECTION_CASES, rec->case_first, rec->case_count) != 0)
+                break;
+
+            ci->pattern_args = reader_names(r, blk->arena, rec->arg_first, rec->arg_count);
+            ci->arg_count = rec->arg_count;
+            ci->output = reader_string(r, rec->output);
+            ci->case_count = rec->case_count;
+            ci->cases = arena_calloc(blk->arena, rec->case_count ? rec->case_count : 1, sizeof(ConditionalCase));
+            if (!ci->cases)
+            {
+                reader_fail(r, "out of memory");
+                break;
+            }
+
+            const ImageCase *cases = reader_section(r, IMAGE_SECTION_CASES);
+            for (uint32_t i = 0; i < rec->case_count; ++i)
+            {
+                ci->cases[i].pattern = reader_string(r, cases[rec->case_first + i].pattern);
+                ci->cases[i].result = reader_string(r, cases[rec->case_first + i].result);
+            }
+
+            if (rec->row_first != NETLIST_IMAGE_NONE)
+            {
+                if (rec->arg_count == 0 || rec->arg_count > TRUTH_TABLE_MAX_ARGS)
+                {
+                    reader_fail(r, "truth table width out of range");
+                    break;
+                }
+                size_t row_count = (size_t)1 << rec->arg_count;
+                if (reader_range(r, IMAGE_SECTION_ROWS, rec->row_first, row_count) != 0)
+                    break;
+
+                // Rows are used straight from the mapping
+                uint16_t *rows = (uint16_t *)reader_section(r, IMAGE_SECTION_ROWS) + rec->row_first;
+                for (size_t row = 0; row < row_count; ++row)
+                    if (rows[row] != TRUTH_TABLE_NO_CASE && rows[row] >= rec->case_count)
+                        reader_fail(r, "truth table row names a missing case");
+
+                ci->truth_table = arena_alloc(blk->arena, sizeof(TruthTable));
+                if (!ci->truth_table)
+                {
+                    reader_fail(r, "out of memory");
+                    break;
+                }
+                ci->truth_table->arg_count = rec->arg_count;
+                ci->truth_table->rows = rows;
+            }
+            def->conditional_invocation = ci;
+        }
+
+        *tail = def;
+        tail = &def->next;
+    }
+
+    return r->error ? NULL : defs;
+}
+
+static Invocation *load_invocations(ImageReader *r, Block *blk)
+{
+    const ImageInvocation *recs = reader_section(r, IMAGE_SECTION_INVOCATIONS);
+    uint32_t count = reader_count(r, IMAGE_SECTION_INVOCATIONS);
+    Invocation *invs = arena_calloc(blk->arena, count ? count : 1, sizeof(Invocation));
+    if (!invs)
+        return NULL;
+
+    const char *origin = intern(r->path);
+    Invocation **tail = &blk->invocations;
+
+    for (uint32_t v = 0; v < count && !r->error; ++v)
+    {
+        const ImageInvocation *rec = &recs[v];
+        Invocation *inv = &invs[v];
+        inv->target_name = reader_string(r, rec->target_name);
+        inv->origin_sexpr_path = origin;
+        inv->input_signals = reader_names(r, blk->arena, rec->input_first, rec->input_count);
+        inv->output_signals = reader_names(r, blk->arena, rec->output_first, rec->output_count);
+
+        if (rec->literal_count)
+        {
+            if (reader_range(r, IMAGE_SECTION_NAMES, rec->literal_first, 2 * (uint64_t)rec->literal_count) != 0)
+                break;
+            LiteralBindingList *list = arena_alloc(blk->arena, sizeof(LiteralBindingList));
+            LiteralBinding *items = arena_calloc(blk->arena, rec->literal_count, sizeof(LiteralBinding));
+            if (!list || !items)
+            {
+                reader_fail(r, "out of memory");
+                break;
+            }
+
+            const uint32_t *names = reader_section(r, IMAGE_SECTION_NAMES);
+            for (uint32_t i = 0; i < rec->literal_count; ++i)
+            {
+                items[i].name = reader_string(r, names[rec->literal_first + 2 * i]);
+                items[i].value = reader_string(r, names[rec->literal_first + 2 * i + 1]);
+            }
+            list->items = items;
+            list->count = rec->literal_count;
+            inv->literal_bindings = list;
+        }
+
+        *tail = inv;
+        tail = &inv->next;
+    }
+
+    return r->error ? NULL : invs;
+}
+
+static int load_instances(ImageReader *r, Block *blk, Definition *defs, Invocation *invs, size_t signal_count)
+{
+    const ImageInstance *recs = reader_section(r, IMAGE_SECTION_INSTANCES);
+    uint32_t count = reader_count(r, IMAGE_SECTION_INSTANCES);
+    Instance *instances = arena_calloc(blk->arena, count ? count : 1, sizeof(Instance));
+    InstanceList *nodes = arena_calloc(blk->arena, count ? count : 1, sizeof(InstanceList));
+    if (!instances || !nodes)
+        return reader_fail(r, "out of memory");
+
+    SignalId *ports = (SignalId *)reader_section(r, IMAGE_SECTION_PORTS);
+    InstanceList **tail = &blk->instances;
+
+    for (uint32_t n = 0; n < count; ++n)
+    {
+        const ImageInstance *rec = &recs[n];
+        if (rec->definition >= reader_count(r, IMAGE_SECTION_DEFINITIONS) ||
+            rec->invocation >= reader_count(r, IMAGE_SECTION_INVOCATIONS))
+            return reader_fail(r, "instance names a missing definition or invocation");
+
+        Instance *inst = &instances[n];
+        const Definition *def = &defs[rec->definition];
+        const Invocation *inv = &invs[rec->invocation];
+        inst->name = reader_string(r, rec->name);
+        inst->definition = def;
+        inst->invocation = inv;
+        inst->output_id = rec->output_id;
+
+        inst->input_count = string_list_count(inv->input_signals);
+        inst->output_count = string_list_count(inv->output_signals);
+        inst->literal_count = inv->literal_bindings ? inv->literal_bindings->count : 0;
+        inst->def_input_count = string_list_count(def->input_signals);
+        inst->def_output_count = string_list_count(def->output_signals);
+        inst->pattern_count = def->conditional_invocation ? def->conditional_invocation->arg_count : 0;
+        inst->port_count = inst->input_count + inst->output_count + inst->literal_count +
+                           inst->def_input_count + inst->def_output_count + inst->pattern_count;
+
+        if (reader_range(r, IMAGE_SECTION_PORTS, rec->port_first, inst->port_count) != 0)
+            return -1;
+
+        // Port vectors are used straight from the mapping
+        inst->ports = inst->port_count ? ports + rec->port_first : ports;
+        for (size_t i = 0; i < inst->port_count; ++i)
+            if (inst->ports[i] != SIGNAL_ID_NONE && inst->ports[i] >= signal_count)
+                return reader_fail(r, "port bound to an unknown signal");
+        if (inst->output_id != SIGNAL_ID_NONE && inst->output_id >= signal_count)
+            return reader_fail(r, "output bound to an unknown signal");
+
+        SignalId *cursor = inst->ports;
+        inst->input_ids = cursor;
+        cursor += inst->input_count;
+        inst->output_ids = cursor;
+        cursor += inst->output_count;
+        inst->literal_ids = cursor;
+        cursor += inst->literal_count;
+        inst->def_input_ids = cursor;
+        cursor += inst->def_input_count;
+        inst->def_output_ids = cursor;
+        cursor += inst->def_output_count;
+        inst->pattern_ids = cursor;
+
+        nodes[n].instance = inst;
+        *tail = &nodes[n];
+        tail = &nodes[n].next;
+        blk->instances_tail = &nodes[n];
+    }
+
+    return r->error ? -1 : 0;
+}
+
+NetlistImage *netlist_image_load(const char *path, Block *blk, SignalMap *signal_map)
+{
+    if (!path || !blk || !signal_map)
+        return NULL;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        LOG_ERROR("❌ Failed to open netlist image: %s", path);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        LOG_ERROR("❌ Empty or unreadable netlist image: %s", path);
+        close(fd);
+        return NULL;
+    }
+
+    // Private and writable so the in-place port vectors and rows can stay
+    // non-const in Instance/TruthTable; nothing writes to them after load
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        LOG_ERROR("❌ mmap failed for %s", path);
+        return NULL;
+    }
+
+    ImageReader r = {path, map, map, NULL};
+    if (!blk->arena)
+        blk->arena = arena_create(0);
+
+    Definition *defs = NULL;
+    Invocation *invs = NULL;
+    if (!blk->arena)
+        reader_fail(&r, "out of memory");
+    else if (validate_header(&r, size) == 0 && load_signals(&r, signal_map) == 0 &&
+             (defs = load_definitions(&r, blk)) != NULL && (invs = load_invocations(&r, blk)) != NULL)
+        load_instances(&r, blk, defs, invs, signal_map->count);
+    if (!r.error && defs)
+        block_index_definitions(blk);
+
+    if (!r.error && (!defs || !invs))
+        reader_fail(&r, "out of memory");
+
+    if (r.error)
+    {
+        LOG_ERROR("❌ Invalid netlist image %s: %s", path, r.error);
+        block_release(blk);
+        munmap(map, size);
+        return NULL;
+    }
+
+    NetlistImage *image = malloc(sizeof(NetlistImage));
+    if (!image)
+    {
+        block_release(blk);
+        munmap(map, size);
+        return NULL;
+    }
+    image->map = map;
+    image->size = size;
+
+    LOG_INFO("📦 Loaded netlist image %s: %u signals, %u definitions, %u invocations, %u instances",
+             path, reader_count(&r, IMAGE_SECTION_SIGNALS), reader_count(&r, IMAGE_SECTION_DEFINITIONS),
+             reader_count(&r, IMAGE_SECTION_INVOCATIONS), reader_count(&r, IMAGE_SECTION_INSTANCES));
+    return image;
+}
+
+void netlist_image_close(NetlistImage *image)
+{
+    if (!image)
+        return;
+    munmap(image->map, image->size);
+    free(image);
+}
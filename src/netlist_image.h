@@ -0,0 +1,94 @@
+#ifndef NETLIST_IMAGE_H
+#define NETLIST_IMAGE_H
+#include "block.h"
+#include "signal_map.h"
+#include <stdint.h>
+
+// Binary image of a compiled netlist: the signal table (with the values
+// published at compile time), the shared definitions and invocations, the
+// truth tables and each instance's port bindings. compile_block writes one
+// next to the stage directories; --load maps it and evaluates without
+// touching any S-expression.
+//
+// All records are fixed-width uint32 fields; strings are offsets into one
+// NUL-separated string section. Truth table rows and instance port vectors
+// are used in place from the mapping, everything else is rebuilt into the
+// Block's arena on load.
+
+#define NETLIST_IMAGE_FILE "netlist.rcimg"
+#define NETLIST_IMAGE_MAGIC "RCNETIMG"
+#define NETLIST_IMAGE_VERSION 1
+#define NETLIST_IMAGE_NONE UINT32_MAX    // Absent string or index
+
+typedef struct NetlistImageSection {
+    uint64_t offset;  // From the start of the file, 8-byte aligned
+    uint64_t count;   // Elements (bytes for the string section)
+} NetlistImageSection;
+
+enum {
+    IMAGE_SECTION_STRINGS,      // char
+    IMAGE_SECTION_NAMES,        // uint32 string offsets, sliced by the records below
+    IMAGE_SECTION_SIGNALS,      // ImageSignal, in SignalId order
+    IMAGE_SECTION_DEFINITIONS,  // ImageDefinition
+    IMAGE_SECTION_CASES,        // ImageCase
+    IMAGE_SECTION_ROWS,         // uint16 truth table rows
+    IMAGE_SECTION_INVOCATIONS,  // ImageInvocation
+    IMAGE_SECTION_INSTANCES,    // ImageInstance, in block order
+    IMAGE_SECTION_PORTS,        // SignalId
+    IMAGE_SECTION_COUNT
+};
+
+typedef struct NetlistImageHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;        // 0x01020304 as written; images are not portable across endianness
+    uint64_t file_size;
+    NetlistImageSection sections[IMAGE_SECTION_COUNT];
+} NetlistImageHeader;
+
+typedef struct ImageSignal {
+    uint32_t name;
+    uint32_t value;             // NETLIST_IMAGE_NONE if not driven
+} ImageSignal;
+
+typedef struct ImageDefinition {
+    uint32_t name;
+    uint32_t input_first, input_count;    // NAMES
+    uint32_t output_first, output_count;  // NAMES
+    uint32_t arg_first, arg_count;        // NAMES: conditional_invocation->pattern_args
+    uint32_t output;                      // NETLIST_IMAGE_NONE: no ConditionalInvocation
+    uint32_t case_first, case_count;      // CASES
+    uint32_t row_first;                   // ROWS (2^arg_count of them), or NETLIST_IMAGE_NONE
+} ImageDefinition;
+
+typedef struct ImageCase {
+    uint32_t pattern;
+    uint32_t result;
+} ImageCase;
+
+typedef struct ImageInvocation {
+    uint32_t target_name;
+    uint32_t input_first, input_count;    // NAMES
+    uint32_t output_first, output_count;  // NAMES
+    uint32_t literal_first, literal_count; // NAMES: name, value pairs
+} ImageInvocation;
+
+// Port counts follow from the definition and invocation, as in bind_instance_ports
+typedef struct ImageInstance {
+    uint32_t name;
+    uint32_t definition;
+    uint32_t invocation;
+    uint32_t port_first;        // PORTS
+    uint32_t output_id;
+} ImageInstance;
+
+typedef struct NetlistImage NetlistImage;
+
+int netlist_image_write(const Block *blk, SignalMap *signal_map, const char *path);
+
+// Fills an empty Block and SignalMap. The image must stay open while the
+// Block is in use: store it in blk->image and block_release closes it.
+NetlistImage *netlist_image_load(const char *path, Block *blk, SignalMap *signal_map);
+void netlist_image_close(NetlistImage *image);
+
+#endif
@@ -1,4 +1,5 @@
 
+#include "osc.h"
 #include "eval.h"
 #include "log.h"
 #include "mkrand.h"
@@ -6,17 +7,58 @@
 #include "tinyosc.h"
 #include "util.h"
 #include "wiring.h"
+#include "signal_store.h"
 #include <arpa/inet.h>
 #include <openssl/sha.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 #include <time.h>
-#include <signal.h>  // for sig_atomic_t
+#include <pthread.h>
 #include "config.h"
 
 #define OSC_BUFFER_SIZE 1024
 
+// Values for /poll, read without stalling the eval thread (see signal_store.h)
+static const SignalStore *osc_store = NULL;
+static StoreSnapshot osc_snapshot;
+
+void set_osc_signal_store(const SignalStore *store) {
+  osc_store = store;
+}
+
+// Listener thread started by start_osc_listener
+static pthread_t osc_thread;
+static int osc_running = 0;
+static Block *osc_block = NULL;
+
+static void *osc_thread_main(void *arg) {
+  (void)arg;
+  run_osc_listener(osc_block, &osc_running);
+  return NULL;
+}
+
+int start_osc_listener(Block *blk, const SignalStore *store) {
+  set_osc_signal_store(store);
+  osc_block = blk;
+  __atomic_store_n(&osc_running, 1, __ATOMIC_RELEASE);
+  if (pthread_create(&osc_thread, NULL, osc_thread_main, NULL) != 0) {
+    __atomic_store_n(&osc_running, 0, __ATOMIC_RELEASE);
+    LOG_ERROR("❌ Could not start the OSC listener thread");
+    return -1;
+  }
+  return 0;
+}
+
+void stop_osc_listener(void) {
+  if (!osc_block)
+    return;
+  __atomic_store_n(&osc_running, 0, __ATOMIC_RELEASE);
+  pthread_join(osc_thread, NULL); // Within a receive timeout
+  osc_block = NULL;
+  set_osc_signal_store(NULL);
+}
+
 char *enrich(const char *osc_path) {
   // Strip leading '/' if present
   const char *base_name = (osc_path[0] == '/') ? osc_path + 1 : osc_path;
@@ -165,7 +207,21 @@ int process_osc_message(Block* blk, const char *buffer, int len) {
 
     if (strcmp(osc.buffer, "/poll") == 0) {
       LOG_INFO("📡 Received /poll\n");
-      send_osc_response_str("/poll_response", "{\"status\":\"ok\"}");
+      if (!osc_store || signal_store_read(osc_store, &osc_snapshot) != 0) {
+        send_osc_response_str("/poll_response", "{\"status\":\"ok\"}");
+        return 0;
+      }
+
+      size_t driven = 0, high = 0;
+      for (size_t i = 0; i < osc_snapshot.count; ++i) {
+        driven += osc_snapshot.values[i] != NULL;
+        high += osc_snapshot.bits[i] == 1;
+      }
+      char status[128];
+      snprintf(status, sizeof(status),
+               "{\"status\":\"ok\",\"epoch\":%llu,\"signals\":%zu,\"driven\":%zu,\"high\":%zu}",
+               (unsigned long long)osc_snapshot.epoch, osc_snapshot.count, driven, high);
+      send_osc_response_str("/poll_response", status);
       return 0;
     }
 
@@ -253,8 +309,7 @@ void process_osc_response(Block* blk, char *buffer,  int len) {
 
 }
 
-void run_osc_listener(Block* blk,
-                      volatile sig_atomic_t *keep_running_ptr) {
+void run_osc_listener(Block* blk, const int *keep_running_ptr) {
   int sockfd;
   struct sockaddr_in servaddr, cliaddr;
   socklen_t len;
@@ -264,7 +319,7 @@ void run_osc_listener(Block* blk,
   sockfd = socket(AF_INET, SOCK_DGRAM, 0);
   if (sockfd < 0) {
     perror("socket failed");
-    exit(EXIT_FAILURE);
+    return;
   }
 
   memset(&servaddr, 0, sizeof(servaddr));
@@ -275,7 +330,7 @@ void run_osc_listener(Block* blk,
   if (bind(sockfd, (const struct sockaddr *)&servaddr, sizeof(servaddr)) < 0) {
     perror("bind failed");
     close(sockfd);
-    exit(EXIT_FAILURE);
+    return;
   }
 
   struct timeval timeout;
@@ -285,7 +340,7 @@ void run_osc_listener(Block* blk,
 
   LOG_INFO("🎧 Listening for OSC on port %d...\n", OSC_PORT_XMIT);
 
-  while (*keep_running_ptr) {
+  while (__atomic_load_n(keep_running_ptr, __ATOMIC_ACQUIRE)) {
     len = sizeof(cliaddr);
     n = recvfrom(sockfd, buffer, BUFFER_SIZE, 0, (struct sockaddr *)&cliaddr,
                  &len);
@@ -1,8 +1,15 @@
 #include "sqlite3.h"
 #include "eval.h"
+#include "signal_store.h"
 
-void run_osc_listener(Block* blk, volatile sig_atomic_t* keep_running_ptr);
+// Serves OSC on OSC_PORT_XMIT until *keep_running_ptr reads 0 (checked once a second)
+void run_osc_listener(Block* blk, const int* keep_running_ptr);
 void process_osc_response(Block* blk, char *buffer, int len);
 int process_osc_message(Block* blk, const char *buffer, int len);
 void send_osc_response_str(const char *address, const char *str);
 void send_osc_response(const char *address, float value);
+void set_osc_signal_store(const SignalStore *store); // /poll reports from this store
+// run_osc_listener on its own thread, with /poll answered from store
+int start_osc_listener(Block *blk, const SignalStore *store);
+void stop_osc_listener(void); // Returns once the listener thread has exited
+
@@ -0,0 +1,121 @@
+#define _GNU_SOURCE // syscall
+#include "perf_counter.h"
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+static int open_event(uint32_t type, uint64_t config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0); // This thread, any CPU
+}
+
+int perf_counters_open(PerfCounters *counters)
+{
+    static const struct { uint32_t type; uint64_t config; } events[PERF_COUNTER_COUNT] = {
+        [PERF_COUNTER_CACHE_REFERENCES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+        [PERF_COUNTER_CACHE_MISSES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        [PERF_COUNTER_L1D_READ_MISSES] = {PERF_TYPE_HW_CACHE,
+                                          PERF_COUNT_HW_CACHE_L1D | PERF_COUNT_HW_CACHE_OP_READ << 8 |
+                                              PERF_COUNT_HW_CACHE_RESULT_MISS << 16},
+        [PERF_COUNTER_INSTRUCTIONS] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    };
+
+    int available = 0;
+    memset(counters->values, 0, sizeof(counters->values));
+    for (int k = 0; k < PERF_COUNTER_COUNT; ++k)
+    {
+        counters->fds[k] = open_event(events[k].type, events[k].config);
+        available += counters->fds[k] >= 0;
+    }
+    return available;
+}
+
+void perf_counters_start(PerfCounters *counters)
+{
+    for (int k = 0; k < PERF_COUNTER_COUNT; ++k)
+    {
+        if (counters->fds[k] < 0)
+            continue;
+        ioctl(counters->fds[k], PERF_EVENT_IOC_RESET, 0);
+        ioctl(counters->fds[k], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void perf_counters_stop(PerfCounters *counters)
+{
+    for (int k = 0; k < PERF_COUNTER_COUNT; ++k)
+    {
+        counters->values[k] = 0;
+        if (counters->fds[k] < 0)
+            continue;
+        ioctl(counters->fds[k], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(counters->fds[k], &counters->values[k], sizeof(uint64_t)) != (ssize_t)sizeof(uint64_t))
+            counters->values[k] = 0;
+    }
+}
+
+#else
+
+int perf_counters_open(PerfCounters *counters)
+{
+    memset(counters->values, 0, sizeof(counters->values));
+    for (int k = 0; k < PERF_COUNTER_COUNT; ++k)
+        counters->fds[k] = -1;
+    return 0;
+}
+
+void perf_counters_start(PerfCounters *counters)
+{
+    (void)counters;
+}
+
+void perf_counters_stop(PerfCounters *counters)
+{
+    (void)counters;
+}
+
+#endif
+
+void perf_counters_close(PerfCounters *counters)
+{
+    for (int k = 0; k < PERF_COUNTER_COUNT; ++k)
+    {
+        if (counters->fds[k] >= 0)
+            close(counters->fds[k]);
+        counters->fds[k] = -1;
+    }
+}
+
+bool perf_counter_available(const PerfCounters *counters, PerfCounterKind kind)
+{
+    return counters->fds[kind] >= 0;
+}
+
+const char *perf_counter_name(PerfCounterKind kind)
+{
+    switch (kind)
+    {
+    case PERF_COUNTER_CACHE_REFERENCES:
+        return "cache-references";
+    case PERF_COUNTER_CACHE_MISSES:
+        return "cache-misses";
+    case PERF_COUNTER_L1D_READ_MISSES:
+        return "L1d-read-misses";
+    case PERF_COUNTER_INSTRUCTIONS:
+        return "instructions";
+    default:
+        return "?";
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef PERF_COUNTER_H
+#define PERF_COUNTER_H
+#include <stdbool.h>
+#include <stdint.h>
+
+// Hardware counters for the calling thread through perf_event_open (Linux).
+// Elsewhere, or when the kernel refuses (perf_event_paranoid, containers,
+// VMs without a PMU), the counters are simply unavailable.
+
+typedef enum {
+    PERF_COUNTER_CACHE_REFERENCES,
+    PERF_COUNTER_CACHE_MISSES,
+    PERF_COUNTER_L1D_READ_MISSES,
+    PERF_COUNTER_INSTRUCTIONS,
+    PERF_COUNTER_COUNT
+} PerfCounterKind;
+
+typedef struct PerfCounters {
+    int fds[PERF_COUNTER_COUNT];      // -1 where unavailable
+    uint64_t values[PERF_COUNTER_COUNT];
+} PerfCounters;
+
+int perf_counters_open(PerfCounters *counters); // Number of counters available
+void perf_counters_close(PerfCounters *counters);
+void perf_counters_start(PerfCounters *counters); // Reset and enable
+void perf_counters_stop(PerfCounters *counters);  // Disable and read into values
+
+bool perf_counter_available(const PerfCounters *counters, PerfCounterKind kind);
+const char *perf_counter_name(PerfCounterKind kind);
+
+#endif
@@ -3,8 +3,10 @@
 #include "gap.h"
 #include "mkrand.h"
 #include "signal_map.h"
+#include "pubsub.h"
 
 #include <czmq.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 #ifdef LOG_INFO
@@ -14,6 +16,21 @@
 
 static zsock_t *publisher = NULL;
 static zsock_t *subscriber = NULL;
+static zpoller_t *poller = NULL;  // On subscriber, for poll_pubsub's bounded wait
+static psi128_t node_psi;         // Stamped on our batches so poll_pubsub can skip its own echo
+
+// zsock_t is not thread-safe; parallel evaluation publishes from every worker
+static pthread_mutex_t publish_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Updates of the current round, sent as one GAP_SIGNAL_BATCH frame by
+// flush_signal_updates. The queue is kept across rounds. Guarded by publish_lock.
+#define GAP_BATCH_MAX 65536 // Updates per frame; a bigger round goes out in several
+
+static GAPUpdateValue *pending = NULL; // Values are interned (the map's own copy)
+static size_t pending_count = 0;
+static size_t pending_capacity = 0;
+static size_t pending_text = 0; // Bytes of non-bit values, NULs included
+static SignalMap *pending_map = NULL; // Whose ids are queued; its fingerprint goes in the batch
 
 /// Initialize PUB/SUB sockets using CZMQ.
 
@@ -23,10 +40,16 @@ void init_pubsub(void)
         publisher = zsock_new_pub("inproc://signals");
 
     if (!subscriber)
+    {
         subscriber = zsock_new_sub("inproc://signals", ""); // Subscribe to all topics
+        node_psi = mkrand_generate_ipv6();
+    }
 
     zsock_set_rcvtimeo(subscriber, 100); // ✅ Use CZMQ API, not zmq_setsockopt
 
+    if (!poller && subscriber)
+        poller = zpoller_new(subscriber, NULL);
+
     if (!publisher || !subscriber)
     {
         fprintf(stderr, "❌ Failed to initialize CZMQ PUB/SUB sockets.\n");
@@ -40,6 +63,8 @@ void init_pubsub(void)
 /// Clean up sockets (use at shutdown)
 void cleanup_pubsub(void)
 {
+    if (poller)
+        zpoller_destroy(&poller);
     if (publisher)
     {
         zsock_destroy(&publisher);
@@ -50,15 +75,31 @@ void cleanup_pubsub(void)
         zsock_destroy(&subscriber);
         subscriber = NULL;
     }
+    free(pending);
+    pending = NULL;
+    pending_count = pending_capacity = pending_text = 0;
     LOG_INFO("🧹 PubSub cleaned up.");
 }
 
+int publish_bit_changes(SignalMap *signal_map, const uint8_t *bits, const uint8_t *published, size_t count)
+{
+    int changes = 0;
+    for (SignalId id = 0; id < count && id < signal_map->count; ++id)
+    {
+        if (bits[id] == signal_map->bits[id] || bits[id] > 1)
+            continue;
+        const char *value = bits[id] ? "1" : "0";
+        if (published[id])
+            changes += publish_signal_id(signal_map, id, value);
+        else
+            signal_map_set(signal_map, id, value);
+    }
+    return changes;
+}
+
 /// Publish a packet over the PUB socket
 void publish_packet(const GAPPacket *packet)
 {
-    if (!publisher)
-        init_pubsub();
-
     size_t total_size = sizeof(GAPPacket) + packet->payload_len;
     zframe_t *frame = zframe_new(packet, total_size);
     if (!frame)
@@ -67,17 +108,119 @@ void publish_packet(const GAPPacket *packet)
         return;
     }
 
+    pthread_mutex_lock(&publish_lock);
+    if (!publisher)
+        init_pubsub();
+
     int rc = zframe_send(&frame, publisher, 0);
+    if (rc == 0)
+        zsock_flush(publisher);
+    pthread_mutex_unlock(&publish_lock);
+
     if (rc != 0)
     {
+        zframe_destroy(&frame);
         fprintf(stderr, "❌ Failed to send frame\n");
         return;
     }
-    zsock_flush(publisher);
     LOG_INFO("📤 Published %lu bytes", total_size);
 }
 
-GAPPacket *receive_packet(void)
+// Caller holds publish_lock. The frame is sized exactly and encoded in place.
+static void send_pending_updates(void)
+{
+    if (pending_count == 0)
+        return;
+
+    size_t payload_len = gap_signal_batch_size(pending_count, pending_text);
+    size_t total_size = sizeof(GAPPacket) + payload_len;
+    zframe_t *frame = zframe_new(NULL, total_size);
+    if (!frame)
+    {
+        fprintf(stderr, "❌ Failed to allocate zframe.\n");
+        pending_count = pending_text = 0;
+        return;
+    }
+
+    GAPPacket *pkt = (GAPPacket *)zframe_data(frame);
+    memset(pkt, 0, sizeof(GAPPacket));
+    pkt->version = 1;
+    pkt->type = GAP_SIGNAL_BATCH;
+    pkt->psi = node_psi;
+    pkt->from = in6addr_loopback;
+    pkt->to = in6addr_loopback;
+    pkt->payload_len = (uint32_t)payload_len;
+
+    gap_encode_signal_batch((GAPSignalBatch *)pkt->payload, signal_map_fingerprint(pending_map), pending,
+                            pending_count);
+    size_t sent = pending_count;
+    pending_count = pending_text = 0;
+
+    if (!publisher)
+        init_pubsub();
+    if (zframe_send(&frame, publisher, 0) != 0)
+    {
+        zframe_destroy(&frame);
+        fprintf(stderr, "❌ Failed to send frame\n");
+        return;
+    }
+    zsock_flush(publisher);
+    LOG_INFO("📤 Published %zu signal update(s) in %zu bytes", sent, total_size);
+}
+
+// Caller holds publish_lock
+static void queue_update(SignalMap *signal_map, SignalId id, const char *value)
+{
+    if (pending_count > 0 && signal_map != pending_map)
+        send_pending_updates(); // A batch carries the ids of one map
+    pending_map = signal_map;
+
+    if (pending_count == pending_capacity)
+    {
+        size_t capacity = pending_capacity ? pending_capacity * 2 : 256;
+        GAPUpdateValue *grown = realloc(pending, capacity * sizeof(GAPUpdateValue));
+        if (!grown)
+        {
+            LOG_ERROR("❌ Out of memory queueing update for signal %u", (unsigned)id);
+            return;
+        }
+        pending = grown;
+        pending_capacity = capacity;
+    }
+
+    pending[pending_count].id = id;
+    pending[pending_count].value = value;
+    pending_count++;
+    pending_text += gap_value_text_len(value);
+
+    if (pending_count >= GAP_BATCH_MAX)
+        send_pending_updates();
+}
+
+void publish_stored_signals(SignalMap *signal_map, const SignalId *ids, size_t count)
+{
+    if (!signal_map || !ids || count == 0)
+        return;
+
+    pthread_mutex_lock(&publish_lock);
+    for (size_t i = 0; i < count; ++i)
+        if (ids[i] < signal_map->count && signal_map->entries[ids[i]].value)
+            queue_update(signal_map, ids[i], signal_map->entries[ids[i]].value);
+    pthread_mutex_unlock(&publish_lock);
+
+    LOG_INFO("📡 Publishing %zu stored signal change(s)", count);
+}
+
+void flush_signal_updates(void)
+{
+    pthread_mutex_lock(&publish_lock);
+    send_pending_updates();
+    pthread_mutex_unlock(&publish_lock);
+}
+
+// Next frame holding a complete GAPPacket; the packet points into the frame.
+// Blocks up to the socket's receive timeout unless nowait is set.
+static zframe_t *receive_frame(const GAPPacket **packet, int nowait)
 {
     if (!subscriber)
     {
@@ -85,10 +228,11 @@ GAPPacket *receive_packet(void)
         return NULL;
     }
 
-    zframe_t *frame = zframe_recv(subscriber);
+    zframe_t *frame = nowait ? zframe_recv_nowait(subscriber) : zframe_recv(subscriber);
     if (!frame)
     {
-        LOG_WARN("⚠️  No frame received");
+        if (!nowait)
+            LOG_WARN("⚠️  No frame received");
         return NULL;
     }
 
@@ -100,9 +244,7 @@ GAPPacket *receive_packet(void)
         return NULL;
     }
 
-    const uint8_t *data = zframe_data(frame);
-    const GAPPacket *hdr = (const GAPPacket *)data;
-
+    const GAPPacket *hdr = (const GAPPacket *)zframe_data(frame);
     size_t expected_size = sizeof(GAPPacket) + hdr->payload_len;
     if (size < expected_size)
     {
@@ -111,6 +253,19 @@ GAPPacket *receive_packet(void)
         return NULL;
     }
 
+    *packet = hdr;
+    return frame;
+}
+
+GAPPacket *receive_packet(void)
+{
+    const GAPPacket *hdr = NULL;
+    zframe_t *frame = receive_frame(&hdr, 0);
+    if (!frame)
+        return NULL;
+
+    const uint8_t *data = (const uint8_t *)hdr;
+    size_t expected_size = sizeof(GAPPacket) + hdr->payload_len;
     GAPPacket *pkt = malloc(expected_size);
     if (!pkt)
     {
@@ -124,52 +279,85 @@ GAPPacket *receive_packet(void)
     return pkt;
 }
 
-void poll_pubsub(SignalMap *signal_map)
+int poll_pubsub(SignalMap *signal_map, int wait_ms)
+{
+    return poll_pubsub_changes(signal_map, wait_ms, NULL, NULL);
+}
+
+int poll_pubsub_changes(SignalMap *signal_map, int wait_ms, void (*on_change)(void *ctx, SignalId id), void *ctx)
 {
     int received = 0;
+    int changes = 0;
+
+    flush_signal_updates(); // A round ends here: send what it changed
+
+    // Only the first frame may be waited for; the rest of the queue is drained without blocking
+    if (wait_ms > 0 && poller && !zpoller_wait(poller, wait_ms))
+    {
+        LOG_INFO("Polled, no traffic within %d ms", wait_ms);
+        return 0;
+    }
 
     while (1)
     {
-        GAPPacket *packet = receive_packet();
-        if (!packet)
-        {
-            LOG_INFO("Polled, no traffic");
+        // Decoded straight out of the frame; nothing is copied
+        const GAPPacket *packet = NULL;
+        zframe_t *frame = receive_frame(&packet, 1);
+        if (!frame)
             break;
+
+        const GAPSignalBatch *batch = gap_signal_batch(packet);
+        if (!batch)
+        {
+            LOG_WARN("⚠️ Malformed or unexpected pubsub packet (type %d, %u byte payload)",
+                     (int)packet->type, (unsigned)packet->payload_len);
+            zframe_destroy(&frame);
+            continue;
         }
-        const char *payload = (const char *)packet->payload;
-        if (!payload || packet->payload_len == 0)
+        if (memcmp(&packet->psi, &node_psi, sizeof(node_psi)) == 0)
         {
-            LOG_WARN("⚠️ PubSub packet has empty payload");
-            free(packet);
+            zframe_destroy(&frame); // Our own updates, already in the map
             continue;
         }
-
-        // Assuming payload is formatted as: "SIGNAL_NAME=VALUE"
-        const char *sep = strchr(payload, '=');
-        if (!sep)
+        if (batch->signal_table != signal_map_fingerprint(signal_map))
         {
-            LOG_WARN("⚠️ Malformed pubsub payload: %s", payload);
-            free(packet);
+            LOG_ERROR("❌ Dropped a batch of %u update(s) numbered for another signal table (%016llx, ours %016llx)",
+                      (unsigned)batch->count, (unsigned long long)batch->signal_table,
+                      (unsigned long long)signal_map_fingerprint(signal_map));
+            zframe_destroy(&frame);
             continue;
         }
 
-        size_t name_len = sep - payload;
-        char signal_name[256];
-        char signal_value[256];
-
-        snprintf(signal_name, sizeof(signal_name), "%.*s", (int)name_len, payload);
-        snprintf(signal_value, sizeof(signal_value), "%s", sep + 1);
-
-        LOG_INFO("📬 PubSub delivered: %s = %s", signal_name, signal_value);
-
-        free(packet);
-        received++;
+        for (uint32_t i = 0; i < batch->count; ++i)
+        {
+            const GAPSignalUpdate *update = &batch->updates[i];
+            const char *value = gap_update_value(batch, update);
+            const char *signal_name = signal_map_name(signal_map, update->id);
+            if (!value || !signal_name)
+            {
+                LOG_WARN("⚠️ Bad update in pubsub batch: signal %u", (unsigned)update->id);
+                continue;
+            }
+            // Stored, not re-published: the sender's subscribers already have it
+            int changed = signal_map_set(signal_map, update->id, value);
+            LOG_INFO("📬 PubSub delivered: %s = %s%s", signal_name, value, changed ? "" : " (unchanged)");
+            if (changed && on_change)
+                on_change(ctx, update->id);
+            changes += changed;
+            received++;
+        }
+        zframe_destroy(&frame);
     }
 
     if (received > 0)
     {
-        LOG_INFO("📡 PubSub polling complete — %d signal(s) injected", received);
+        LOG_INFO("📡 PubSub polling complete — %d signal(s) injected, %d changed", received, changes);
     }
+    else
+    {
+        LOG_INFO("Polled, no traffic");
+    }
+    return changes;
 }
 
 /// Loop receiving packets on the SUB socket and invoking a callback
@@ -191,45 +379,25 @@ void subscribe_loop(void (*on_packet)(const GAPPacket *packet))
     }
 }
 
-void publish_signal(SignalMap* signal_map, const char *signal_name, const char *value)
+int publish_signal(SignalMap* signal_map, const char *signal_name, const char *value)
 {
+    return publish_signal_id(signal_map, signal_map_intern(signal_map, signal_name), value);
+}
 
-    update_signal_value(signal_map, signal_name, value);
-
-    if (!publisher)
-        init_pubsub();
-
-    // Construct payload as "signal_name=value"
-    char payload[512]; // Arbitrary upper bound; increase if needed
-    int written = snprintf(payload, sizeof(payload), "%s=%s", signal_name, value);
-
-    if (written < 0 || written >= sizeof(payload))
-    {
-        fprintf(stderr, "❌ Payload too long or formatting error\n");
-        return;
-    }
-
-    size_t payload_len = (size_t)written + 1; // Include null terminator
-
-    GAPPacket *pkt = malloc(sizeof(GAPPacket) + payload_len);
-    if (!pkt)
-    {
-        fprintf(stderr, "❌ Failed to allocate GAPPacket\n");
-        return;
-    }
+int publish_signal_id(SignalMap* signal_map, SignalId id, const char *value)
+{
+    const char *signal_name = signal_map_name(signal_map, id);
+    if (!signal_name || !value)
+        return 0;
 
-    memset(pkt, 0, sizeof(GAPPacket) + payload_len);
-    pkt->version = 1;
-    pkt->type = GAP_SIGNAL;
-    pkt->from = in6addr_loopback;
-    pkt->to = in6addr_loopback;
-    pkt->payload_len = payload_len;
+    if (!signal_map_set(signal_map, id, value))
+        return 0; // 💤 Unchanged — subscribers already have this value
 
-    memcpy(pkt->payload, payload, payload_len);
+    pthread_mutex_lock(&publish_lock);
+    queue_update(signal_map, id, signal_map->entries[id].value); // Sent with the round (flush_signal_updates)
+    pthread_mutex_unlock(&publish_lock);
 
     LOG_INFO("📡 Publishing signal: %s = %s", signal_name, value);
-
-    publish_packet(pkt);
-    free(pkt);
+    return 1;
 }
 
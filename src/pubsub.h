@@ -2,8 +2,24 @@
 #include "signal_map.h"
 void init_pubsub(void) ;
 void cleanup_pubsub(void);
-void publish_signal(SignalMap* signal_map, const char *signal_name, const char *value);
-void subscribe_loop(void (*on_signal)(const char *signal, const char *value));
+// Both return 1 if the value changed; unchanged values are not re-published
+int publish_signal(SignalMap* signal_map, const char *signal_name, const char *value);
+int publish_signal_id(SignalMap* signal_map, SignalId id, const char *value);
+// Copies back a 0/1 bit array evaluated outside the map (native code, bytecode VM):
+// ids marked in published[] are published, the rest (literals) only stored.
+// Returns the number of published changes.
+int publish_bit_changes(SignalMap *signal_map, const uint8_t *bits, const uint8_t *published, size_t count);
+void subscribe_loop(void (*on_packet)(const GAPPacket *packet));
 void publish_packet(const GAPPacket *packet);
-void poll_pubsub(SignalMap *signal_map);
+// Queues values already stored with signal_map_set (parallel workers, which
+// must not take the publish lock per gate) for the next flush
+void publish_stored_signals(SignalMap *signal_map, const SignalId *ids, size_t count);
+// Sends the updates queued since the last flush as one GAP_SIGNAL_BATCH frame
+void flush_signal_updates(void);
+// Flushes, then drains the SUB socket without blocking (waiting up to wait_ms
+// for a first frame if wait_ms > 0) and stores other nodes' updates in the map.
+// Returns the number of signals that changed.
+int poll_pubsub(SignalMap *signal_map, int wait_ms);
+// As poll_pubsub, and calls on_change for every signal a batch changed
+int poll_pubsub_changes(SignalMap *signal_map, int wait_ms, void (*on_change)(void *ctx, SignalId id), void *ctx);
 GAPPacket *receive_packet(void);
@@ -4,6 +4,7 @@
 #include "eval_util.h"
 #include "string_list.h"
 #include "signal_map.h"
+#include "intern.h"
 #include <stdio.h>  // for asprintf
 #include <stdlib.h> // for free
 #include <string.h> // for strcmp
@@ -11,35 +12,65 @@
 #include <stdio.h>
 #include <string.h>
 
-NameCounter *counters = NULL;
+// Open-addressing table keyed by interned name; NULL name marks a free slot
+static NameCounter *counters = NULL;
+static size_t counter_slot_count = 0; // Power of two
+static size_t counter_count = 0;
+
+static NameCounter *counter_slot(NameCounter *slots, size_t slot_count, const char *key)
+{
+    size_t mask = slot_count - 1;
+    size_t slot = intern_hash(key) & mask;
+    while (slots[slot].name && slots[slot].name != key)
+        slot = (slot + 1) & mask;
+    return &slots[slot];
+}
+
+static int grow_counters(void)
+{
+    size_t new_count = counter_slot_count ? counter_slot_count * 2 : 64;
+    NameCounter *slots = calloc(new_count, sizeof(NameCounter));
+    if (!slots)
+        return -1;
+    for (size_t i = 0; i < counter_slot_count; ++i)
+        if (counters[i].name)
+            *counter_slot(slots, new_count, counters[i].name) = counters[i];
+    free(counters);
+    counters = slots;
+    counter_slot_count = new_count;
+    return 0;
+}
 
 int get_next_instance_id(const char *name)
 {
-    for (NameCounter *nc = counters; nc; nc = nc->next)
+    const char *key = intern(name);
+    if (!key)
+        return -1;
+
+    // Keep the load factor under 1/2 so probe chains stay short
+    if ((counter_count + 1) * 2 > counter_slot_count && grow_counters() != 0)
     {
-        if (strcmp(nc->name, name) == 0)
-        {
-            return ++nc->count;
-        }
+        LOG_ERROR("❌ Failed to grow the instance id table");
+        return -1;
     }
-    NameCounter *nc = calloc(1, sizeof(NameCounter));
-    nc->name = strdup(name);
+
+    NameCounter *nc = counter_slot(counters, counter_slot_count, key);
+    if (nc->name)
+        return ++nc->count;
+
+    nc->name = key;
     nc->count = 0;
-    nc->next = counters;
-    counters = nc;
+    counter_count++;
     return 0;
 }
 
 
 void cleanup_name_counters(void)
 {
-    while (counters)
-    {
-        NameCounter *next = counters->next;
-        free((void *)counters->name);
-        free(counters);
-        counters = next;
-    }
+    free(counters);
+    counters = NULL;
+    counter_slot_count = 0;
+    counter_count = 0;
 }
 
 void qualify_literal_bindings(Invocation *inv, const char *instance_name)
@@ -65,9 +96,8 @@ void qualify_literal_bindings(Invocation *inv, const char *instance_name)
         char buf[256];
         snprintf(buf, sizeof(buf), "%s.%s", instance_name, b->name);
 
-        free(b->name);
-        b->name = strdup(buf);
         LOG_INFO("🔁 Literal binding qualified: %s → %s", b->name, buf);
+        b->name = intern(buf);
     }
 }
 
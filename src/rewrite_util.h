@@ -8,13 +8,11 @@ int qualify_local_signals(Block *blk);
 void cleanup_name_counters(void);
 int get_next_instance_id(const char *name);
 
+// Per-name instance counter; one slot of get_next_instance_id's hash table
 typedef struct NameCounter {
-  const char *name;
+  const char *name; // Interned
   int count;
-  struct NameCounter *next;
 } NameCounter;
 
-extern NameCounter *counters;
-
 
 #endif // REWRITE_UTIL_H
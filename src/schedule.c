@@ -0,0 +1,353 @@
+#include "schedule.h"
+#include "fanout.h"
+#include "log.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define UNVISITED UINT32_MAX
+
+// Successor lists (CSR): instance ordinal → instances that read what it writes
+typedef struct DependencyGraph {
+    uint32_t *offsets;    // instance_count + 1
+    uint32_t *succ;
+} DependencyGraph;
+
+typedef struct SortKey {
+    uint32_t level;
+    uint32_t group;       // 0 = static, else 1 + lowest ordinal in the loop
+    uint32_t ordinal;
+} SortKey;
+
+// Output first, then literal bindings; returns the count
+static size_t instance_writes(const Instance *inst, SignalId *out)
+{
+    size_t n = 0;
+    out[n++] = inst->output_id;
+    for (size_t i = 0; i < inst->literal_count; ++i)
+        out[n++] = inst->literal_ids[i];
+    return n;
+}
+
+static int build_graph(const FanoutIndex *fanout, DependencyGraph *graph)
+{
+    size_t n = fanout->instance_count;
+    size_t max_writes = 1;
+    for (size_t i = 0; i < n; ++i)
+        if (fanout->instances[i] && fanout->instances[i]->literal_count + 1 > max_writes)
+            max_writes = fanout->instances[i]->literal_count + 1;
+
+    SignalId *writes = malloc(sizeof(SignalId) * max_writes);
+    graph->offsets = calloc(n + 1, sizeof(uint32_t));
+    if (!writes || !graph->offsets)
+    {
+        free(writes);
+        return -1;
+    }
+
+    // Pass 1: count, pass 2: fill (as in build_fanout_index)
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Instance *inst = fanout->instances[i];
+            size_t edge = pass ? graph->offsets[i] : 0;
+            size_t wn = inst ? instance_writes(inst, writes) : 0;
+            for (size_t w = 0; w < wn; ++w)
+            {
+                size_t reader_count = 0;
+                const uint32_t *readers = fanout_readers(fanout, writes[w], &reader_count);
+                for (size_t r = 0; r < reader_count; ++r)
+                {
+                    // An instance publishes its literals before it evaluates,
+                    // so reading one of them back is not feedback
+                    if (w > 0 && readers[r] == i)
+                        continue;
+                    if (pass)
+                        graph->succ[edge] = readers[r];
+                    edge++;
+                }
+            }
+            if (!pass)
+                graph->offsets[i + 1] = graph->offsets[i] + (uint32_t)edge;
+        }
+
+        if (!pass)
+        {
+            graph->succ = malloc(sizeof(uint32_t) * (graph->offsets[n] ? graph->offsets[n] : 1));
+            if (!graph->succ)
+            {
+                free(writes);
+                return -1;
+            }
+        }
+    }
+
+    free(writes);
+    return 0;
+}
+
+typedef struct TarjanFrame {
+    uint32_t node;
+    uint32_t edge;
+} TarjanFrame;
+
+/**
+ * Iterative Tarjan, so deep chains cannot overflow the C stack. Components
+ * are numbered in the order they complete, which is reverse topological.
+ */
+static size_t find_components(const DependencyGraph *graph, size_t n, uint32_t *component)
+{
+    uint32_t *index = malloc(sizeof(uint32_t) * (n ? n : 1));
+    uint32_t *lowlink = malloc(sizeof(uint32_t) * (n ? n : 1));
+    uint32_t *stack = malloc(sizeof(uint32_t) * (n ? n : 1));
+    bool *on_stack = calloc(n ? n : 1, sizeof(bool));
+    TarjanFrame *frames = malloc(sizeof(TarjanFrame) * (n ? n : 1));
+    if (!index || !lowlink || !stack || !on_stack || !frames)
+    {
+        free(index);
+        free(lowlink);
+        free(stack);
+        free(on_stack);
+        free(frames);
+        return SIZE_MAX;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        index[i] = UNVISITED;
+
+    uint32_t next_index = 0;
+    size_t depth = 0, stack_size = 0, component_count = 0;
+
+    for (uint32_t root = 0; root < n; ++root)
+    {
+        if (index[root] != UNVISITED)
+            continue;
+
+        index[root] = lowlink[root] = next_index++;
+        stack[stack_size++] = root;
+        on_stack[root] = true;
+        frames[depth++] = (TarjanFrame){root, graph->offsets[root]};
+
+        while (depth > 0)
+        {
+            TarjanFrame *f = &frames[depth - 1];
+            uint32_t v = f->node;
+
+            if (f->edge < graph->offsets[v + 1])
+            {
+                uint32_t w = graph->succ[f->edge++];
+                if (index[w] == UNVISITED)
+                {
+                    index[w] = lowlink[w] = next_index++;
+                    stack[stack_size++] = w;
+                    on_stack[w] = true;
+                    frames[depth++] = (TarjanFrame){w, graph->offsets[w]};
+                }
+                else if (on_stack[w] && index[w] < lowlink[v])
+                {
+                    lowlink[v] = index[w];
+                }
+                continue;
+            }
+
+            if (lowlink[v] == index[v])
+            {
+                uint32_t w;
+                do
+                {
+                    w = stack[--stack_size];
+                    on_stack[w] = false;
+                    component[w] = (uint32_t)component_count;
+                } while (w != v);
+                component_count++;
+            }
+
+            depth--;
+            if (depth > 0 && lowlink[v] < lowlink[frames[depth - 1].node])
+                lowlink[frames[depth - 1].node] = lowlink[v];
+        }
+    }
+
+    free(index);
+    free(lowlink);
+    free(stack);
+    free(on_stack);
+    free(frames);
+    return component_count;
+}
+
+static int compare_sort_keys(const void *a, const void *b)
+{
+    const SortKey *x = a, *y = b;
+    if (x->level != y->level)
+        return x->level < y->level ? -1 : 1;
+    if (x->group != y->group)
+        return x->group < y->group ? -1 : 1;
+    return x->ordinal < y->ordinal ? -1 : (x->ordinal > y->ordinal);
+}
+
+Schedule *build_schedule(Block *blk, SignalMap *signal_map)
+{
+    if (!blk || !signal_map)
+        return NULL;
+
+    FanoutIndex *fanout = build_fanout_index(blk, signal_map);
+    if (!fanout)
+        return NULL;
+
+    size_t n = fanout->instance_count;
+    Schedule *schedule = calloc(1, sizeof(Schedule));
+    DependencyGraph graph = {0};
+    uint32_t *component = malloc(sizeof(uint32_t) * (n ? n : 1));
+    SortKey *keys = malloc(sizeof(SortKey) * (n ? n : 1));
+    uint32_t *level = NULL, *component_size = NULL, *component_min = NULL;
+    bool *cyclic = NULL;
+    size_t component_count = SIZE_MAX;
+
+    if (!schedule || !component || !keys || build_graph(fanout, &graph) != 0)
+        goto fail;
+
+    component_count = find_components(&graph, n, component);
+    if (component_count == SIZE_MAX)
+        goto fail;
+
+    size_t cc = component_count ? component_count : 1;
+    level = calloc(cc, sizeof(uint32_t));
+    component_size = calloc(cc, sizeof(uint32_t));
+    component_min = malloc(sizeof(uint32_t) * cc);
+    cyclic = calloc(cc, sizeof(bool));
+    schedule->instances = malloc(sizeof(Instance *) * (n ? n : 1));
+    schedule->order = malloc(sizeof(uint32_t) * (n ? n : 1));
+    schedule->steps = malloc(sizeof(ScheduleStep) * (n ? n : 1));
+    if (!level || !component_size || !component_min || !cyclic || !schedule->instances || !schedule->order || !schedule->steps)
+        goto fail;
+
+    for (size_t c = 0; c < component_count; ++c)
+        component_min[c] = UINT32_MAX;
+
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        uint32_t c = component[v];
+        component_size[c]++;
+        if (v < component_min[c])
+            component_min[c] = v;
+        for (uint32_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e)
+            if (graph.succ[e] == v)
+                cyclic[c] = true; // Reads its own output
+    }
+
+    // Components completed in reverse topological order; walk them from the
+    // last one back so a component's level is final before it raises its successors.
+    uint32_t *by_component = malloc(sizeof(uint32_t) * (n ? n : 1));
+    uint32_t *component_first = calloc(cc + 1, sizeof(uint32_t));
+    if (!by_component || !component_first)
+    {
+        free(by_component);
+        free(component_first);
+        goto fail;
+    }
+    for (uint32_t v = 0; v < n; ++v)
+        component_first[component[v] + 1]++;
+    for (size_t c = 0; c < component_count; ++c)
+        component_first[c + 1] += component_first[c];
+    for (uint32_t v = 0; v < n; ++v)
+        by_component[component_first[component[v]] + --component_size[component[v]]] = v;
+    for (size_t c = 0; c < component_count; ++c)
+        component_size[c] = component_first[c + 1] - component_first[c];
+
+    for (size_t k = component_count; k-- > 0;)
+    {
+        if (component_size[k] > 1)
+            cyclic[k] = true;
+        for (uint32_t m = component_first[k]; m < component_first[k + 1]; ++m)
+        {
+            uint32_t v = by_component[m];
+            for (uint32_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e)
+            {
+                uint32_t c = component[graph.succ[e]];
+                if (c != k && level[c] < level[k] + 1)
+                    level[c] = level[k] + 1;
+            }
+        }
+    }
+    free(by_component);
+    free(component_first);
+
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        uint32_t c = component[v];
+        keys[v].level = level[c];
+        keys[v].group = cyclic[c] ? component_min[c] + 1 : 0;
+        keys[v].ordinal = v;
+    }
+    qsort(keys, n, sizeof(SortKey), compare_sort_keys);
+
+    memcpy(schedule->instances, fanout->instances, sizeof(Instance *) * n);
+    schedule->instance_count = n;
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        schedule->order[i] = keys[i].ordinal;
+
+        bool same_step = i > 0 && keys[i].level == keys[i - 1].level && keys[i].group == keys[i - 1].group;
+        if (same_step)
+        {
+            schedule->steps[schedule->step_count - 1].count++;
+        }
+        else
+        {
+            ScheduleStep *step = &schedule->steps[schedule->step_count++];
+            step->first = i;
+            step->count = 1;
+            step->level = keys[i].level;
+            step->iterative = keys[i].group != 0;
+            if (step->iterative)
+                schedule->loop_count++;
+        }
+
+        if (keys[i].group)
+            schedule->iterative_count++;
+        else
+            schedule->static_count++;
+        if (keys[i].level + 1 > schedule->level_count)
+            schedule->level_count = keys[i].level + 1;
+    }
+
+    LOG_INFO("📐 Schedule: %zu instance(s) static in %zu level(s), %zu instance(s) iterative in %zu feedback loop(s)",
+             schedule->static_count, schedule->level_count, schedule->iterative_count, schedule->loop_count);
+
+    free(graph.offsets);
+    free(graph.succ);
+    free(component);
+    free(keys);
+    free(level);
+    free(component_size);
+    free(component_min);
+    free(cyclic);
+    destroy_fanout_index(fanout);
+    return schedule;
+
+fail:
+    LOG_ERROR("❌ Failed to build evaluation schedule");
+    free(graph.offsets);
+    free(graph.succ);
+    free(component);
+    free(keys);
+    free(level);
+    free(component_size);
+    free(component_min);
+    free(cyclic);
+    destroy_schedule(schedule);
+    destroy_fanout_index(fanout);
+    return NULL;
+}
+
+void destroy_schedule(Schedule *schedule)
+{
+    if (!schedule)
+        return;
+    free(schedule->instances);
+    free(schedule->order);
+    free(schedule->steps);
+    free(schedule);
+}
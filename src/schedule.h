@@ -0,0 +1,38 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+#include "block.h"
+#include "signal_map.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Static evaluation order for a Block. Instances are nodes; an edge runs
+// from the instance that writes a signal (its output or a literal binding)
+// to every instance that reads it. Strongly connected components are found
+// with Tarjan's algorithm and the condensed DAG is split into levels: every
+// driver of a level is in an earlier level, so an acyclic netlist settles in
+// one pass. Each feedback loop (an SCC with more than one instance, or one
+// that reads its own output) becomes an iterative step inside its level.
+
+typedef struct ScheduleStep {
+    uint32_t first;       // Into Schedule.order
+    uint32_t count;
+    uint32_t level;
+    bool iterative;       // Feedback loop: re-run until stable
+} ScheduleStep;
+
+typedef struct Schedule {
+    Instance **instances;     // Instance ordinal → Instance (block list order)
+    size_t instance_count;
+    uint32_t *order;          // Instance ordinals, step by step
+    ScheduleStep *steps;
+    size_t step_count;
+    size_t level_count;
+    size_t static_count;      // Instances evaluated exactly once
+    size_t iterative_count;   // Instances inside feedback loops
+    size_t loop_count;
+} Schedule;
+
+Schedule *build_schedule(Block *blk, SignalMap *signal_map); // Logs the static/iterative split
+void destroy_schedule(Schedule *schedule);
+
+#endif
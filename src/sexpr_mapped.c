@@ -0,0 +1,237 @@
+#include "sexpr_parser.h"
+#include "intern.h"
+#include "log.h"
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * mmap-backed S-expression parser.
+ *
+ * The file is mapped read-only and parsed in two passes over the mapping:
+ *   1. scan:  count nodes and record each list's child count (preorder)
+ *   2. build: fill one SExpr array and one child-pointer array, both sized
+ *             exactly, so no node or list is ever reallocated.
+ * Atoms are interned straight out of the mapping (see intern.h), so the tree
+ * does not reference the mapping and it is unmapped before returning.
+ *
+ * Grammar and edge cases match parse_sexpr: one top-level expression,
+ * unclosed lists end at EOF, and trailing input is ignored.
+ */
+
+typedef struct SExprScan {
+  size_t node_count;
+  size_t child_count;
+  uint32_t *list_sizes; // Child count of each list, in preorder
+  size_t list_count;
+  size_t list_capacity;
+} SExprScan;
+
+typedef struct SExprBuild {
+  const char *cur;
+  const char *end;
+  SExpr *nodes;
+  size_t next_node;
+  SExpr **slots;
+  size_t next_slot;
+  const uint32_t *list_sizes;
+  size_t next_list;
+} SExprBuild;
+
+static const char *skip_space(const char *p, const char *end)
+{
+  while (p < end && isspace((unsigned char)*p))
+    p++;
+  return p;
+}
+
+static const char *atom_end(const char *p, const char *end)
+{
+  while (p < end && !isspace((unsigned char)*p) && *p != '(' && *p != ')')
+    p++;
+  return p;
+}
+
+static int scan_open_list(SExprScan *scan, uint32_t **stack, size_t *depth, size_t *stack_capacity)
+{
+  if (scan->list_count == scan->list_capacity)
+  {
+    size_t capacity = scan->list_capacity ? scan->list_capacity * 2 : 64;
+    uint32_t *sizes = realloc(scan->list_sizes, sizeof(uint32_t) * capacity);
+    if (!sizes)
+      return -1;
+    scan->list_sizes = sizes;
+    scan->list_capacity = capacity;
+  }
+  if (*depth == *stack_capacity)
+  {
+    size_t capacity = *stack_capacity ? *stack_capacity * 2 : 32;
+    uint32_t *grown = realloc(*stack, sizeof(uint32_t) * capacity);
+    if (!grown)
+      return -1;
+    *stack = grown;
+    *stack_capacity = capacity;
+  }
+
+  scan->list_sizes[scan->list_count] = 0;
+  (*stack)[(*depth)++] = (uint32_t)scan->list_count++;
+  scan->node_count++;
+  return 0;
+}
+
+// Pass 1: iterative, so arbitrarily deep input cannot overflow the C stack
+static int scan_sexpr(const char *p, const char *end, SExprScan *scan)
+{
+  uint32_t *stack = NULL;
+  size_t depth = 0, stack_capacity = 0;
+
+  p = skip_space(p, end);
+  if (p >= end || *p != '(')
+  {
+    scan->node_count = 1; // single (possibly empty) atom
+    return 0;
+  }
+
+  if (scan_open_list(scan, &stack, &depth, &stack_capacity) != 0)
+    goto fail;
+  p++;
+
+  while (depth > 0)
+  {
+    p = skip_space(p, end);
+    if (p >= end)
+      break; // unclosed lists end at EOF
+
+    if (*p == ')')
+    {
+      depth--;
+      p++;
+      continue;
+    }
+
+    scan->list_sizes[stack[depth - 1]]++;
+    scan->child_count++;
+
+    if (*p == '(')
+    {
+      if (scan_open_list(scan, &stack, &depth, &stack_capacity) != 0)
+        goto fail;
+      p++;
+    }
+    else
+    {
+      p = atom_end(p, end);
+      scan->node_count++;
+    }
+  }
+
+  free(stack);
+  return 0;
+
+fail:
+  free(stack);
+  return -1;
+}
+
+// Pass 2: same walk, writing into the preallocated arrays
+static SExpr *build_sexpr(SExprBuild *b)
+{
+  b->cur = skip_space(b->cur, b->end);
+  SExpr *node = &b->nodes[b->next_node++];
+
+  if (b->cur < b->end && *b->cur == '(')
+  {
+    b->cur++;
+    node->type = S_EXPR_LIST;
+    node->atom = NULL;
+    node->count = b->list_sizes[b->next_list++];
+    node->list = node->count ? &b->slots[b->next_slot] : NULL;
+    b->next_slot += node->count;
+
+    for (size_t i = 0; i < node->count; ++i)
+      node->list[i] = build_sexpr(b);
+
+    b->cur = skip_space(b->cur, b->end);
+    if (b->cur < b->end && *b->cur == ')')
+      b->cur++;
+    return node;
+  }
+
+  const char *start = b->cur;
+  b->cur = atom_end(b->cur, b->end);
+  node->type = S_EXPR_ATOM;
+  node->atom = intern_n(start, (size_t)(b->cur - start));
+  node->list = NULL;
+  node->count = 0;
+  return node;
+}
+
+SExpr *parse_sexpr_range(Arena *arena, const char *data, size_t size)
+{
+  const char *end = data + size;
+  SExprScan scan = {0};
+  if (scan_sexpr(data, end, &scan) != 0)
+  {
+    free(scan.list_sizes);
+    return NULL;
+  }
+
+  SExpr *nodes = arena_alloc(arena, sizeof(SExpr) * scan.node_count);
+  SExpr **slots = arena_alloc(arena, sizeof(SExpr *) * (scan.child_count ? scan.child_count : 1));
+  if (!nodes || !slots)
+  {
+    free(scan.list_sizes);
+    return NULL;
+  }
+
+  SExprBuild build = {
+      .cur = data,
+      .end = end,
+      .nodes = nodes,
+      .slots = slots,
+      .list_sizes = scan.list_sizes,
+  };
+  SExpr *root = build_sexpr(&build);
+
+  free(scan.list_sizes);
+  return root;
+}
+
+SExpr *parse_sexpr_file(Arena *arena, const char *path)
+{
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  // mmap rejects zero-length mappings; an empty file parses as an empty atom
+  if (st.st_size == 0)
+  {
+    close(fd);
+    return parse_sexpr_range(arena, "", 0);
+  }
+
+  void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+  {
+    LOG_ERROR("❌ mmap failed for %s", path);
+    return NULL;
+  }
+
+  SExpr *root = parse_sexpr_range(arena, map, (size_t)st.st_size);
+
+  munmap(map, (size_t)st.st_size);
+  return root;
+}
@@ -4,6 +4,8 @@
 #include "eval.h"
 #include "log.h"
 #include "rewrite_util.h"
+#include "intern.h"
+#include "truth_table.h"
 #include <ctype.h>
 #include <dirent.h>
 #include <errno.h>
@@ -13,8 +15,13 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <pthread.h>
+#include <unistd.h>
 
-struct SExpr *parse_expr(const char **input);
+static struct SExpr *parse_expr(Arena *arena, const char **input);
+
+// Parse arena sizing: one block comfortably holds a typical cell file
+#define PARSE_ARENA_BLOCK_SIZE (16 * 1024)
 
 static const char *skip_whitespace(const char *s)
 {
@@ -46,18 +53,14 @@ char *load_file(const char *filename)
   return buffer;
 }
 
-static char *parse_atom(const char **input)
+static const char *parse_atom(const char **input)
 {
   const char *start = *input;
   while (**input && !isspace(**input) && **input != '(' && **input != ')')
   {
     (*input)++;
   }
-  size_t len = *input - start;
-  char *atom = malloc(len + 1);
-  strncpy(atom, start, len);
-  atom[len] = '\0';
-  return atom;
+  return intern_n(start, (size_t)(*input - start));
 }
 
 SExpr *get_child_by_tag(const SExpr *parent, const char *tag)
@@ -106,7 +109,200 @@ const char *get_atom_value(SExpr *list, size_t index)
   return (item->type == S_EXPR_ATOM) ? item->atom : NULL;
 }
 
-int parse_block_from_sexpr(Block *blk, const char *inv_dir)
+// Worker threads for stage 1; 0 = one per online CPU, 1 = parse on the calling thread
+static int parse_thread_count = 0;
+
+void set_parse_threads(int threads)
+{
+  parse_thread_count = threads < 0 ? 0 : threads;
+}
+
+typedef enum
+{
+  PARSED_OK,
+  PARSED_READ_FAILED,
+  PARSED_INVALID,
+  PARSED_NON_ATOM_HEAD,
+  PARSED_DEFINITION_FAILED,
+  PARSED_INVOCATION_FAILED,
+  PARSED_UNKNOWN_TAG
+} ParseStatus;
+
+// Result slot for one .sexpr file; filled by whichever thread parses it
+typedef struct ParsedFile
+{
+  char path[256];
+  const char *file_name; // Points into path
+  ParseStatus status;
+  const char *top_tag;   // Interned; set for PARSED_UNKNOWN_TAG
+  Definition *def;
+  Invocation *inv;
+} ParsedFile;
+
+/**
+ * Parse one file into a Definition or Invocation allocated from netlist.
+ * Never exits: failures are recorded so the caller can report them in
+ * file order, exactly as the serial loop did.
+ */
+static void parse_one_file(ParsedFile *pf, Arena *parse_arena, Arena *netlist)
+{
+  LOG_INFO("📄 Loading S-expression: %s", pf->path);
+
+  // The tree only lives until the file is converted; recycle the arena per file
+  arena_reset(parse_arena);
+
+  // Build with -DSEXPR_NO_MMAP to read files into the heap and use the incremental parser
+#ifndef SEXPR_NO_MMAP
+  SExpr *expr = parse_sexpr_file(parse_arena, pf->path);
+  if (!expr)
+  {
+    pf->status = PARSED_READ_FAILED;
+    return;
+  }
+#else
+  char *contents = load_file(pf->path);
+  if (!contents)
+  {
+    pf->status = PARSED_READ_FAILED;
+    return;
+  }
+
+  SExpr *expr = parse_sexpr_in(parse_arena, contents);
+  free(contents);
+#endif
+
+  if (!expr || expr->type != S_EXPR_LIST || expr->count == 0)
+  {
+    pf->status = PARSED_INVALID;
+    return;
+  }
+
+  SExpr *head = expr->list[0];
+  if (head->type != S_EXPR_ATOM)
+  {
+    pf->status = PARSED_NON_ATOM_HEAD;
+    return;
+  }
+
+  pf->top_tag = head->atom;
+
+  if (strcmp(pf->top_tag, "Definition") == 0)
+  {
+    pf->def = parse_definition(expr, netlist);
+    pf->status = pf->def ? PARSED_OK : PARSED_DEFINITION_FAILED;
+    if (pf->def)
+      pf->def->origin_sexpr_path = intern(pf->path);
+  }
+  else if (strcmp(pf->top_tag, "Invocation") == 0)
+  {
+    pf->inv = parse_invocation(expr, netlist);
+    pf->status = pf->inv ? PARSED_OK : PARSED_INVOCATION_FAILED;
+    if (pf->inv)
+      pf->inv->origin_sexpr_path = intern(pf->path);
+  }
+  else
+  {
+    pf->status = PARSED_UNKNOWN_TAG;
+  }
+}
+
+typedef struct ParseWorker
+{
+  pthread_t thread;
+  ParsedFile *files;
+  size_t file_count;
+  size_t *next_file;          // Shared cursor
+  pthread_mutex_t *next_lock;
+  Arena *parse_arena;         // Scratch SExpr trees
+  Arena *netlist;             // Adopted by the Block after join
+} ParseWorker;
+
+static void *parse_worker_main(void *arg)
+{
+  ParseWorker *w = arg;
+  for (;;)
+  {
+    pthread_mutex_lock(w->next_lock);
+    size_t i = (*w->next_file)++;
+    pthread_mutex_unlock(w->next_lock);
+
+    if (i >= w->file_count)
+      break;
+    parse_one_file(&w->files[i], w->parse_arena, w->netlist);
+  }
+  return NULL;
+}
+
+static int compare_parsed_files(const void *a, const void *b)
+{
+  // Every path has the same directory prefix, so this orders by file name
+  return strcmp(((const ParsedFile *)a)->path, ((const ParsedFile *)b)->path);
+}
+
+static size_t resolve_thread_count(size_t file_count)
+{
+  long threads = parse_thread_count;
+  if (threads == 0)
+    threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads < 1)
+    threads = 1;
+  if ((size_t)threads > file_count)
+    threads = (long)file_count;
+  return threads < 1 ? 1 : (size_t)threads;
+}
+
+// Parse every file with a pool of threads; returns 0 once all slots are filled
+static int parse_files_parallel(ParsedFile *files, size_t file_count, size_t thread_count, Arena *netlist)
+{
+  ParseWorker *workers = calloc(thread_count, sizeof(ParseWorker));
+  if (!workers)
+    return -1;
+
+  size_t next_file = 0;
+  pthread_mutex_t next_lock = PTHREAD_MUTEX_INITIALIZER;
+  size_t started = 0;
+
+  for (size_t t = 0; t < thread_count; ++t)
+  {
+    ParseWorker *w = &workers[t];
+    w->files = files;
+    w->file_count = file_count;
+    w->next_file = &next_file;
+    w->next_lock = &next_lock;
+    w->parse_arena = arena_create(PARSE_ARENA_BLOCK_SIZE);
+    w->netlist = arena_create(0);
+    if (!w->parse_arena || !w->netlist || pthread_create(&w->thread, NULL, parse_worker_main, w) != 0)
+    {
+      arena_destroy(w->parse_arena);
+      arena_destroy(w->netlist);
+      w->parse_arena = w->netlist = NULL;
+      break;
+    }
+    started++;
+  }
+
+  // If no thread could start, the files are simply parsed here
+  if (started == 0)
+  {
+    Arena *parse_arena = arena_create(PARSE_ARENA_BLOCK_SIZE);
+    for (size_t i = 0; i < file_count; ++i)
+      parse_one_file(&files[i], parse_arena, netlist);
+    arena_destroy(parse_arena);
+  }
+
+  for (size_t t = 0; t < started; ++t)
+  {
+    pthread_join(workers[t].thread, NULL);
+    arena_destroy(workers[t].parse_arena);
+    arena_adopt(netlist, workers[t].netlist);
+  }
+
+  LOG_INFO("🧵 Parsed %zu file(s) on %zu thread(s)", file_count, started ? started : 1);
+  free(workers);
+  return 0;
+}
+
+static size_t collect_sexpr_files(const char *inv_dir, ParsedFile **out)
 {
   DIR *dir = opendir(inv_dir);
   if (!dir)
@@ -115,7 +311,8 @@ int parse_block_from_sexpr(Block *blk, const char *inv_dir)
     exit(1);
   }
 
-  LOG_INFO("🔍 parse_block_from_sexpr Parsing block contents from directory: %s", inv_dir);
+  size_t count = 0, capacity = 0;
+  ParsedFile *files = NULL;
 
   struct dirent *entry;
   while ((entry = readdir(dir)) != NULL)
@@ -123,84 +320,133 @@ int parse_block_from_sexpr(Block *blk, const char *inv_dir)
     if (!strstr(entry->d_name, ".sexpr"))
       continue;
 
-    char path[256];
-    snprintf(path, sizeof(path), "%s/%s", inv_dir, entry->d_name);
-
-    LOG_INFO("📄 Loading S-expression: %s", path);
-    char *contents = load_file(path);
-    if (!contents)
+    if (count == capacity)
     {
-      LOG_ERROR("❌ Failed to read file: %s", path);
-      exit(1);
+      capacity = capacity ? capacity * 2 : 64;
+      ParsedFile *grown = realloc(files, sizeof(ParsedFile) * capacity);
+      if (!grown)
+      {
+        LOG_ERROR("❌ Out of memory listing %s", inv_dir);
+        exit(1);
+      }
+      files = grown;
     }
 
-    SExpr *expr = parse_sexpr(contents);
-    free(contents);
+    ParsedFile *pf = &files[count++];
+    memset(pf, 0, sizeof(*pf));
+    int dir_len = snprintf(pf->path, sizeof(pf->path), "%s/", inv_dir);
+    snprintf(pf->path + dir_len, sizeof(pf->path) - dir_len, "%s", entry->d_name);
+  }
+  closedir(dir);
+
+  // Fixed order regardless of readdir order or thread count
+  if (count > 1)
+    qsort(files, count, sizeof(ParsedFile), compare_parsed_files);
+
+  // file_name points into path, so it is only set once the array stops moving
+  for (size_t i = 0; i < count; ++i)
+  {
+    const char *slash = strrchr(files[i].path, '/');
+    files[i].file_name = slash ? slash + 1 : files[i].path;
+  }
+
+  *out = files;
+  return count;
+}
+
+int sexpr_inputs_key(BuildCache *cache, BuildCacheKey *key, const char *inv_dir)
+{
+  ParsedFile *files = NULL;
+  size_t file_count = collect_sexpr_files(inv_dir, &files);
+
+  int rc = 0;
+  for (size_t i = 0; i < file_count && rc == 0; ++i)
+    rc = build_cache_key_add_source(cache, key, files[i].path); // Path and content, in parse order
+  free(files);
+  return rc;
+}
 
-    if (!expr || expr->type != S_EXPR_LIST || expr->count == 0)
+int parse_block_from_sexpr(Block *blk, const char *inv_dir)
+{
+  LOG_INFO("🔍 parse_block_from_sexpr Parsing block contents from directory: %s", inv_dir);
+
+  ParsedFile *files = NULL;
+  size_t file_count = collect_sexpr_files(inv_dir, &files);
+  size_t thread_count = resolve_thread_count(file_count);
+
+  if (thread_count > 1)
+  {
+    if (parse_files_parallel(files, file_count, thread_count, blk->arena) != 0)
     {
-      LOG_ERROR("❌ Invalid or empty S-expression in file: %s", path);
-      if (expr)
-        free_sexpr(expr);
+      LOG_ERROR("❌ Failed to start parse workers");
       exit(1);
     }
-
-    SExpr *head = expr->list[0];
-    if (head->type != S_EXPR_ATOM)
+  }
+  else
+  {
+    // SExpr trees are scratch; definitions and invocations go to the Block's arena
+    Arena *parse_arena = arena_create(PARSE_ARENA_BLOCK_SIZE);
+    if (!parse_arena)
     {
-      LOG_ERROR("❌ Malformed S-expression (non-atom head) in file: %s", path);
-      free_sexpr(expr);
+      LOG_ERROR("❌ Failed to create parse arena");
       exit(1);
     }
+    for (size_t i = 0; i < file_count; ++i)
+      parse_one_file(&files[i], parse_arena, blk->arena);
+    LOG_INFO("🧹 Parse arena released (%zu bytes reserved)", parse_arena->reserved);
+    arena_destroy(parse_arena);
+  }
 
-    const char *top_tag = head->atom;
-    const char *file_basename = entry->d_name;
-
-    if (strcmp(top_tag, "Definition") == 0)
+  // Merge in file order, so the Block is identical for any thread count
+  for (size_t i = 0; i < file_count; ++i)
+  {
+    ParsedFile *pf = &files[i];
+    switch (pf->status)
     {
-      Definition *def = parse_definition(expr);
-      if (!def)
-      {
-        LOG_ERROR("❌ Failed to parse Definition from: %s", path);
-        free_sexpr(expr);
-        exit(1);
-      }
-      def->origin_sexpr_path = strdup(path);
-      def->next = blk->definitions;
-      blk->definitions = def;
-      LOG_INFO("📦 Added Definition: %s", def->name);
+    case PARSED_OK:
+      break;
+    case PARSED_READ_FAILED:
+      LOG_ERROR("❌ Failed to read file: %s", pf->path);
+      exit(1);
+    case PARSED_INVALID:
+      LOG_ERROR("❌ Invalid or empty S-expression in file: %s", pf->path);
+      exit(1);
+    case PARSED_NON_ATOM_HEAD:
+      LOG_ERROR("❌ Malformed S-expression (non-atom head) in file: %s", pf->path);
+      exit(1);
+    case PARSED_DEFINITION_FAILED:
+      LOG_ERROR("❌ Failed to parse Definition from: %s", pf->path);
+      exit(1);
+    case PARSED_INVOCATION_FAILED:
+      LOG_ERROR("❌ Failed to parse Invocation from: %s", pf->path);
+      exit(1);
+    case PARSED_UNKNOWN_TAG:
+      LOG_ERROR("❌ Unknown top-level tag: (%s) in file %s", pf->top_tag, pf->file_name);
+      exit(1);
     }
-    else if (strcmp(top_tag, "Invocation") == 0)
+
+    if (pf->def)
     {
-      Invocation *inv = parse_invocation(expr);
-      if (!inv)
-      {
-        LOG_ERROR("❌ Failed to parse Invocation from: %s", path);
-        free_sexpr(expr);
-        exit(1);
-      }
-      inv->origin_sexpr_path = strdup(path);
-      inv->next = blk->invocations;
-      blk->invocations = inv;
-      LOG_INFO("📦 Added Invocation targeting: %s", inv->target_name);
+      pf->def->next = blk->definitions;
+      blk->definitions = pf->def;
+      LOG_INFO("📦 Added Definition: %s", pf->def->name);
     }
-    else
+    else if (pf->inv)
     {
-      LOG_ERROR("❌ Unknown top-level tag: (%s) in file %s", top_tag, file_basename);
-      free_sexpr(expr);
-      exit(1);
+      pf->inv->next = blk->invocations;
+      blk->invocations = pf->inv;
+      LOG_INFO("📦 Added Invocation targeting: %s", pf->inv->target_name);
     }
-
-    free_sexpr(expr);
   }
 
-  closedir(dir);
+  free(files);
+  block_index_definitions(blk); // unify_invocations looks every target up by name
   LOG_INFO("✅ Block population from S-expression completed.");
 
   return 0;
 }
 
-ConditionalInvocation *parse_conditional_invocation(const SExpr *ci_expr)
+ConditionalInvocation *parse_conditional_invocation(const SExpr *ci_expr, Arena *arena)
 {
   if (!ci_expr || ci_expr->type != S_EXPR_LIST || ci_expr->count < 1)
     return NULL;
@@ -208,8 +454,8 @@ ConditionalInvocation *parse_conditional_invocation(const SExpr *ci_expr)
   if (ci_expr->list[0]->type != S_EXPR_ATOM || strcmp(ci_expr->list[0]->atom, "ConditionalInvocation") != 0)
     return NULL;
 
-  ConditionalInvocation *ci = calloc(1, sizeof(ConditionalInvocation));
-  ci->pattern_args = create_string_list(); // ✅ initialize flat StringList
+  ConditionalInvocation *ci = arena_calloc(arena, 1, sizeof(ConditionalInvocation));
+  ci->pattern_args = create_string_list_in(arena); // ✅ initialize flat StringList
   ci->arg_count = 0;
   ci->output = NULL;
   ci->cases = NULL;
@@ -243,7 +489,7 @@ ConditionalInvocation *parse_conditional_invocation(const SExpr *ci_expr)
     {
       if (item->list[1]->type == S_EXPR_ATOM)
       {
-        ci->output = strdup(item->list[1]->atom);
+        ci->output = item->list[1]->atom;
         LOG_INFO("🔸 Output: %s", ci->output);
       }
     }
@@ -255,19 +501,38 @@ ConditionalInvocation *parse_conditional_invocation(const SExpr *ci_expr)
       const SExpr *val = item->list[2];
       if (key->type == S_EXPR_ATOM && val->type == S_EXPR_ATOM)
       {
-        ci->cases = realloc(ci->cases, sizeof(ConditionalCase) * (ci->case_count + 1));
-        ci->cases[ci->case_count].pattern = strdup(key->atom);
-        ci->cases[ci->case_count].result = strdup(val->atom);
+        ci->cases = arena_realloc(arena, ci->cases, sizeof(ConditionalCase) * ci->case_count,
+                                  sizeof(ConditionalCase) * (ci->case_count + 1));
+        ci->cases[ci->case_count].pattern = key->atom;
+        ci->cases[ci->case_count].result = val->atom;
         LOG_INFO("📘 Case added: %s → %s", key->atom, val->atom);
         ci->case_count++;
       }
     }
   }
 
+  // Compiled once here and shared by every instance of the definition
+  if (ci->arg_count == string_list_count(ci->pattern_args))
+    ci->truth_table = compile_truth_table(ci, arena);
+  if (!ci->truth_table)
+    LOG_INFO("ℹ️ Conditional cases not table-compilable, using string matching");
+
   return ci;
 }
 
-Definition *parse_definition(const SExpr *expr)
+// sexpr_to_string returns a heap string; move it into the definition's arena
+static char *copy_sexpr_logic(Arena *arena, const SExpr *expr)
+{
+  char *logic = sexpr_to_string(expr);
+  if (!arena)
+    return logic;
+
+  char *copy = arena_strdup(arena, logic);
+  free(logic);
+  return copy;
+}
+
+Definition *parse_definition(const SExpr *expr, Arena *arena)
 {
   if (!expr || expr->type != S_EXPR_LIST || expr->count < 1)
     return NULL;
@@ -275,9 +540,9 @@ Definition *parse_definition(const SExpr *expr)
   if (expr->list[0]->type != S_EXPR_ATOM || strcmp(expr->list[0]->atom, "Definition") != 0)
     return NULL;
 
-  Definition *def = calloc(1, sizeof(Definition));
-  def->input_signals = create_string_list();
-  def->output_signals = create_string_list();
+  Definition *def = arena_calloc(arena, 1, sizeof(Definition));
+  def->input_signals = create_string_list_in(arena);
+  def->output_signals = create_string_list_in(arena);
 
   for (size_t i = 1; i < expr->count; ++i)
   {
@@ -289,7 +554,7 @@ Definition *parse_definition(const SExpr *expr)
 
     if (strcmp(tag, "Name") == 0 && item->count == 2)
     {
-      def->name = strdup(item->list[1]->atom);
+      def->name = item->list[1]->atom;
     }
 
     else if (strcmp(tag, "Inputs") == 0)
@@ -314,8 +579,8 @@ Definition *parse_definition(const SExpr *expr)
 
     else if (strcmp(tag, "ConditionalInvocation") == 0)
     {
-      def->sexpr_logic = sexpr_to_string(item);
-      def->conditional_invocation = parse_conditional_invocation(item);
+      def->sexpr_logic = copy_sexpr_logic(arena, item);
+      def->conditional_invocation = parse_conditional_invocation(item, arena);
     }
 
     else if (strcmp(tag, "Body") == 0)
@@ -336,18 +601,18 @@ Definition *parse_definition(const SExpr *expr)
 
         if (strcmp(sub_tag, "ConditionalInvocation") == 0)
         {
-          def->sexpr_logic = sexpr_to_string(sub);
-          def->conditional_invocation = parse_conditional_invocation(sub);
+          def->sexpr_logic = copy_sexpr_logic(arena, sub);
+          def->conditional_invocation = parse_conditional_invocation(sub, arena);
           continue; // still support having conditional logic inside Body
         }
 
         if (strcmp(sub_tag, "Invocation") == 0)
         {
-          Invocation *inv = parse_invocation(sub);
+          Invocation *inv = parse_invocation(sub, arena);
           if (!inv)
             continue;
 
-          BodyItem *bi = calloc(1, sizeof(BodyItem));
+          BodyItem *bi = arena_calloc(arena, 1, sizeof(BodyItem));
           bi->type = BODY_INVOCATION;
           bi->data.invocation = inv;
           bi->next = NULL;
@@ -366,14 +631,14 @@ Definition *parse_definition(const SExpr *expr)
     LOG_ERROR("⚠️  Definition missing a Name");
     destroy_string_list(def->input_signals);
     destroy_string_list(def->output_signals);
-    free(def);
+    arena_free(arena, def);
     return NULL;
   }
 
   return def;
 }
 
-Invocation *parse_invocation(SExpr *expr)
+Invocation *parse_invocation(const SExpr *expr, Arena *arena)
 {
   if (!expr || expr->type != S_EXPR_LIST || expr->count == 0)
     return NULL;
@@ -381,15 +646,15 @@ Invocation *parse_invocation(SExpr *expr)
   if (expr->list[0]->type != S_EXPR_ATOM || strcmp(expr->list[0]->atom, "Invocation") != 0)
     return NULL;
 
-  Invocation *inv = calloc(1, sizeof(Invocation));
-  inv->input_signals = create_string_list();
-  inv->output_signals = create_string_list();
-  inv->literal_bindings = calloc(1, sizeof(LiteralBindingList));
+  Invocation *inv = arena_calloc(arena, 1, sizeof(Invocation));
+  inv->input_signals = create_string_list_in(arena);
+  inv->output_signals = create_string_list_in(arena);
+  inv->literal_bindings = arena_calloc(arena, 1, sizeof(LiteralBindingList));
 
   // ─── First Pass: Parse structure (Target, Inputs, Outputs) ────────────────
   for (size_t i = 1; i < expr->count; ++i)
   {
-    SExpr *form = expr->list[i];
+    const SExpr *form = expr->list[i];
     if (!form || form->type != S_EXPR_LIST || form->count == 0)
       continue;
 
@@ -397,13 +662,13 @@ Invocation *parse_invocation(SExpr *expr)
 
     if (strcmp(tag, "Target") == 0 && form->count >= 2)
     {
-      inv->target_name = strdup(form->list[1]->atom);
+      inv->target_name = form->list[1]->atom;
     }
     else if (strcmp(tag, "Inputs") == 0)
     {
       for (size_t j = 1; j < form->count; ++j)
       {
-        SExpr *arg = form->list[j];
+        const SExpr *arg = form->list[j];
         if (arg->type == S_EXPR_ATOM)
           string_list_add(inv->input_signals, arg->atom);
       }
@@ -412,7 +677,7 @@ Invocation *parse_invocation(SExpr *expr)
     {
       for (size_t j = 1; j < form->count; ++j)
       {
-        SExpr *arg = form->list[j];
+        const SExpr *arg = form->list[j];
         if (arg->type == S_EXPR_ATOM)
           string_list_add(inv->output_signals, arg->atom);
       }
@@ -422,7 +687,7 @@ Invocation *parse_invocation(SExpr *expr)
   // ─── Second Pass: Bindings ────────────────────────────────────────────────
   for (size_t i = 1; i < expr->count; ++i)
   {
-    SExpr *form = expr->list[i];
+    const SExpr *form = expr->list[i];
     if (!form || form->type != S_EXPR_LIST || form->count == 0)
       continue;
 
@@ -430,7 +695,7 @@ Invocation *parse_invocation(SExpr *expr)
 
     if (strcmp(tag, "bind") == 0 && form->count == 2)
     {
-      SExpr *pair = form->list[1];
+      const SExpr *pair = form->list[1];
       if (pair->type == S_EXPR_LIST && pair->count == 2 &&
           pair->list[0]->type == S_EXPR_ATOM &&
           pair->list[1]->type == S_EXPR_ATOM)
@@ -443,11 +708,12 @@ Invocation *parse_invocation(SExpr *expr)
           LOG_INFO("📥 Literal binding recognized: %s = %s", signal, value);
 
           size_t i = inv->literal_bindings->count;
-          inv->literal_bindings->items = realloc(
-              inv->literal_bindings->items,
+          inv->literal_bindings->items = arena_realloc(
+              arena, inv->literal_bindings->items,
+              sizeof(LiteralBinding) * i,
               sizeof(LiteralBinding) * (i + 1));
-          inv->literal_bindings->items[i].name = strdup(signal);
-          inv->literal_bindings->items[i].value = strdup(value);
+          inv->literal_bindings->items[i].name = signal;
+          inv->literal_bindings->items[i].value = value;
           inv->literal_bindings->count++;
         }
         else
@@ -463,16 +729,17 @@ Invocation *parse_invocation(SExpr *expr)
     LOG_ERROR("Invocation is missing a Target");
     destroy_string_list(inv->input_signals);
     destroy_string_list(inv->output_signals);
-    free(inv);
+    arena_free(arena, inv->literal_bindings);
+    arena_free(arena, inv);
     return NULL;
   }
 
   return inv;
 }
 
-static struct SExpr *parse_list(const char **input)
+static struct SExpr *parse_list(Arena *arena, const char **input)
 {
-  struct SExpr *expr = malloc(sizeof(struct SExpr));
+  struct SExpr *expr = arena_alloc(arena, sizeof(struct SExpr));
   expr->type = S_EXPR_LIST;
   expr->list = NULL;
   expr->count = 0;
@@ -480,9 +747,15 @@ static struct SExpr *parse_list(const char **input)
   *input = skip_whitespace(*input);
   while (**input && **input != ')')
   {
-    struct SExpr *child = parse_expr(input);
-    expr->list =
-        realloc(expr->list, sizeof(struct SExpr *) * (expr->count + 1));
+    struct SExpr *child = parse_expr(arena, input);
+    // Capacity is 4, then doubles whenever count reaches a power of two
+    if (expr->count == 0 || (expr->count >= 4 && (expr->count & (expr->count - 1)) == 0))
+    {
+      size_t capacity = expr->count ? expr->count * 2 : 4;
+      expr->list = arena_realloc(arena, expr->list,
+                                 sizeof(struct SExpr *) * expr->count,
+                                 sizeof(struct SExpr *) * capacity);
+    }
     expr->list[expr->count++] = child;
     *input = skip_whitespace(*input);
   }
@@ -492,17 +765,17 @@ static struct SExpr *parse_list(const char **input)
   return expr;
 }
 
-SExpr *parse_expr(const char **input)
+static SExpr *parse_expr(Arena *arena, const char **input)
 {
   *input = skip_whitespace(*input);
   if (**input == '(')
   {
     (*input)++;
-    return parse_list(input);
+    return parse_list(arena, input);
   }
   else
   {
-    struct SExpr *atom = malloc(sizeof(struct SExpr));
+    struct SExpr *atom = arena_alloc(arena, sizeof(struct SExpr));
     atom->type = S_EXPR_ATOM;
     atom->atom = parse_atom(input);
     atom->list = NULL;
@@ -511,7 +784,9 @@ SExpr *parse_expr(const char **input)
   }
 }
 
-SExpr *parse_sexpr(const char *input) { return parse_expr(&input); }
+SExpr *parse_sexpr(const char *input) { return parse_expr(NULL, &input); }
+
+SExpr *parse_sexpr_in(Arena *arena, const char *input) { return parse_expr(arena, &input); }
 
 void print_sexpr(const SExpr *expr, int indent)
 {
@@ -540,9 +815,6 @@ void free_sexpr(SExpr *expr)
     }
     free(expr->list);
   }
-  else if (expr->type == S_EXPR_ATOM)
-  {
-    free(expr->atom);
-  }
+  // Atoms live in the intern pool and outlive the tree
   free(expr);
 }
@@ -6,24 +6,36 @@
 #include <string.h>
 #include <ctype.h>
 #include "eval.h"
+#include "arena.h"
 typedef enum { S_EXPR_ATOM, S_EXPR_LIST } SExprType;
 
 typedef struct SExpr {
     SExprType type;
-    char *atom;
+    const char *atom;   // Interned; not freed with the node
     struct SExpr **list;
     size_t count;
 } SExpr;
 
-SExpr *parse_sexpr(const char *input);
+SExpr *parse_sexpr(const char *input);                  // Heap tree; release with free_sexpr
+SExpr *parse_sexpr_in(Arena *arena, const char *input); // Tree lives in the arena
+
+// mmap-backed parsing (sexpr_mapped.c): one node array per file, atoms interned
+// straight from the mapping. Same grammar as parse_sexpr.
+SExpr *parse_sexpr_file(Arena *arena, const char *path);
+SExpr *parse_sexpr_range(Arena *arena, const char *data, size_t size);
 void print_sexpr(const SExpr *expr, int indent);
 const char *get_atom_value(SExpr *list, size_t index);
 SExpr *get_child_by_tag(const SExpr *parent, const char *tag);
 void free_sexpr(SExpr *expr);
 int parse_block_from_sexpr(Block *blk, const char *inv_dir);
-Definition *parse_definition(const SExpr *expr);
-Invocation *parse_invocation(SExpr *expr);
-ConditionalInvocation *parse_conditional_invocation(const SExpr *ci_expr);
+// Adds every file parse_block_from_sexpr would read, in the same order; -1 if one cannot be hashed
+int sexpr_inputs_key(BuildCache *cache, BuildCacheKey *key, const char *inv_dir);
+// Files are parsed on a thread pool and merged in sorted name order; 0 = one thread per CPU
+void set_parse_threads(int threads);
+// Results are allocated from arena (NULL = heap)
+Definition *parse_definition(const SExpr *expr, Arena *arena);
+Invocation *parse_invocation(const SExpr *expr, Arena *arena);
+ConditionalInvocation *parse_conditional_invocation(const SExpr *ci_expr, Arena *arena);
 char *load_file(const char *filename);
 
 #endif // SEXPR_PARSER_H
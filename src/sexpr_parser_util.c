@@ -19,7 +19,7 @@ bool parse_definition_name(Definition *def, SExpr *expr)
         return false;
     }
 
-    def->name = strdup(name);
+    def->name = name;
     return true;
 }
 
@@ -41,7 +41,7 @@ bool parse_definition_body(Definition *def, SExpr *expr) {
         const char *tag = cur->list[0]->atom;
 
         if (strcmp(tag, "Invocation") == 0) {
-            Invocation *inv = parse_invocation(cur);  // Full list passed
+            Invocation *inv = parse_invocation(cur, NULL);  // Full list passed
             if (!inv) return false;
 
             BodyItem *item = calloc(1, sizeof(BodyItem));
@@ -60,7 +60,7 @@ bool parse_definition_body(Definition *def, SExpr *expr) {
 
                 BodyItem *item = calloc(1, sizeof(BodyItem));
                 item->type = type;
-                item->data.signal_name = strdup(s->atom);
+                item->data.signal_name = s->atom;
                 *tail = item;
                 tail = &item->next;
             }
@@ -147,7 +147,7 @@ bool parse_invocation_name(Invocation *inv, SExpr *expr)
         return false;
     }
 
-    inv->target_name = strdup(name);
+    inv->target_name = name;
     return true;
 }
 
@@ -226,8 +226,8 @@ void parse_invocation_inputs(Invocation *inv, SExpr *expr)
             {
                 size_t count = inv->literal_bindings->count;
                 inv->literal_bindings->items = realloc(inv->literal_bindings->items, (count + 1) * sizeof(LiteralBinding));
-                inv->literal_bindings->items[count].name = strdup(key);
-                inv->literal_bindings->items[count].value = strdup(val);
+                inv->literal_bindings->items[count].name = key;
+                inv->literal_bindings->items[count].value = val;
                 inv->literal_bindings->count++;
 
                 LOG_INFO("📌 Literal bound: %s = %s", key, val);
@@ -11,7 +11,7 @@ bool all_signals_ready(StringList *input_names, SignalMap *signal_map) {
 
     size_t count = string_list_count(input_names);
     for (size_t i = 0; i < count; ++i) {
-        const char *name = string_list_get_by_index(input_names, i);
+        const char *name = string_list_get(input_names, i);
         const char *value = get_signal_value(signal_map, name);
 
         if (!value) {
@@ -23,3 +23,17 @@ bool all_signals_ready(StringList *input_names, SignalMap *signal_map) {
 }
 
 
+
+bool all_signal_ids_ready(const SignalId *ids, size_t count, SignalMap *signal_map) {
+    if (!ids || count == 0) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (!signal_map_get(signal_map, ids[i])) {
+            return false; // 🛑 Input not ready
+        }
+    }
+
+    return true; // ✅ All inputs have values
+}
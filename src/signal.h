@@ -8,6 +8,7 @@
 
 
 bool all_signals_ready(StringList *input_names, SignalMap *signal_map);
+bool all_signal_ids_ready(const SignalId *ids, size_t count, SignalMap *signal_map);
 
 
 
@@ -0,0 +1,172 @@
+#define _POSIX_C_SOURCE 200809L // pthread_cond_timedwait, clock_gettime
+#include "signal_export.h"
+#include "log.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+struct SignalExporter {
+    const SignalStore *store;
+    const char **names;         // By SignalId, as of start
+    size_t name_count;
+    char *path;
+    int interval_ms;
+
+    StoreSnapshot snapshot;     // Reused across reads
+    uint64_t written_epoch;     // Last epoch on disk; 0 = nothing yet
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    int stopping;               // Guarded by lock
+};
+
+int export_signal_snapshot(const StoreSnapshot *snapshot, const char *const *names, size_t name_count,
+                           const char *path)
+{
+    char tmp_path[1024];
+    int len = snprintf(tmp_path, sizeof(tmp_path), "%s.%ld.tmp", path, (long)getpid());
+    if (len < 0 || (size_t)len >= sizeof(tmp_path))
+        return -1;
+
+    FILE *out = fopen(tmp_path, "w");
+    if (!out)
+        return -1;
+
+    int failed = 0;
+    for (size_t id = 0; id < snapshot->count && !failed; ++id)
+    {
+        const char *value = snapshot->values[id];
+        if (!value)
+            continue; // Never driven
+        if (id < name_count && names[id])
+            failed = fprintf(out, "%s=%s\n", names[id], value) < 0;
+        else
+            failed = fprintf(out, "#%zu=%s\n", id, value) < 0;
+    }
+
+    if (fclose(out) != 0)
+        failed = 1;
+    if (failed || rename(tmp_path, path) != 0)
+    {
+        remove(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+// Nothing to do unless the eval thread published since the last write
+static void export_if_changed(SignalExporter *exporter)
+{
+    if (signal_store_read(exporter->store, &exporter->snapshot) != 0)
+    {
+        LOG_WARN("⚠️ Exporter: out of memory reading the signal store");
+        return;
+    }
+    if (exporter->snapshot.epoch == exporter->written_epoch)
+        return;
+
+    if (export_signal_snapshot(&exporter->snapshot, exporter->names, exporter->name_count, exporter->path) != 0)
+    {
+        LOG_WARN("⚠️ Exporter: could not write %s", exporter->path);
+        return;
+    }
+    exporter->written_epoch = exporter->snapshot.epoch;
+}
+
+static void *exporter_main(void *arg)
+{
+    SignalExporter *exporter = arg;
+
+    pthread_mutex_lock(&exporter->lock);
+    while (!exporter->stopping)
+    {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += exporter->interval_ms / 1000;
+        deadline.tv_nsec += (long)(exporter->interval_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        int rc = 0;
+        while (!exporter->stopping && rc != ETIMEDOUT)
+            rc = pthread_cond_timedwait(&exporter->wake, &exporter->lock, &deadline);
+
+        // The store is read without the lock: stop only waits for this pass to end
+        pthread_mutex_unlock(&exporter->lock);
+        export_if_changed(exporter);
+        pthread_mutex_lock(&exporter->lock);
+    }
+    pthread_mutex_unlock(&exporter->lock);
+    return NULL;
+}
+
+static void free_exporter(SignalExporter *exporter)
+{
+    store_snapshot_free(&exporter->snapshot);
+    free(exporter->names);
+    free(exporter->path);
+    free(exporter);
+}
+
+SignalExporter *start_signal_exporter(const SignalStore *store, SignalMap *signal_map, const char *path,
+                                      int interval_ms)
+{
+    if (!store || !signal_map || !path)
+        return NULL;
+
+    SignalExporter *exporter = calloc(1, sizeof(SignalExporter));
+    if (!exporter)
+        return NULL;
+    exporter->store = store;
+    exporter->interval_ms = interval_ms > 0 ? interval_ms : SIGNAL_EXPORT_DEFAULT_INTERVAL_MS;
+    exporter->path = malloc(strlen(path) + 1);
+    exporter->name_count = signal_map->count;
+    exporter->names = malloc(sizeof(const char *) * (exporter->name_count ? exporter->name_count : 1));
+    if (!exporter->path || !exporter->names)
+    {
+        free_exporter(exporter);
+        return NULL;
+    }
+    strcpy(exporter->path, path);
+    for (size_t id = 0; id < exporter->name_count; ++id)
+        exporter->names[id] = signal_map_name(signal_map, (SignalId)id);
+
+    pthread_mutex_init(&exporter->lock, NULL);
+    pthread_cond_init(&exporter->wake, NULL);
+    if (pthread_create(&exporter->thread, NULL, exporter_main, exporter) != 0)
+    {
+        pthread_cond_destroy(&exporter->wake);
+        pthread_mutex_destroy(&exporter->lock);
+        free_exporter(exporter);
+        return NULL;
+    }
+
+    LOG_INFO("📤 Exporting signal snapshots to %s every %d ms", exporter->path, exporter->interval_ms);
+    return exporter;
+}
+
+void stop_signal_exporter(SignalExporter *exporter)
+{
+    if (!exporter)
+        return;
+
+    pthread_mutex_lock(&exporter->lock);
+    exporter->stopping = 1;
+    pthread_cond_signal(&exporter->wake);
+    pthread_mutex_unlock(&exporter->lock);
+    pthread_join(exporter->thread, NULL);
+
+    export_if_changed(exporter); // Whatever the last pass published
+    LOG_INFO("📤 Exported epoch %llu to %s", (unsigned long long)exporter->written_epoch, exporter->path);
+
+    pthread_cond_destroy(&exporter->wake);
+    pthread_mutex_destroy(&exporter->lock);
+    free_exporter(exporter);
+}
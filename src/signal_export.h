@@ -0,0 +1,29 @@
+#ifndef SIGNAL_EXPORT_H
+#define SIGNAL_EXPORT_H
+#include "signal_map.h"
+#include "signal_store.h"
+
+// Background reader of a SignalStore: every interval it takes a snapshot
+// and, if the eval thread published since the last one, rewrites `path`
+// with one "name=value" line per driven signal. The file is replaced with
+// rename(), so a reader of it never sees half a snapshot.
+//
+// Names are taken from the map when the exporter starts (the eval thread
+// may grow the map, so the exporter never reads it afterwards). Signals
+// interned later are written as "#<id>".
+
+#define SIGNAL_EXPORT_DEFAULT_INTERVAL_MS 100
+
+typedef struct SignalExporter SignalExporter;
+
+// NULL if the thread cannot be started. Call before evaluation begins.
+SignalExporter *start_signal_exporter(const SignalStore *store, SignalMap *signal_map, const char *path,
+                                      int interval_ms);
+// Writes the final snapshot, then joins the thread
+void stop_signal_exporter(SignalExporter *exporter);
+
+// Writes one snapshot to path as above; 0 on success, -1 on error
+int export_signal_snapshot(const StoreSnapshot *snapshot, const char *const *names, size_t name_count,
+                           const char *path);
+
+#endif
@@ -1,72 +1,519 @@
 #include "signal_map.h"
 #include "log.h"
+#include "hash.h"
+#include "intern.h"
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-static char *strdup_safe(const char *s) {
-    if (!s) return NULL;
-    size_t len = strlen(s) + 1;
-    char *copy = malloc(len);
-    if (copy) memcpy(copy, s, len);
-    return copy;
-}
+#define SIGNAL_MAP_INITIAL_SLOTS 64
+#define SIGNAL_PREFIX_FILTER_BITS 16384 // Must be a power of two
+#define RANGE_NONE SIZE_MAX
+
+// A run of ids reserved together, named on demand
+typedef struct SignalNameRange {
+    SignalId first;
+    size_t count;
+    const char *prefix;         // Interned
+    const char *const *locals;  // count interned names
+    SignalId *ids;              // NULL, or the id to bind for each local (see signal_map_reserved_ids)
+    size_t next;                // Previous range with the same prefix, or RANGE_NONE
+} SignalNameRange;
+
+struct SignalNameRanges {
+    SignalNameRange *items;     // Ascending by first id
+    size_t count;
+    size_t capacity;
+    size_t *by_prefix;          // Open addressing on the prefix hash → newest range with that prefix
+    size_t prefix_slot_count;   // Power of two, or 0 before the first range
+    // Bit per hash of every "<p>" such that a name "<p>.<rest>" was interned
+    // directly; a reservation whose prefix misses cannot collide with one
+    uint64_t direct_prefixes[SIGNAL_PREFIX_FILTER_BITS / 64];
+    pthread_mutex_t lock;       // Naming, which eval workers may trigger through signal_map_name
+};
 
 SignalMap *create_signal_map(void) {
     SignalMap *map = malloc(sizeof(SignalMap));
     if (!map) return NULL;
-    map->head = NULL;
+    map->entries = NULL;
+    map->bits = NULL;
     map->count = 0;
+    map->capacity = 0;
+    map->slot_count = SIGNAL_MAP_INITIAL_SLOTS;
+    map->slots = malloc(sizeof(SignalId) * map->slot_count);
+    if (!map->slots) {
+        free(map);
+        return NULL;
+    }
+    memset(map->slots, 0xFF, sizeof(SignalId) * map->slot_count); // SIGNAL_ID_NONE
+    map->bit_values[0] = intern("0");
+    map->bit_values[1] = intern("1");
+    map->pending = NULL;
+    map->store = NULL;
+    map->fingerprint = 0;
     return map;
 }
 
 void destroy_signal_map(SignalMap *map) {
     if (!map) return;
-    SignalEntry *entry = map->head;
-    while (entry) {
-        SignalEntry *next = entry->next;
-        free(entry->name);
-        free(entry->value);
-        free(entry);
-        entry = next;
+    free(map->entries);
+    free(map->bits);
+    free(map->slots);
+    if (map->pending) {
+        for (size_t i = 0; i < map->pending->count; ++i)
+            free(map->pending->items[i].ids);
+        free(map->pending->items);
+        free(map->pending->by_prefix);
+        pthread_mutex_destroy(&map->pending->lock);
     }
+    free(map->pending);
     free(map);
 }
 
-void update_signal_value(SignalMap *map, const char *name, const char *value) {
-    if (!map || !name || !value) return;
+// name must be interned: entries match by pointer
+static size_t probe_slot(const SignalMap *map, const char *name) {
+    size_t mask = map->slot_count - 1;
+    size_t slot = intern_hash(name) & mask;
+    while (map->slots[slot] != SIGNAL_ID_NONE) {
+        if (map->entries[map->slots[slot]].name == name)
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static int grow_slots(SignalMap *map) {
+    size_t new_count = map->slot_count * 2;
+    SignalId *slots = malloc(sizeof(SignalId) * new_count);
+    if (!slots) return -1;
+    memset(slots, 0xFF, sizeof(SignalId) * new_count);
+
+    size_t mask = new_count - 1;
+    for (SignalId id = 0; id < map->count; ++id) {
+        if (!map->entries[id].name)
+            continue; // Reserved; indexed once named
+        size_t slot = intern_hash(map->entries[id].name) & mask;
+        while (slots[slot] != SIGNAL_ID_NONE)
+            slot = (slot + 1) & mask;
+        slots[slot] = id;
+    }
+
+    free(map->slots);
+    map->slots = slots;
+    map->slot_count = new_count;
+    return 0;
+}
+
+static int grow_entries(SignalMap *map, size_t needed) {
+    if (needed <= map->capacity) return 0;
+    size_t new_capacity = map->capacity ? map->capacity * 2 : 64;
+    while (new_capacity < needed)
+        new_capacity *= 2;
+    SignalEntry *entries = realloc(map->entries, sizeof(SignalEntry) * new_capacity);
+    if (!entries) return -1;
+    map->entries = entries;
+    uint8_t *bits = realloc(map->bits, new_capacity);
+    if (!bits) return -1;
+    map->bits = bits;
+    map->capacity = new_capacity;
+    return 0;
+}
+
+static struct SignalNameRanges *ensure_ranges(SignalMap *map) {
+    if (!map->pending) {
+        map->pending = calloc(1, sizeof(struct SignalNameRanges));
+        if (!map->pending) return NULL;
+        pthread_mutex_init(&map->pending->lock, NULL);
+    }
+    return map->pending;
+}
+
+static size_t prefix_slot(const struct SignalNameRanges *ranges, const char *prefix) {
+    size_t mask = ranges->prefix_slot_count - 1;
+    size_t slot = intern_hash(prefix) & mask;
+    while (ranges->by_prefix[slot] != RANGE_NONE && ranges->items[ranges->by_prefix[slot]].prefix != prefix)
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+// Newest range reserved under prefix, or RANGE_NONE; older ones follow through next
+static size_t prefix_head(const struct SignalNameRanges *ranges, const char *prefix) {
+    if (ranges->prefix_slot_count == 0) return RANGE_NONE;
+    return ranges->by_prefix[prefix_slot(ranges, prefix)];
+}
+
+static void index_range(struct SignalNameRanges *ranges, size_t index) {
+    SignalNameRange *range = &ranges->items[index];
+    size_t slot = prefix_slot(ranges, range->prefix);
+    range->next = ranges->by_prefix[slot];
+    ranges->by_prefix[slot] = index;
+}
+
+// Rebuilds the prefix index with room for at least one more range
+static int reindex_ranges(struct SignalNameRanges *ranges, size_t needed) {
+    size_t slot_count = ranges->prefix_slot_count ? ranges->prefix_slot_count : 64;
+    while (needed * 2 > slot_count)
+        slot_count *= 2;
+    if (slot_count != ranges->prefix_slot_count) {
+        size_t *by_prefix = realloc(ranges->by_prefix, sizeof(size_t) * slot_count);
+        if (!by_prefix) return -1;
+        ranges->by_prefix = by_prefix;
+        ranges->prefix_slot_count = slot_count;
+    }
+    memset(ranges->by_prefix, 0xFF, sizeof(size_t) * ranges->prefix_slot_count); // RANGE_NONE
+    for (size_t i = 0; i < ranges->count; ++i)
+        index_range(ranges, i);
+    return 0;
+}
+
+static void filter_set(struct SignalNameRanges *ranges, uint32_t hash) {
+    hash &= SIGNAL_PREFIX_FILTER_BITS - 1;
+    ranges->direct_prefixes[hash / 64] |= (uint64_t)1 << (hash % 64);
+}
+
+static int filter_test(const struct SignalNameRanges *ranges, uint32_t hash) {
+    hash &= SIGNAL_PREFIX_FILTER_BITS - 1;
+    return (ranges->direct_prefixes[hash / 64] >> (hash % 64)) & 1;
+}
 
-    SignalEntry *entry = map->head;
-    while (entry) {
-        if (strcmp(entry->name, name) == 0) {
-            free(entry->value);
-            entry->value = strdup_safe(value);
-            return;
+// Every dotted prefix of a name interned outside signal_map_reserve
+static void note_direct_name(SignalMap *map, const char *name) {
+    const char *dot = strchr(name, '.');
+    if (!dot || !ensure_ranges(map)) return;
+    for (; dot; dot = strchr(dot + 1, '.'))
+        filter_set(map->pending, hash_bytes(name, (size_t)(dot - name)));
+}
+
+// The slot table was sized for every reserved id, so naming never grows it.
+// Safe against other threads naming; not against concurrent lookups by name.
+static const char *name_reserved_id(SignalMap *map, const SignalNameRange *range, SignalId id) {
+    pthread_mutex_lock(&map->pending->lock);
+    const char *name = map->entries[id].name;
+    if (!name) {
+        name = intern_join(range->prefix, '.', range->locals[id - range->first]);
+        if (name) {
+            size_t slot = probe_slot(map, name);
+            if (map->slots[slot] == SIGNAL_ID_NONE)
+                map->slots[slot] = id;
+            else // signal_map_reserve bound earlier names to their ids, so this is a second reservation
+                LOG_ERROR("❌ Signal %s was reserved twice (ids %u and %u)", name, (unsigned)map->slots[slot], (unsigned)id);
+            __atomic_store_n(&map->entries[id].name, name, __ATOMIC_RELEASE);
         }
-        entry = entry->next;
     }
+    pthread_mutex_unlock(&map->pending->lock);
+    return name;
+}
+
+static const SignalNameRange *find_range(const SignalMap *map, SignalId id) {
+    const struct SignalNameRanges *pending = map->pending;
+    if (!pending) return NULL;
+    size_t lo = 0, hi = pending->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const SignalNameRange *range = &pending->items[mid];
+        if (id < range->first)
+            hi = mid;
+        else if (id >= range->first + range->count)
+            lo = mid + 1;
+        else
+            return range;
+    }
+    return NULL;
+}
+
+// Reserved id still waiting for this name (interned or not), which is then built for that id alone
+static SignalId find_reserved(SignalMap *map, const char *name) {
+    const struct SignalNameRanges *pending = map->pending;
+    if (!pending || pending->count == 0) return SIGNAL_ID_NONE;
+
+    // Reserved names are "<prefix>.<local>", and either part may contain dots
+    for (const char *dot = strchr(name, '.'); dot; dot = strchr(dot + 1, '.')) {
+        const char *prefix = intern_lookup_n(name, (size_t)(dot - name));
+        const char *local = prefix ? intern_lookup(dot + 1) : NULL;
+        if (!local) continue;
+        for (size_t i = prefix_head(pending, prefix); i != RANGE_NONE; i = pending->items[i].next) {
+            const SignalNameRange *range = &pending->items[i];
+            for (size_t k = 0; k < range->count; ++k) {
+                // Locals bound to an existing signal are found through that signal's slot
+                int bound = range->ids && range->ids[k] != range->first + (SignalId)k;
+                if (range->locals[k] == local && !bound && !map->entries[range->first + k].name)
+                    return name_reserved_id(map, range, range->first + (SignalId)k) ? range->first + (SignalId)k
+                                                                                    : SIGNAL_ID_NONE;
+            }
+        }
+    }
+    return SIGNAL_ID_NONE;
+}
+
+// A name of the new range that is already interned binds to the existing
+// signal, as it did when every name was interned up front
+static int bind_existing_names(SignalMap *map, SignalNameRange *range) {
+    if (!filter_test(map->pending, intern_hash(range->prefix)))
+        return 0;
+
+    size_t prefix_len = intern_length(range->prefix);
+    char buffer[512];
+    for (size_t k = 0; k < range->count; ++k) {
+        size_t local_len = intern_length(range->locals[k]);
+        if (prefix_len + 1 + local_len > sizeof(buffer)) continue; // Longer than any name built with snprintf before
+        memcpy(buffer, range->prefix, prefix_len);
+        buffer[prefix_len] = '.';
+        memcpy(buffer + prefix_len + 1, range->locals[k], local_len);
+        const char *name = intern_lookup_n(buffer, prefix_len + 1 + local_len);
+        SignalId existing = name ? map->slots[probe_slot(map, name)] : SIGNAL_ID_NONE;
+        if (existing == SIGNAL_ID_NONE) continue;
+
+        if (!range->ids) {
+            range->ids = malloc(sizeof(SignalId) * range->count);
+            if (!range->ids) return -1;
+            for (size_t j = 0; j < range->count; ++j)
+                range->ids[j] = range->first + (SignalId)j;
+        }
+        range->ids[k] = existing;
+        map->entries[range->first + k].name = name; // Never bound; unindexed so lookups find the existing id
+        LOG_INFO("🔗 %s was interned before its instance; binding to the existing signal", name);
+    }
+    return 0;
+}
+
+SignalId signal_map_reserve(SignalMap *map, const char *prefix, const char *const *locals, size_t count) {
+    if (!map || !prefix || (!locals && count)) return SIGNAL_ID_NONE;
+    if (count == 0) return (SignalId)map->count;
+
+    struct SignalNameRanges *pending = ensure_ranges(map);
+    if (!pending) return SIGNAL_ID_NONE;
+    if (pending->count == pending->capacity) {
+        size_t new_capacity = pending->capacity ? pending->capacity * 2 : 64;
+        SignalNameRange *items = realloc(pending->items, sizeof(SignalNameRange) * new_capacity);
+        if (!items) return SIGNAL_ID_NONE;
+        pending->items = items;
+        pending->capacity = new_capacity;
+    }
+    if ((pending->count + 1) * 2 > pending->prefix_slot_count && reindex_ranges(pending, pending->count + 1) != 0)
+        return SIGNAL_ID_NONE;
 
-    // Not found – create new entry
-    SignalEntry *new_entry = malloc(sizeof(SignalEntry));
-    if (!new_entry) return;
+    while ((map->count + count) * 2 > map->slot_count)
+        if (grow_slots(map) != 0) return SIGNAL_ID_NONE;
+    if (grow_entries(map, map->count + count) != 0) return SIGNAL_ID_NONE;
 
-    new_entry->name = strdup_safe(name);
-    new_entry->value = strdup_safe(value);
-    new_entry->next = map->head;
-    map->head = new_entry;
+    SignalId first = (SignalId)map->count;
+    for (size_t k = 0; k < count; ++k) {
+        map->entries[first + k].name = NULL;
+        map->entries[first + k].value = NULL;
+        map->bits[first + k] = SIGNAL_BIT_UNSET;
+    }
+    map->count += count;
+    SignalNameRange *range = &pending->items[pending->count];
+    *range = (SignalNameRange){first, count, prefix, locals, NULL, RANGE_NONE};
+    if (bind_existing_names(map, range) != 0) {
+        map->count -= count;
+        return SIGNAL_ID_NONE;
+    }
+    index_range(pending, pending->count++);
+    map->fingerprint = 0;
+    return first;
+}
+
+const SignalId *signal_map_reserved_ids(const SignalMap *map, SignalId first) {
+    const SignalNameRange *range = map ? find_range(map, first) : NULL;
+    return range && range->first == first ? range->ids : NULL;
+}
+
+SignalId signal_map_find(SignalMap *map, const char *name) {
+    if (!map || !name) return SIGNAL_ID_NONE;
+    const char *interned = intern_lookup(name);
+    if (!interned) return find_reserved(map, name); // A reserved name is not interned until asked for
+    SignalId id = map->slots[probe_slot(map, interned)];
+    return id != SIGNAL_ID_NONE ? id : find_reserved(map, interned);
+}
+
+SignalId signal_map_intern(SignalMap *map, const char *name) {
+    if (!map || !name) return SIGNAL_ID_NONE;
+
+    name = intern(name);
+    if (!name) return SIGNAL_ID_NONE;
+    size_t slot = probe_slot(map, name);
+    if (map->slots[slot] != SIGNAL_ID_NONE)
+        return map->slots[slot];
+    SignalId reserved = find_reserved(map, name);
+    if (reserved != SIGNAL_ID_NONE)
+        return reserved;
+    note_direct_name(map, name);
+
+    // Keep the load factor under 1/2 so probe chains stay short
+    if ((map->count + 1) * 2 > map->slot_count) {
+        if (grow_slots(map) != 0) return SIGNAL_ID_NONE;
+        slot = probe_slot(map, name);
+    }
+
+    if (grow_entries(map, map->count + 1) != 0) return SIGNAL_ID_NONE;
+
+    SignalId id = (SignalId)map->count;
+    map->entries[id].name = name;
+    map->entries[id].value = NULL;
+    map->bits[id] = SIGNAL_BIT_UNSET;
+    map->slots[slot] = id;
     map->count++;
+    map->fingerprint = 0;
+    return id;
 }
 
-const char *get_signal_value(SignalMap *map, const char *name) {
-    if (!map || !name) return NULL;
-    SignalEntry *entry = map->head;
-    while (entry) {
-        if (strcmp(entry->name, name) == 0) {
-            return entry->value;
+// Kept ids that are still unnamed stay lazy: each run of them becomes a range
+// at its new ids. Called after the entries moved, so names are read at new ids.
+// The ids bound to existing names were only needed while instantiating.
+static int compact_ranges(struct SignalNameRanges *ranges, const SignalMap *map, const uint8_t *keep,
+                          const SignalId *remap) {
+    size_t run_count = 0;
+    SignalNameRange *runs = NULL;
+    for (int pass = 0; pass < 2; ++pass) {
+        size_t n = 0;
+        for (size_t i = 0; i < ranges->count; ++i) {
+            const SignalNameRange *range = &ranges->items[i];
+            for (size_t k = 0; k < range->count;) {
+                SignalId id = range->first + (SignalId)k;
+                if (!keep[id] || map->entries[remap[id]].name) {
+                    ++k;
+                    continue;
+                }
+                size_t start = k;
+                while (k < range->count && keep[range->first + k] && !map->entries[remap[range->first + k]].name)
+                    ++k;
+                if (runs)
+                    runs[n] = (SignalNameRange){remap[id], k - start, range->prefix, range->locals + start, NULL, RANGE_NONE};
+                n++;
+            }
+        }
+        if (pass == 0) {
+            run_count = n;
+            runs = malloc(sizeof(SignalNameRange) * (n ? n : 1));
+            if (!runs) return -1;
         }
-        entry = entry->next;
     }
-    return NULL;
+
+    size_t *by_prefix = malloc(sizeof(size_t) * 64);
+    if (!by_prefix) {
+        free(runs);
+        return -1;
+    }
+    for (size_t i = 0; i < ranges->count; ++i)
+        free(ranges->items[i].ids);
+    free(ranges->items);
+    free(ranges->by_prefix);
+    ranges->items = runs;
+    ranges->count = run_count;
+    ranges->capacity = run_count ? run_count : 1;
+    ranges->by_prefix = by_prefix;
+    ranges->prefix_slot_count = 64;
+    return reindex_ranges(ranges, run_count);
+}
+
+size_t signal_map_compact(SignalMap *map, const uint8_t *keep, SignalId *remap) {
+    if (!map || !keep || !remap) return 0;
+
+    size_t kept = 0;
+    for (SignalId id = 0; id < map->count; ++id) {
+        if (!keep[id]) {
+            remap[id] = SIGNAL_ID_NONE;
+            continue;
+        }
+        remap[id] = (SignalId)kept;
+        map->entries[kept] = map->entries[id];
+        map->bits[kept] = map->bits[id];
+        kept++;
+    }
+    size_t removed = map->count - kept;
+    map->count = kept;
+    map->fingerprint = 0;
+    if (map->pending && compact_ranges(map->pending, map, keep, remap) != 0)
+        LOG_ERROR("❌ Out of memory renumbering reserved signals; they keep their old numbers");
+
+    // Same slot table size, so rehashing cannot fail
+    memset(map->slots, 0xFF, sizeof(SignalId) * map->slot_count);
+    size_t mask = map->slot_count - 1;
+    for (SignalId id = 0; id < map->count; ++id) {
+        if (!map->entries[id].name)
+            continue; // Reserved id whose name could not be built
+        size_t slot = intern_hash(map->entries[id].name) & mask;
+        while (map->slots[slot] != SIGNAL_ID_NONE)
+            slot = (slot + 1) & mask;
+        map->slots[slot] = id;
+    }
+    return removed;
+}
+
+const char *signal_map_name(SignalMap *map, SignalId id) {
+    if (!map || id >= map->count) return NULL;
+    const char *name = __atomic_load_n(&map->entries[id].name, __ATOMIC_ACQUIRE);
+    if (name) return name;
+    const SignalNameRange *range = find_range(map, id);
+    return range ? name_reserved_id(map, range, id) : NULL;
+}
+
+#define FINGERPRINT_BASIS 14695981039346656037ull // 64-bit FNV-1a
+#define FINGERPRINT_PRIME 1099511628211ull
+
+static uint64_t fingerprint_add(uint64_t h, const char *s, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        h ^= (uint8_t)s[i];
+        h *= FINGERPRINT_PRIME;
+    }
+    return h;
+}
+
+// Reserved names are hashed from their parts, so this names nothing
+uint64_t signal_map_fingerprint(SignalMap *map) {
+    if (!map) return 0;
+    if (map->fingerprint) return map->fingerprint;
+
+    uint64_t h = FINGERPRINT_BASIS;
+    for (SignalId id = 0; id < map->count; ++id) {
+        const char *name = __atomic_load_n(&map->entries[id].name, __ATOMIC_ACQUIRE);
+        const SignalNameRange *range = name ? NULL : find_range(map, id);
+        if (name) {
+            h = fingerprint_add(h, name, intern_length(name));
+        } else if (range) {
+            h = fingerprint_add(h, range->prefix, intern_length(range->prefix));
+            h = fingerprint_add(h, ".", 1);
+            h = fingerprint_add(h, range->locals[id - range->first], intern_length(range->locals[id - range->first]));
+        }
+        h = fingerprint_add(h, "", 1); // The NUL keeps "ab","c" apart from "a","bc"
+    }
+    map->fingerprint = h ? h : 1;
+    return map->fingerprint;
+}
+
+int signal_map_set(SignalMap *map, SignalId id, const char *value) {
+    if (!map || !value || id >= map->count) return 0;
+    SignalEntry *entry = &map->entries[id];
+
+    uint8_t bit = SIGNAL_BIT_WIDE;
+    if ((value[0] == '0' || value[0] == '1') && value[1] == '\0')
+        bit = (uint8_t)(value[0] - '0');
+    if (bit != SIGNAL_BIT_WIDE && bit == map->bits[id])
+        return 0; // same single bit — no need to touch the pool
+
+    const char *interned = bit != SIGNAL_BIT_WIDE ? map->bit_values[bit] : intern(value);
+    if (!interned || entry->value == interned)
+        return 0; // same value — not a change, nothing to store
+
+    entry->value = interned;
+    map->bits[id] = bit;
+    return 1;
+}
+
+const char *signal_map_get(const SignalMap *map, SignalId id) {
+    if (!map || id >= map->count) return NULL;
+    return map->entries[id].value;
+}
+
+int update_signal_value(SignalMap *map, const char *name, const char *value) {
+    if (!map || !name || !value) return 0;
+    return signal_map_set(map, signal_map_intern(map, name), value);
+}
+
+const char *get_signal_value(SignalMap *map, const char *name) {
+    return signal_map_get(map, signal_map_find(map, name));
 }
 
 void print_signal_map(SignalMap *map)
@@ -76,19 +523,23 @@ void print_signal_map(SignalMap *map)
         return;
     }
 
-    LOG_INFO("📡 Signal Map Contents (%zu signals):", map->count);
+    size_t driven = 0;
+    for (size_t i = 0; i < map->count; ++i)
+        if (map->entries[i].value)
+            driven++;
+
+    LOG_INFO("📡 Signal Map Contents (%zu signals):", driven);
 
-    SignalEntry *entry = map->head;
-    while (entry)
+    for (size_t i = 0; i < map->count; ++i)
     {
-        const char *val = entry->value ? entry->value : "NULL";
-        LOG_INFO("   🔹 %s = %s", entry->name, val);
-        entry = entry->next;
+        const SignalEntry *entry = &map->entries[i];
+        if (!entry->value)
+            continue; // interned by an instance but never driven
+        LOG_INFO("   🔹 %s = %s", signal_map_name(map, (SignalId)i), entry->value);
     }
 
-    if (!map->head)
+    if (driven == 0)
     {
         LOG_INFO("   (empty)");
     }
 }
-
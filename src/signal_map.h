@@ -2,22 +2,74 @@
 #define SIGNAL_MAP_H
 
 #include <stddef.h>
+#include <stdint.h>
 
+// Dense handle for a signal name, valid for the lifetime of its SignalMap.
+typedef uint32_t SignalId;
+#define SIGNAL_ID_NONE UINT32_MAX
+
+// Names and values are interned (see intern.h), so equal strings share a pointer
 typedef struct SignalEntry {
-    char *name;
-    char *value;
-    struct SignalEntry *next;
+    const char *name;
+    const char *value;   // NULL until the signal is first driven
 } SignalEntry;
 
+// Single-bit view of each value, kept in step with SignalEntry.value
+#define SIGNAL_BIT_UNSET 0xFF  // Not driven yet
+#define SIGNAL_BIT_WIDE  0xFE  // Driven, but not exactly "0" or "1"
+
 typedef struct {
-    SignalEntry *head;
-    size_t count;
+    SignalEntry *entries;  // Indexed by SignalId, in interning order
+    uint8_t *bits;         // Indexed by SignalId: 0, 1 or SIGNAL_BIT_*
+    size_t count;          // Number of interned signals
+    size_t capacity;
+    SignalId *slots;       // Open-addressing index: name hash → SignalId
+    size_t slot_count;     // Always a power of two
+    const char *bit_values[2]; // Interned "0" and "1", so bit writes skip the pool lock
+    struct SignalNameRanges *pending; // Ids reserved without names yet (see signal_map_reserve)
+    struct SignalStore *store;  // Lock-free copy for other threads, published between eval passes (see signal_store.h)
+    uint64_t fingerprint;  // Cached signal_map_fingerprint; 0 until computed or after ids change
 } SignalMap;
 
 SignalMap *create_signal_map(void);
 void destroy_signal_map(SignalMap *map);
 
-void update_signal_value(SignalMap *map, const char *name, const char *value);
+// ID-based API (resolve once, then read/write without hashing)
+SignalId signal_map_intern(SignalMap *map, const char *name);
+SignalId signal_map_find(SignalMap *map, const char *name); // SIGNAL_ID_NONE if not in the map; names a reserved id it finds
+const char *signal_map_name(SignalMap *map, SignalId id); // Builds a reserved name on first use
+int signal_map_set(SignalMap *map, SignalId id, const char *value);   // 1 if the value changed
+const char *signal_map_get(const SignalMap *map, SignalId id);   // NULL if not driven
+
+static inline uint8_t signal_map_get_bit(const SignalMap *map, SignalId id)
+{
+    return id < map->count ? map->bits[id] : SIGNAL_BIT_UNSET;
+}
+
+// Reserve `count` consecutive ids named "<prefix>.<locals[k]>" without
+// building the names. An id is named only when signal_map_name() asks for
+// it, or when a lookup by name asks for exactly that name. prefix and locals
+// must be interned and outlive the map. signal_map_name() may be called from
+// eval workers; lookups by name must not run concurrently with it.
+//
+// A name that was already interned keeps its signal: check
+// signal_map_reserved_ids() and bind those ids instead of first + k.
+SignalId signal_map_reserve(SignalMap *map, const char *prefix, const char *const *locals, size_t count);
+// NULL when the range starting at first is exactly first .. first + count - 1
+const SignalId *signal_map_reserved_ids(const SignalMap *map, SignalId first);
+
+// Drop every signal with keep[id] == 0 and renumber the rest in order;
+// remap[old id] receives the new id or SIGNAL_ID_NONE. Ids held elsewhere
+// must be rewritten through remap. Kept reserved ids stay unnamed.
+// Returns the number of signals dropped.
+size_t signal_map_compact(SignalMap *map, const uint8_t *keep, SignalId *remap);
+
+// Hash of every name in id order: two maps that agree on it number their
+// signals the same way, so SignalIds can travel between them. Never 0.
+uint64_t signal_map_fingerprint(SignalMap *map);
+
+// String API (thin wrappers over the ID API)
+int update_signal_value(SignalMap *map, const char *name, const char *value); // 1 if the value changed
 const char *get_signal_value(SignalMap *map, const char *name); // NULL if not found
 void print_signal_map(SignalMap* map);
 #endif
@@ -0,0 +1,155 @@
+#define _POSIX_C_SOURCE 200809L // sched_yield
+#include "signal_store.h"
+#include "log.h"
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct RetiredArrays {
+    uint8_t *bits;
+    const char **values;
+    struct RetiredArrays *next;
+};
+
+SignalStore *create_signal_store(void)
+{
+    return calloc(1, sizeof(SignalStore));
+}
+
+void destroy_signal_store(SignalStore *store)
+{
+    if (!store)
+        return;
+    while (store->retired)
+    {
+        struct RetiredArrays *next = store->retired->next;
+        free(store->retired->bits);
+        free(store->retired->values);
+        free(store->retired);
+        store->retired = next;
+    }
+    free(store->bits);
+    free(store->values);
+    free(store);
+}
+
+// Outside the write section: readers keep copying the current arrays meanwhile
+static int grow_store(SignalStore *store, size_t needed, uint8_t **bits, const char ***values)
+{
+    size_t capacity = store->capacity ? store->capacity : 64;
+    while (capacity < needed)
+        capacity *= 2;
+
+    struct RetiredArrays *retired = malloc(sizeof(struct RetiredArrays));
+    *bits = malloc(capacity);
+    *values = malloc(sizeof(const char *) * capacity);
+    if (!retired || !*bits || !*values)
+    {
+        free(retired);
+        free(*bits);
+        free(*values);
+        return -1;
+    }
+
+    retired->bits = store->bits;
+    retired->values = store->values;
+    retired->next = store->retired;
+    store->retired = retired;
+    store->capacity = capacity;
+    return 0;
+}
+
+void signal_store_publish(SignalStore *store, const SignalMap *map)
+{
+    if (!store || !map)
+        return;
+
+    size_t count = map->count;
+    uint8_t *bits = store->bits;
+    const char **values = store->values;
+    if (count > store->capacity && grow_store(store, count, &bits, &values) != 0)
+    {
+        LOG_WARN("⚠️ Signal store could not grow to %zu signal(s); publishing the first %zu", count, store->capacity);
+        count = store->capacity;
+    }
+
+    // Only this thread writes seq, so a plain read of it is current
+    uint32_t seq = store->seq;
+    __atomic_store_n(&store->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    __atomic_store_n(&store->bits, bits, __ATOMIC_RELAXED);
+    __atomic_store_n(&store->values, values, __ATOMIC_RELAXED);
+    // Release: a reader that sees this count also sees arrays large enough for it
+    __atomic_store_n(&store->count, count, __ATOMIC_RELEASE);
+    for (size_t id = 0; id < count; ++id)
+    {
+        __atomic_store_n(&bits[id], map->bits[id], __ATOMIC_RELAXED);
+        __atomic_store_n(&values[id], map->entries[id].value, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&store->epoch, store->epoch + 1, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&store->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+static int reserve_snapshot(StoreSnapshot *snapshot, size_t count)
+{
+    if (count <= snapshot->capacity)
+        return 0;
+    uint8_t *bits = realloc(snapshot->bits, count);
+    if (!bits)
+        return -1;
+    snapshot->bits = bits;
+    const char **values = realloc(snapshot->values, sizeof(const char *) * count);
+    if (!values)
+        return -1;
+    snapshot->values = values;
+    snapshot->capacity = count;
+    return 0;
+}
+
+int signal_store_read(const SignalStore *store, StoreSnapshot *snapshot)
+{
+    if (!store || !snapshot)
+        return -1;
+
+    for (;;)
+    {
+        uint32_t begin = __atomic_load_n(&store->seq, __ATOMIC_ACQUIRE);
+        if (begin & 1)
+        {
+            sched_yield(); // A publish is a short copy; let the writer finish it
+            continue;
+        }
+
+        size_t count = __atomic_load_n(&store->count, __ATOMIC_ACQUIRE);
+        const uint8_t *bits = __atomic_load_n(&store->bits, __ATOMIC_RELAXED);
+        const char *const *values = __atomic_load_n(&store->values, __ATOMIC_RELAXED);
+        uint64_t epoch = __atomic_load_n(&store->epoch, __ATOMIC_RELAXED);
+        if (reserve_snapshot(snapshot, count) != 0)
+            return -1;
+
+        for (size_t id = 0; id < count; ++id)
+        {
+            snapshot->bits[id] = __atomic_load_n(&bits[id], __ATOMIC_RELAXED);
+            snapshot->values[id] = __atomic_load_n(&values[id], __ATOMIC_RELAXED);
+        }
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&store->seq, __ATOMIC_RELAXED) == begin)
+        {
+            snapshot->epoch = epoch;
+            snapshot->count = count;
+            return 0;
+        }
+    }
+}
+
+void store_snapshot_free(StoreSnapshot *snapshot)
+{
+    if (!snapshot)
+        return;
+    free(snapshot->bits);
+    free(snapshot->values);
+    memset(snapshot, 0, sizeof(*snapshot));
+}
@@ -0,0 +1,42 @@
+#ifndef SIGNAL_STORE_H
+#define SIGNAL_STORE_H
+#include "signal_map.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Read side of the signal values for other threads (OSC /poll, exporters).
+// The eval thread is the only writer: between passes it copies the map's
+// bits and value pointers into the store's flat arrays inside a sequence
+// counter (seqlock). Readers copy out and retry if the counter moved while
+// they read, so they never take a lock and never hold up evaluation.
+// Values are interned strings, which live for the whole process.
+
+typedef struct SignalStore {
+    uint32_t seq;           // Odd while a publish is in progress
+    uint64_t epoch;         // Completed publishes
+    size_t count;           // Signals in the current publish
+    size_t capacity;
+    uint8_t *bits;          // By SignalId, as SignalMap.bits
+    const char **values;    // By SignalId, as SignalEntry.value
+    struct RetiredArrays *retired; // Outgrown arrays, kept until destroy: a reader may still be copying them
+} SignalStore;
+
+// A reader's private copy; reuse it across reads to avoid reallocating
+typedef struct StoreSnapshot {
+    uint64_t epoch;
+    size_t count;
+    size_t capacity;
+    uint8_t *bits;
+    const char **values;
+} StoreSnapshot;
+
+SignalStore *create_signal_store(void);
+void destroy_signal_store(SignalStore *store); // Once no reader can be running
+
+void signal_store_publish(SignalStore *store, const SignalMap *map); // Writer only; NULL store is a no-op
+
+// Consistent copy of the last publish; 0 on success, -1 if out of memory
+int signal_store_read(const SignalStore *store, StoreSnapshot *snapshot);
+void store_snapshot_free(StoreSnapshot *snapshot);
+
+#endif
@@ -1,26 +1,28 @@
 #include "string_list.h"
+#include "intern.h"
 #include <stdlib.h>
 #include <string.h>
 
-StringList *create_string_list(void)
+StringList *create_string_list_in(Arena *arena)
 {
-    StringList *set = malloc(sizeof(StringList));
-    set->head = NULL;
-    set->tail = NULL;
-    set->size = 0;
+    StringList *set = arena_calloc(arena, 1, sizeof(StringList));
+    if (set)
+        set->arena = arena;
     return set;
 }
 
+StringList *create_string_list(void)
+{
+    return create_string_list_in(NULL);
+}
+
 void destroy_string_list(StringList *set)
 {
-    StringListEntry *cur = set->head;
-    while (cur)
-    {
-        StringListEntry *next = cur->next;
-        free(cur->key);
-        free(cur);
-        cur = next;
-    }
+    if (!set || set->arena)
+        return; // Arena-backed lists go away with their arena
+
+    free(set->items);
+    free(set->index);
     free(set);
 }
 
@@ -28,63 +30,126 @@ StringList *string_list_clone(const StringList *src)
 {
     if (!src) return NULL;
 
-    StringList *clone = create_string_list();
+    StringList *clone = create_string_list_in(src->arena);
     if (!clone) return NULL;
 
-    for (StringListEntry *cur = src->head; cur; cur = cur->next)
+    clone->items = arena_alloc(src->arena, sizeof(const char *) * (src->size ? src->size : 1));
+    if (!clone->items)
     {
-        string_list_add(clone, cur->key);
+        arena_free(src->arena, clone);
+        return NULL;
     }
+    clone->capacity = src->size ? src->size : 1;
+
+    // Entries are interned and already unique, so a flat copy is enough
+    memcpy(clone->items, src->items, sizeof(const char *) * src->size);
+    clone->size = src->size;
 
     return clone;
 }
 
 
-size_t string_list_count(StringList *set)
+size_t string_list_count(const StringList *set)
 {
     return set ? set->size : 0;
 }
 
-int string_list_contains(StringList *set, const char *key)
+static void index_insert(StringList *list, size_t position)
 {
-    for (StringListEntry *cur = set->head; cur; cur = cur->next)
+    size_t mask = list->index_slots - 1;
+    size_t slot = intern_hash(list->items[position]) & mask;
+    while (list->index[slot])
+        slot = (slot + 1) & mask;
+    list->index[slot] = (uint32_t)(position + 1);
+}
+
+static void rebuild_index(StringList *list)
+{
+    size_t slots = 32;
+    while (slots < list->size * 2)
+        slots *= 2;
+
+    arena_free(list->arena, list->index);
+    list->index = arena_calloc(list->arena, slots, sizeof(uint32_t));
+    list->index_slots = list->index ? slots : 0;
+    if (!list->index)
+        return;
+
+    for (size_t i = 0; i < list->size; ++i)
+        index_insert(list, i);
+}
+
+// key must already be interned; entries are compared by pointer
+static int contains_interned(StringList *set, const char *key)
+{
+    if (set->size >= STRING_LIST_INDEX_THRESHOLD && !set->index_slots)
+        rebuild_index(set);
+
+    if (!set->index_slots)
+    {
+        for (size_t i = 0; i < set->size; ++i)
+            if (set->items[i] == key)
+                return 1;
+        return 0;
+    }
+
+    size_t mask = set->index_slots - 1;
+    for (size_t slot = intern_hash(key) & mask; set->index[slot]; slot = (slot + 1) & mask)
     {
-        if (strcmp(cur->key, key) == 0)
+        if (set->items[set->index[slot] - 1] == key)
             return 1;
     }
     return 0;
 }
 
+int string_list_contains(StringList *set, const char *key)
+{
+    if (!set || !key)
+        return 0;
+
+    // A string that was never interned cannot be in any list
+    const char *interned = intern_lookup(key);
+    return interned ? contains_interned(set, interned) : 0;
+}
+
 void string_list_add(StringList *string_list, const char *key)
 {
-    if (string_list_contains(string_list, key))
+    if (!string_list || !key)
         return;
 
-    StringListEntry *entry = malloc(sizeof(StringListEntry));
-    entry->key = strdup(key);
-    entry->next = NULL;
+    const char *interned = intern(key);
+    if (!interned || contains_interned(string_list, interned))
+        return;
 
-    if (!string_list->head)
-        string_list->head = entry;
-    else
-        string_list->tail->next = entry;
+    if (string_list->size == string_list->capacity)
+    {
+        size_t capacity = string_list->capacity ? string_list->capacity * 2 : 4;
+        const char **items = arena_realloc(string_list->arena, string_list->items,
+                                           sizeof(const char *) * string_list->capacity,
+                                           sizeof(const char *) * capacity);
+        if (!items)
+            return;
+        string_list->items = items;
+        string_list->capacity = capacity;
+    }
 
-    string_list->tail = entry;
-    string_list->size += 1;
+    size_t position = string_list->size++;
+    string_list->items[position] = interned;
+
+    if (string_list->index_slots)
+    {
+        // Keep the load factor under 1/2; otherwise insert in place
+        if (string_list->size * 2 > string_list->index_slots)
+            rebuild_index(string_list);
+        else
+            index_insert(string_list, position);
+    }
 }
 
 char *string_list_get_by_index(StringList *string_list, size_t index)
 {
-    if (!string_list || index >= string_list->size)
-        return NULL;
-
-    size_t i = 0;
-    for (StringListEntry *cur = string_list->head; cur; cur = cur->next)
-    {
-        if (i++ == index)
-            return strdup(cur->key);  // 🔐 Safe copy for caller
-    }
-    return NULL;
+    const char *key = string_list_get(string_list, index);
+    return key ? strdup(key) : NULL;
 }
 
 void string_list_set_by_index(StringList *list, size_t index, const char *new_value)
@@ -92,18 +157,14 @@ void string_list_set_by_index(StringList *list, size_t index, const char *new_va
     if (!list || index >= list->size || !new_value)
         return;
 
-    size_t i = 0;
-    for (StringListEntry *cur = list->head; cur; cur = cur->next)
-    {
-        if (i++ == index)
-        {
-            // Copy new_value *before* freeing old one
-            char *copy = strdup(new_value);
-            if (!copy) return;
-
-            free(cur->key);  // free after safe copy
-            cur->key = copy;
-            return;
-        }
-    }
+    const char *interned = intern(new_value);
+    if (!interned || interned == list->items[index])
+        return;
+
+    list->items[index] = interned;
+
+    // Positions are stable but the key moved; rebuild lazily on next lookup
+    arena_free(list->arena, list->index);
+    list->index = NULL;
+    list->index_slots = 0;
 }
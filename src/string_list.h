@@ -2,26 +2,37 @@
 #define STRING_LIST_H
 
 #include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
 
-typedef struct StringListEntry {
-    char *key;
-    struct StringListEntry *next;
-} StringListEntry;
+// Lists at least this long get a hash index for string_list_contains
+#define STRING_LIST_INDEX_THRESHOLD 16
 
 typedef struct {
-    StringListEntry *head;
-    StringListEntry *tail;
+    const char **items;    // Contiguous, in insertion order; interned (see intern.h)
     size_t size;
+    size_t capacity;
+    uint32_t *index;       // Open-addressing slots holding item position + 1 (0 = empty)
+    size_t index_slots;    // Power of two; 0 while the list is small or the index is stale
+    Arena *arena;          // Backing arena for the list and its arrays; NULL = heap
 } StringList;
 
 StringList *create_string_list(void);
+StringList *create_string_list_in(Arena *arena);   // Released with the arena
 StringList *string_list_clone(const StringList *src);
 void destroy_string_list(StringList *set);
 void string_list_add(StringList *set, const char *key);
-char *string_list_get_by_index(StringList *string_list, size_t index);
+
+// Interned pointer, valid for the life of the process
+static inline const char *string_list_get(const StringList *list, size_t index)
+{
+    return (list && index < list->size) ? list->items[index] : NULL;
+}
+
+char *string_list_get_by_index(StringList *string_list, size_t index); // Owned copy; caller frees
 void string_list_set_by_index(StringList *list, size_t index, const char *new_value);
 int string_list_contains(StringList *set, const char *key);
-size_t string_list_count(StringList *set);
+size_t string_list_count(const StringList *set);
 
 
 #endif
@@ -0,0 +1,304 @@
+#define _POSIX_C_SOURCE 200809L // sched_yield
+#include "thread_pool.h"
+#include "log.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Ready tasks of one worker. The owner pushes and pops at the back, thieves
+// take from the front. The spinlock only covers moving an index, never a task.
+typedef struct TaskDeque {
+    uint32_t *tasks;
+    size_t front;               // Next task to steal
+    size_t back;                // One past the owner's newest task
+    size_t capacity;
+    int locked;
+    char pad[64 - sizeof(uint32_t *) - 3 * sizeof(size_t) - sizeof(int)];
+} TaskDeque;
+
+typedef struct PoolWorker {
+    struct ThreadPool *pool;
+    size_t id;
+    pthread_t thread;
+} PoolWorker;
+
+struct ThreadPool {
+    PoolWorker *workers;        // Worker 0 is the calling thread and has no pthread
+    TaskDeque *deques;          // One per worker
+    size_t size;
+
+    // Posting a job and waiting for workers to leave it; not used while it runs
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;  // New job posted, or shutdown
+    pthread_cond_t job_done;    // A worker left the job
+    unsigned long generation;
+    int shutdown;
+    size_t busy_workers;        // Pool threads still inside the job
+
+    // Current job
+    ThreadPoolTask fn;
+    void *ctx;
+    const uint32_t *succ_first;
+    const uint32_t *succs;
+    uint32_t *pending;          // Unfinished predecessors per task (atomic)
+    size_t remaining;           // Tasks not yet finished (atomic)
+};
+
+static void deque_lock(TaskDeque *deque)
+{
+    while (__atomic_exchange_n(&deque->locked, 1, __ATOMIC_ACQUIRE))
+        while (__atomic_load_n(&deque->locked, __ATOMIC_RELAXED))
+            ;
+}
+
+static void deque_unlock(TaskDeque *deque)
+{
+    __atomic_store_n(&deque->locked, 0, __ATOMIC_RELEASE);
+}
+
+// Owner only. A task is pushed once per run, so front/back never wrap within one.
+static int deque_push(TaskDeque *deque, uint32_t task)
+{
+    deque_lock(deque);
+    if (deque->back == deque->capacity)
+    {
+        size_t capacity = deque->capacity ? deque->capacity * 2 : 64;
+        uint32_t *grown = realloc(deque->tasks, capacity * sizeof(uint32_t));
+        if (!grown)
+        {
+            deque_unlock(deque);
+            return -1;
+        }
+        deque->tasks = grown;
+        deque->capacity = capacity;
+    }
+    deque->tasks[deque->back] = task;
+    __atomic_store_n(&deque->back, deque->back + 1, __ATOMIC_RELAXED); // Thieves peek at back/front unlocked
+    deque_unlock(deque);
+    return 0;
+}
+
+static int deque_pop(TaskDeque *deque, uint32_t *task)
+{
+    deque_lock(deque);
+    int found = deque->back > deque->front;
+    if (found)
+    {
+        *task = deque->tasks[deque->back - 1];
+        __atomic_store_n(&deque->back, deque->back - 1, __ATOMIC_RELAXED);
+    }
+    deque_unlock(deque);
+    return found;
+}
+
+static int deque_steal(TaskDeque *deque, uint32_t *task)
+{
+    if (__atomic_load_n(&deque->back, __ATOMIC_RELAXED) == __atomic_load_n(&deque->front, __ATOMIC_RELAXED))
+        return 0; // Looks empty; not worth the lock
+
+    deque_lock(deque);
+    int found = deque->back > deque->front;
+    if (found)
+    {
+        *task = deque->tasks[deque->front];
+        __atomic_store_n(&deque->front, deque->front + 1, __ATOMIC_RELAXED);
+    }
+    deque_unlock(deque);
+    return found;
+}
+
+// Newest own task first (its inputs are still in cache), else the oldest of a neighbour's
+static int take_task(ThreadPool *pool, size_t worker, uint32_t *task)
+{
+    if (deque_pop(&pool->deques[worker], task))
+        return 1;
+    for (size_t i = 1; i < pool->size; ++i)
+        if (deque_steal(&pool->deques[(worker + i) % pool->size], task))
+            return 1;
+    return 0;
+}
+
+static void run_task(ThreadPool *pool, size_t worker, uint32_t task)
+{
+    pool->fn(pool->ctx, task, worker);
+
+    for (uint32_t e = pool->succ_first[task]; e < pool->succ_first[task + 1]; ++e)
+    {
+        uint32_t next = pool->succs[e];
+        if (__atomic_sub_fetch(&pool->pending[next], 1, __ATOMIC_ACQ_REL) != 0)
+            continue;
+        if (deque_push(&pool->deques[worker], next) != 0)
+            run_task(pool, worker, next); // No room to queue it: run it here
+    }
+
+    __atomic_sub_fetch(&pool->remaining, 1, __ATOMIC_RELEASE);
+}
+
+static void run_job(ThreadPool *pool, size_t worker)
+{
+    while (__atomic_load_n(&pool->remaining, __ATOMIC_ACQUIRE) > 0)
+    {
+        uint32_t task;
+        if (take_task(pool, worker, &task))
+            run_task(pool, worker, task);
+        else
+            sched_yield(); // Everything ready is taken; the rest waits on tasks in flight
+    }
+}
+
+static void *worker_main(void *arg)
+{
+    PoolWorker *self = arg;
+    ThreadPool *pool = self->pool;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;)
+    {
+        while (!pool->shutdown && pool->generation == seen)
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        if (pool->shutdown)
+            break;
+        seen = pool->generation;
+
+        pthread_mutex_unlock(&pool->lock);
+        run_job(pool, self->id);
+        pthread_mutex_lock(&pool->lock);
+
+        pool->busy_workers--;
+        pthread_cond_broadcast(&pool->job_done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+ThreadPool *thread_pool_create(size_t threads)
+{
+    if (threads == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (threads > THREAD_POOL_MAX_THREADS)
+        threads = THREAD_POOL_MAX_THREADS;
+
+    ThreadPool *pool = calloc(1, sizeof(ThreadPool));
+    if (!pool)
+        return NULL;
+    pool->workers = calloc(threads, sizeof(PoolWorker));
+    pool->deques = calloc(threads, sizeof(TaskDeque));
+    if (!pool->workers || !pool->deques)
+    {
+        free(pool->workers);
+        free(pool->deques);
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->job_done, NULL);
+
+    pool->size = 1;
+    pool->workers[0].pool = pool;
+    for (size_t i = 1; i < threads; ++i)
+    {
+        PoolWorker *w = &pool->workers[i];
+        w->pool = pool;
+        w->id = i;
+        if (pthread_create(&w->thread, NULL, worker_main, w) != 0)
+        {
+            LOG_WARN("⚠️ Started %zu of %zu pool threads", pool->size, threads);
+            break;
+        }
+        pool->size++;
+    }
+
+    return pool;
+}
+
+void thread_pool_destroy(ThreadPool *pool)
+{
+    if (!pool)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 1; i < pool->size; ++i)
+        pthread_join(pool->workers[i].thread, NULL);
+
+    pthread_cond_destroy(&pool->job_done);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_mutex_destroy(&pool->lock);
+    for (size_t i = 0; i < pool->size; ++i)
+        free(pool->deques[i].tasks);
+    free(pool->deques);
+    free(pool->workers);
+    free(pool);
+}
+
+size_t thread_pool_size(const ThreadPool *pool)
+{
+    return pool ? pool->size : 1;
+}
+
+void thread_pool_run_graph(ThreadPool *pool, size_t task_count, const uint32_t *dep_count,
+                           const uint32_t *succ_first, const uint32_t *succs,
+                           ThreadPoolTask fn, void *ctx)
+{
+    uint32_t *pending = pool && pool->size > 1 && task_count > 0 ? malloc(task_count * sizeof(uint32_t)) : NULL;
+
+    // No pool (or no memory for the counters): predecessors come first in index order
+    if (!pending)
+    {
+        for (size_t task = 0; task < task_count; ++task)
+            fn(ctx, task, 0);
+        return;
+    }
+
+    // Workers are all parked, so the setup needs no atomics; the broadcast publishes it
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->succ_first = succ_first;
+    pool->succs = succs;
+    pool->pending = pending;
+    pool->remaining = task_count;
+    for (size_t i = 0; i < pool->size; ++i)
+        pool->deques[i].front = pool->deques[i].back = 0;
+
+    // Sources are dealt round-robin so every worker starts with something of its own
+    size_t dealt = 0;
+    for (size_t task = 0; task < task_count; ++task)
+    {
+        pending[task] = dep_count[task];
+        if (dep_count[task] == 0 && deque_push(&pool->deques[dealt++ % pool->size], (uint32_t)task) != 0)
+        {
+            // Cannot even queue the sources: run the whole graph in index order here
+            free(pending);
+            pool->pending = NULL;
+            for (size_t t = 0; t < task_count; ++t)
+                fn(ctx, t, 0);
+            return;
+        }
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->busy_workers = pool->size - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    run_job(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy_workers > 0)
+        pthread_cond_wait(&pool->job_done, &pool->lock);
+    pool->pending = NULL;
+    pthread_mutex_unlock(&pool->lock);
+
+    free(pending);
+}
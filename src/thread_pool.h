@@ -0,0 +1,35 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed set of worker threads for running a graph of small tasks. The
+// calling thread works too, so a pool of size 1 runs everything inline.
+//
+// Each task carries a count of the tasks it waits on. The worker that
+// finishes a task's last predecessor pushes it onto its own deque. Idle
+// workers pop their own deque from the back and steal from the front of the
+// others. There is no barrier between levels and no pool-wide lock while a
+// graph runs: a task starts as soon as its own inputs are done.
+
+#define THREAD_POOL_MAX_THREADS 1024 // Upper bound for a requested pool size
+
+typedef struct ThreadPool ThreadPool;
+
+// task is the task index; worker is in [0, thread_pool_size)
+typedef void (*ThreadPoolTask)(void *ctx, size_t task, size_t worker);
+
+ThreadPool *thread_pool_create(size_t threads);   // 0 → one per online CPU
+void thread_pool_destroy(ThreadPool *pool);
+size_t thread_pool_size(const ThreadPool *pool);
+
+// Runs tasks 0 .. task_count - 1. Task t starts after its dep_count[t]
+// predecessors have finished; the tasks waiting on t are
+// succs[succ_first[t] .. succ_first[t + 1]). Every predecessor of t must
+// have a smaller index, so index order is always a valid serial order.
+// Returns once all tasks have run.
+void thread_pool_run_graph(ThreadPool *pool, size_t task_count, const uint32_t *dep_count,
+                           const uint32_t *succ_first, const uint32_t *succs,
+                           ThreadPoolTask fn, void *ctx);
+
+#endif
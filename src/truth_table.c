@@ -0,0 +1,66 @@
+#include "truth_table.h"
+#include "log.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void discard_table(TruthTable *table, Arena *arena)
+{
+    arena_free(arena, table->rows);
+    arena_free(arena, table);
+}
+
+TruthTable *compile_truth_table(const ConditionalInvocation *ci, Arena *arena)
+{
+    if (!ci || ci->arg_count == 0 || ci->arg_count > TRUTH_TABLE_MAX_ARGS || !ci->cases)
+        return NULL;
+
+    size_t row_count = (size_t)1 << ci->arg_count;
+    TruthTable *table = arena_alloc(arena, sizeof(TruthTable));
+    if (!table)
+        return NULL;
+
+    table->arg_count = ci->arg_count;
+    table->rows = arena_alloc(arena, sizeof(uint16_t) * row_count);
+    if (!table->rows)
+    {
+        arena_free(arena, table);
+        return NULL;
+    }
+    for (size_t r = 0; r < row_count; ++r)
+        table->rows[r] = TRUTH_TABLE_NO_CASE;
+
+    for (size_t i = 0; i < ci->case_count; ++i)
+    {
+        const char *pattern = ci->cases[i].pattern;
+        if (!pattern || strlen(pattern) != ci->arg_count || i >= TRUTH_TABLE_NO_CASE)
+        {
+            discard_table(table, arena);
+            return NULL;
+        }
+
+        uint32_t row = 0;
+        for (size_t b = 0; b < ci->arg_count; ++b)
+        {
+            if (pattern[b] != '0' && pattern[b] != '1')
+            {
+                discard_table(table, arena);
+                return NULL;
+            }
+            row = (row << 1) | (uint32_t)(pattern[b] - '0');
+        }
+
+        // First matching case wins, as in the string matcher
+        if (table->rows[row] == TRUTH_TABLE_NO_CASE)
+            table->rows[row] = (uint16_t)i;
+    }
+
+    return table;
+}
+
+void destroy_truth_table(TruthTable *table)
+{
+    if (!table)
+        return;
+    free(table->rows);
+    free(table);
+}
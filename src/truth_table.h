@@ -0,0 +1,30 @@
+#ifndef TRUTH_TABLE_H
+#define TRUTH_TABLE_H
+#include "invocation.h"
+#include "arena.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// Dense tables are 2^arg_count rows; wider templates stay on the string path
+#define TRUTH_TABLE_MAX_ARGS 16
+#define TRUTH_TABLE_NO_CASE UINT16_MAX
+
+// A ConditionalInvocation compiled to a lookup indexed by its packed input
+// bits. Template arg 0 is the most significant bit, matching the order the
+// Case patterns are written in.
+typedef struct TruthTable {
+    size_t arg_count;
+    uint16_t *rows;   // Row → index into ConditionalInvocation.cases, or TRUTH_TABLE_NO_CASE
+} TruthTable;
+
+// NULL if the template is too wide or any Case pattern is not a plain bit string.
+// Allocated from arena (NULL = heap); destroy_truth_table is for heap tables only.
+TruthTable *compile_truth_table(const ConditionalInvocation *ci, Arena *arena);
+void destroy_truth_table(TruthTable *table);
+
+static inline uint16_t truth_table_lookup(const TruthTable *table, uint32_t row)
+{
+    return table->rows[row];
+}
+
+#endif
@@ -58,7 +58,7 @@ int main(int argc, char **argv) {
             continue;
         }
 
-        ConditionalInvocation *ci = parse_conditional_invocation(ci_expr);
+        ConditionalInvocation *ci = parse_conditional_invocation(ci_expr, NULL); // Heap-allocated; the tool exits right after
         if (!ci) {
             LOG_ERROR("❌ Invalid ConditionalInvocation in %s", entry->d_name);
             errors++;
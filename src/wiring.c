@@ -7,7 +7,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-void dump_wiring(Block *blk)
+
+static void dump_ports(SignalMap *signal_map, const SignalId *ids, size_t count, const char *bullet)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        LOG_INFO("%s%s", bullet, signal_map_name(signal_map, ids[i]));
+    }
+}
+
+void dump_wiring(Block *blk, SignalMap *signal_map)
 {
     LOG_INFO("🧪 Dumping wiring for all instances in block: %s", psi_to_string(&blk->psi));
 
@@ -31,24 +40,18 @@ void dump_wiring(Block *blk)
             LOG_INFO("    ▶ Invocation Target: %s", instance->invocation->target_name);
 
             LOG_INFO("    ▶ Input Signals:");
-            for (size_t i = 0; i < string_list_count(instance->invocation->input_signals); ++i)
-            {
-                LOG_INFO("       - %s", string_list_get_by_index(instance->invocation->input_signals, i));
-            }
+            dump_ports(signal_map, instance->input_ids, instance->input_count, "       - ");
 
             LOG_INFO("    ▶ Output Signals:");
-            for (size_t i = 0; i < string_list_count(instance->invocation->output_signals); ++i)
-            {
-                LOG_INFO("       - %s", string_list_get_by_index(instance->invocation->output_signals, i));
-            }
+            dump_ports(signal_map, instance->output_ids, instance->output_count, "       - ");
 
-            if (instance->invocation->literal_bindings && instance->invocation->literal_bindings->count > 0)
+            if (instance->literal_count > 0)
             {
                 LOG_INFO("    ▶ Literal Bindings:");
-                for (size_t i = 0; i < instance->invocation->literal_bindings->count; ++i)
+                for (size_t i = 0; i < instance->literal_count; ++i)
                 {
-                    LiteralBinding *binding = &instance->invocation->literal_bindings->items[i];
-                    LOG_INFO("       - %s = %s", binding->name, binding->value);
+                    const LiteralBinding *binding = &instance->invocation->literal_bindings->items[i];
+                    LOG_INFO("       - %s = %s", signal_map_name(signal_map, instance->literal_ids[i]), binding->value);
                 }
             }
         }
@@ -59,31 +62,18 @@ void dump_wiring(Block *blk)
             LOG_INFO("    ▶ Definition: %s", instance->definition->name);
 
             LOG_INFO("    ▶ Definition Inputs:");
-            for (size_t i = 0; i < string_list_count(instance->definition->input_signals); ++i)
-            {
-                LOG_INFO("       - %s", string_list_get_by_index(instance->definition->input_signals, i));
-            }
+            dump_ports(signal_map, instance->def_input_ids, instance->def_input_count, "       - ");
 
             LOG_INFO("    ▶ Definition Outputs:");
-            if (instance->definition->output_signals)
-            {
-                StringList *sl = instance->definition->output_signals;
-                for (size_t i = 0; i < string_list_count(sl); ++i)
-                {
-                    LOG_INFO("       - %s", string_list_get_by_index(sl, i));
-                }
-            }
+            dump_ports(signal_map, instance->def_output_ids, instance->def_output_count, "       - ");
 
             if (instance->definition->conditional_invocation)
             {
                 LOG_INFO("    ▶ Conditional Logic:");
-                ConditionalInvocation *ci = instance->definition->conditional_invocation;
+                const ConditionalInvocation *ci = instance->definition->conditional_invocation;
 
                 LOG_INFO("       Pattern Args:");
-                for (size_t i = 0; i < string_list_count(ci->pattern_args); ++i)
-                {
-                    LOG_INFO("         - %s", string_list_get_by_index(ci->pattern_args, i));
-                }
+                dump_ports(signal_map, instance->pattern_ids, instance->pattern_count, "         - ");
 
                 LOG_INFO("       Output: %s", ci->output);
 
@@ -4,5 +4,5 @@
 #include <sqlite3.h>
 #include "eval.h"
 
-void dump_wiring(Block* blk);
+void dump_wiring(Block* blk, SignalMap *signal_map);
 #endif
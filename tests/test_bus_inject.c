@@ -0,0 +1,89 @@
+#include "test_util.h"
+#include "arena.h"
+#include "block.h"
+#include "eval.h"
+#include "eval_util.h"
+#include "gap.h"
+#include "intern.h"
+#include "pubsub.h"
+#include "sexpr_parser.h"
+#include "signal_map.h"
+
+// Values another node puts on the bus must reach the signals that read them
+// in every evaluation mode, not only in the sweep. The bus_inject fixture has:
+//   RELAY  R = NOT BUS         BUS has no writer here; only the bus drives it
+//   FOLLOW F = R
+// Each mode evaluates once with BUS unknown, then gets a batch from another
+// node and must carry it through R to F within the next evaluation.
+
+static void build(Block *blk, SignalMap *map, const char *inv_dir)
+{
+    blk->arena = arena_create(0);
+    parse_block_from_sexpr(blk, inv_dir);
+    unify_invocations(blk, map);
+    publish_all_literal_bindings(blk, map);
+}
+
+// A batch as another node sends it: its psi is not ours, so poll_pubsub keeps it
+static void inject(SignalMap *map, const char *signal_name, const char *value)
+{
+    GAPUpdateValue update = {signal_map_find(map, signal_name), intern(value)};
+    size_t payload_len = gap_signal_batch_size(1, gap_value_text_len(update.value));
+    GAPPacket *packet = calloc(1, sizeof(GAPPacket) + payload_len);
+    CHECK(packet != NULL && update.id != SIGNAL_ID_NONE);
+    if (!packet)
+        return;
+    packet->version = 1;
+    packet->type = GAP_SIGNAL_BATCH;
+    packet->payload_len = (uint32_t)payload_len;
+    memset(&packet->psi, 0xA5, sizeof(packet->psi));
+    gap_encode_signal_batch((GAPSignalBatch *)packet->payload, signal_map_fingerprint(map), &update, 1);
+    publish_packet(packet);
+    free(packet);
+}
+
+static void test_mode(const char *inv_dir, EvalMode mode)
+{
+    EvalOptions options = {0};
+    options.mode = mode;
+    options.threads = 2;
+
+    SignalMap *map = create_signal_map();
+    Block blk = {0};
+    build(&blk, map, inv_dir);
+
+    eval_with_options(&blk, map, &options);
+    CHECK_STR(get_signal_value(map, "BUS"), NULL);
+    CHECK_STR(get_signal_value(map, "F"), NULL);
+
+    inject(map, "BUS", "0");
+    eval_with_options(&blk, map, &options);
+    CHECK_STR(get_signal_value(map, "BUS"), "0");
+    CHECK_STR(get_signal_value(map, "R"), "1");
+    CHECK_STR(get_signal_value(map, "F"), "1");
+
+    // A later change travels the same way
+    inject(map, "BUS", "1");
+    eval_with_options(&blk, map, &options);
+    CHECK_STR(get_signal_value(map, "R"), "0");
+    CHECK_STR(get_signal_value(map, "F"), "0");
+
+    block_release(&blk);
+    destroy_signal_map(map);
+}
+
+int main(int argc, char **argv)
+{
+    const char *inv_dir = argc > 1 ? argv[1] : "tests/data/bus_inject";
+    test_quiet_logs();
+    init_pubsub();
+
+    test_mode(inv_dir, EVAL_MODE_EVENT);
+    test_mode(inv_dir, EVAL_MODE_LEVELIZED);
+    test_mode(inv_dir, EVAL_MODE_PARALLEL);
+    test_mode(inv_dir, EVAL_MODE_BYTECODE);
+    test_mode(inv_dir, EVAL_MODE_SWEEP);
+
+    cleanup_pubsub();
+    return test_finish("bus_inject");
+}
@@ -0,0 +1,105 @@
+#include "test_util.h"
+#include "arena.h"
+#include "block.h"
+#include "const_fold.h"
+#include "eval.h"
+#include "eval_util.h"
+#include "pubsub.h"
+#include "sexpr_parser.h"
+#include "signal_map.h"
+
+// Builds the const_fold fixture twice up to the point where compile_block
+// folds, folds one copy and evaluates both. The fixture has:
+//   NOTA  NA = NOT 1           folded at compile time
+//   BUFQ  Q = NA               folded through the previous fold
+//   DRIVE W = 1, written twice not constant: two writers
+//   MIX   M = W XOR 1          specialized to MIX_x1, evaluated at run time
+
+static void build_unfolded(Block *blk, SignalMap *map, const char *inv_dir)
+{
+    blk->arena = arena_create(0);
+    parse_block_from_sexpr(blk, inv_dir);
+    unify_invocations(blk, map);
+    publish_all_literal_bindings(blk, map);
+}
+
+static size_t count_instances(const Block *blk)
+{
+    size_t count = 0;
+    for (const InstanceList *node = blk->instances; node; node = node->next)
+        count++;
+    return count;
+}
+
+static const Definition *definition_writing(const Block *blk, const char *output)
+{
+    for (const InstanceList *node = blk->instances; node; node = node->next)
+    {
+        const ConditionalInvocation *ci = node->instance->definition->conditional_invocation;
+        if (ci && strcmp(ci->output, output) == 0)
+            return node->instance->definition;
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    const char *inv_dir = argc > 1 ? argv[1] : "tests/data/const_fold";
+    test_quiet_logs();
+    init_pubsub();
+
+    EvalOptions options = {0};
+    options.mode = EVAL_MODE_LEVELIZED;
+
+    SignalMap *reference_map = create_signal_map();
+    Block reference = {0};
+    build_unfolded(&reference, reference_map, inv_dir);
+    CHECK(count_instances(&reference) == 5);
+    eval_with_options(&reference, reference_map, &options);
+    poll_pubsub(reference_map, 10); // Our own updates must not reach the map under test
+
+    SignalMap *map = create_signal_map();
+    Block blk = {0};
+    build_unfolded(&blk, map, inv_dir);
+
+    ConstFold fold;
+    CHECK(fold_constants(&blk, map, &fold) == 0);
+    CHECK(fold.folded == 2);
+    CHECK(fold.specialized == 1);
+    CHECK(fold.removed == 2);
+    CHECK(count_instances(&blk) == 3);
+    const_fold_release(&fold);
+
+    // Folded outputs are known before evaluation starts; the rest are not
+    CHECK_STR(get_signal_value(map, "NA"), "0");
+    CHECK_STR(get_signal_value(map, "Q"), "0");
+    CHECK_STR(get_signal_value(map, "W"), NULL);
+    CHECK_STR(get_signal_value(map, "M"), NULL);
+
+    // The constant arg is gone from MIX, not just its value
+    const Definition *mix = definition_writing(&blk, "M");
+    CHECK(mix != NULL);
+    if (mix)
+    {
+        CHECK(strcmp(mix->name, "MIX") != 0);
+        CHECK(mix->conditional_invocation->arg_count == 1);
+        CHECK(mix->conditional_invocation->case_count == 2);
+    }
+
+    // Folding changes when values are computed, never what they are
+    eval_with_options(&blk, map, &options);
+    CHECK_STR(get_signal_value(map, "W"), "1");
+    CHECK_STR(get_signal_value(map, "M"), "0");
+    for (SignalId id = 0; id < reference_map->count; ++id)
+    {
+        const char *name = signal_map_name(reference_map, id);
+        CHECK_STR(get_signal_value(map, name), signal_map_get(reference_map, id));
+    }
+
+    block_release(&blk);
+    destroy_signal_map(map);
+    block_release(&reference);
+    destroy_signal_map(reference_map);
+    cleanup_pubsub();
+    return test_finish("const_fold");
+}
@@ -0,0 +1,143 @@
+#include "test_util.h"
+#include "gap.h"
+#include "intern.h"
+#include "signal_map.h"
+
+// GAP_SIGNAL_BATCH encoding and the checks a receiver relies on: the decoder
+// refuses a batch that does not fit its packet, and the signal table stamp
+// tells maps that number their signals differently apart.
+
+static GAPPacket *encode_packet(uint64_t signal_table, const GAPUpdateValue *values, size_t count)
+{
+    size_t text_len = 0;
+    for (size_t i = 0; i < count; ++i)
+        text_len += gap_value_text_len(values[i].value);
+
+    size_t payload_len = gap_signal_batch_size(count, text_len);
+    GAPPacket *packet = calloc(1, sizeof(GAPPacket) + payload_len);
+    if (!packet)
+        return NULL;
+    packet->version = 1;
+    packet->type = GAP_SIGNAL_BATCH;
+    packet->payload_len = (uint32_t)payload_len;
+    gap_encode_signal_batch((GAPSignalBatch *)packet->payload, signal_table, values, count);
+    return packet;
+}
+
+static void test_round_trip(void)
+{
+    const GAPUpdateValue values[] = {
+        {3, "1"}, {0, "0"}, {7, "0x2A"}, {1, "Z"}, {12, "1"},
+    };
+    const size_t count = sizeof(values) / sizeof(values[0]);
+
+    GAPPacket *packet = encode_packet(0x1234567890ABCDEFull, values, count);
+    CHECK(packet != NULL);
+    if (!packet)
+        return;
+
+    // Bits travel in the update itself; only other values take text
+    CHECK(packet->payload_len == gap_signal_batch_size(count, sizeof("0x2A") + sizeof("Z")));
+
+    const GAPSignalBatch *batch = gap_signal_batch(packet);
+    CHECK(batch != NULL);
+    if (batch)
+    {
+        CHECK(batch->signal_table == 0x1234567890ABCDEFull);
+        CHECK(batch->count == count);
+        for (size_t i = 0; i < count && i < batch->count; ++i)
+        {
+            CHECK(batch->updates[i].id == values[i].id);
+            CHECK_STR(gap_update_value(batch, &batch->updates[i]), values[i].value);
+        }
+    }
+
+    // A value pointing past the text is refused, not read
+    GAPSignalBatch *writable = (GAPSignalBatch *)packet->payload;
+    writable->updates[2].value = GAP_VALUE_TEXT | writable->text_len;
+    CHECK(gap_update_value(writable, &writable->updates[2]) == NULL);
+
+    free(packet);
+}
+
+static void test_malformed_batches_are_refused(void)
+{
+    const GAPUpdateValue values[] = {{0, "1"}, {1, "abc"}};
+    GAPPacket *packet = encode_packet(1, values, 2);
+    CHECK(packet != NULL);
+    if (!packet)
+        return;
+    GAPSignalBatch *batch = (GAPSignalBatch *)packet->payload;
+    CHECK(gap_signal_batch(packet) != NULL);
+
+    // More updates than the payload holds
+    batch->count = 1000;
+    CHECK(gap_signal_batch(packet) == NULL);
+    batch->count = 2;
+
+    // Text that does not end in a NUL would let the last value run off the end
+    char *text = (char *)&batch->updates[batch->count];
+    text[batch->text_len - 1] = 'x';
+    CHECK(gap_signal_batch(packet) == NULL);
+    text[batch->text_len - 1] = '\0';
+
+    // A payload shorter than its header
+    uint32_t payload_len = packet->payload_len;
+    packet->payload_len = sizeof(GAPSignalBatch) - 1;
+    CHECK(gap_signal_batch(packet) == NULL);
+    packet->payload_len = payload_len;
+
+    packet->type = GAP_SIGNAL;
+    CHECK(gap_signal_batch(packet) == NULL);
+    CHECK(gap_signal_batch(NULL) == NULL);
+
+    free(packet);
+}
+
+// Receivers compare the stamp with their own map's fingerprint
+static void test_signal_table_stamp(void)
+{
+    SignalMap *a = create_signal_map();
+    SignalMap *b = create_signal_map();
+    SignalMap *c = create_signal_map();
+    signal_map_intern(a, "GAP.x");
+    signal_map_intern(a, "GAP.y");
+    signal_map_intern(b, "GAP.x");
+    signal_map_intern(b, "GAP.y");
+    signal_map_intern(c, "GAP.y"); // Same names, other ids
+    signal_map_intern(c, "GAP.x");
+
+    CHECK(signal_map_fingerprint(a) != 0);
+    CHECK(signal_map_fingerprint(a) == signal_map_fingerprint(b));
+    CHECK(signal_map_fingerprint(a) != signal_map_fingerprint(c));
+
+    // Any new id changes it
+    uint64_t before = signal_map_fingerprint(b);
+    signal_map_intern(b, "GAP.z");
+    CHECK(signal_map_fingerprint(b) != before);
+
+    // Reserved names count as the names they will get, without being built
+    SignalMap *eager = create_signal_map();
+    SignalMap *lazy = create_signal_map();
+    signal_map_intern(eager, "GAPLAZY.INV.A.0");
+    signal_map_intern(eager, "GAPLAZY.INV.B.1");
+    const char *locals[] = {intern("A.0"), intern("B.1")};
+    signal_map_reserve(lazy, intern("GAPLAZY.INV"), locals, 2);
+    CHECK(signal_map_fingerprint(lazy) == signal_map_fingerprint(eager));
+    CHECK(lazy->entries[0].name == NULL && lazy->entries[1].name == NULL);
+
+    destroy_signal_map(lazy);
+    destroy_signal_map(eager);
+    destroy_signal_map(c);
+    destroy_signal_map(b);
+    destroy_signal_map(a);
+}
+
+int main(void)
+{
+    test_quiet_logs();
+    test_round_trip();
+    test_malformed_batches_are_refused();
+    test_signal_table_stamp();
+    return test_finish("gap_batch");
+}
@@ -0,0 +1,96 @@
+#include "test_util.h"
+#include "arena.h"
+#include "block.h"
+#include "eval.h"
+#include "eval_util.h"
+#include "liveness.h"
+#include "pubsub.h"
+#include "sexpr_parser.h"
+#include "signal_map.h"
+
+// The liveness fixture's ROW exposes only Q1. Inside it NOTA drives NA,
+// which BUFB reads to drive Q1; DEADC reads NA too, but its DC is read only
+// by DEADD, whose DD nobody reads. Trimming must drop DEADC and DEADD with
+// their signals and leave Q1 evaluating as before.
+
+static void build(Block *blk, SignalMap *map, const char *inv_dir, int trim, LivenessReport *report)
+{
+    blk->arena = arena_create(0);
+    parse_block_from_sexpr(blk, inv_dir);
+    unify_invocations(blk, map);
+    if (trim)
+        CHECK(trim_unobserved(blk, map, report) == 0);
+    publish_all_literal_bindings(blk, map);
+}
+
+static int has_instance_of(const Block *blk, const char *definition)
+{
+    for (const InstanceList *node = blk->instances; node; node = node->next)
+        if (strcmp(node->instance->definition->name, definition) == 0)
+            return 1;
+    return 0;
+}
+
+// Renumbering must leave every port pointing at the signal it named before
+static void check_ports_resolve(const Block *blk, SignalMap *map)
+{
+    for (const InstanceList *node = blk->instances; node; node = node->next)
+        for (size_t p = 0; p < node->instance->port_count; ++p)
+        {
+            SignalId id = node->instance->ports[p];
+            if (id == SIGNAL_ID_NONE)
+                continue;
+            CHECK(id < map->count);
+            if (id < map->count)
+                CHECK(signal_map_find(map, signal_map_name(map, id)) == id);
+        }
+}
+
+int main(int argc, char **argv)
+{
+    const char *inv_dir = argc > 1 ? argv[1] : "tests/data/liveness";
+    test_quiet_logs();
+    init_pubsub();
+
+    EvalOptions options = {0};
+    options.mode = EVAL_MODE_LEVELIZED;
+
+    SignalMap *full_map = create_signal_map();
+    Block full = {0};
+    build(&full, full_map, inv_dir, 0, NULL);
+    CHECK(signal_map_find(full_map, "DC") != SIGNAL_ID_NONE);
+    CHECK(has_instance_of(&full, "DEADD"));
+    eval_with_options(&full, full_map, &options);
+    poll_pubsub(full_map, 10); // Our own updates must not reach the trimmed map
+
+    LivenessReport report = {0};
+    SignalMap *map = create_signal_map();
+    Block blk = {0};
+    build(&blk, map, inv_dir, 1, &report);
+
+    CHECK(report.instances_removed == 2);
+    CHECK(report.signals_removed > 0);
+    CHECK(!has_instance_of(&blk, "DEADC"));
+    CHECK(!has_instance_of(&blk, "DEADD"));
+    CHECK(has_instance_of(&blk, "NOTA"));
+    CHECK(has_instance_of(&blk, "BUFB"));
+
+    CHECK(signal_map_find(map, "DC") == SIGNAL_ID_NONE);
+    CHECK(signal_map_find(map, "DD") == SIGNAL_ID_NONE);
+    CHECK(signal_map_find(map, "NA") != SIGNAL_ID_NONE);
+    CHECK(signal_map_find(map, "Q1") != SIGNAL_ID_NONE);
+    CHECK(map->count + report.signals_removed == report.signal_count);
+    check_ports_resolve(&blk, map);
+
+    eval_with_options(&blk, map, &options);
+    CHECK_STR(get_signal_value(map, "Q1"), "1");
+    CHECK_STR(get_signal_value(map, "Q1"), get_signal_value(full_map, "Q1"));
+    CHECK_STR(get_signal_value(map, "NA"), get_signal_value(full_map, "NA"));
+
+    block_release(&blk);
+    destroy_signal_map(map);
+    block_release(&full);
+    destroy_signal_map(full_map);
+    cleanup_pubsub();
+    return test_finish("liveness");
+}
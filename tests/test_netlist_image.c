@@ -0,0 +1,124 @@
+#include "test_util.h"
+#include "block.h"
+#include "compiler.h"
+#include "eval.h"
+#include "netlist_image.h"
+#include "pubsub.h"
+#include "signal_map.h"
+#include <unistd.h>
+
+// Compiles the example netlist, loads the image compile_block wrote into a
+// fresh Block and map, and checks both describe and evaluate the same circuit.
+
+static size_t count_instances(const Block *blk)
+{
+    size_t count = 0;
+    for (const InstanceList *node = blk->instances; node; node = node->next)
+        count++;
+    return count;
+}
+
+static void check_same_signals(SignalMap *loaded, SignalMap *compiled)
+{
+    CHECK(loaded->count == compiled->count);
+    for (SignalId id = 0; id < loaded->count && id < compiled->count; ++id)
+    {
+        CHECK_STR(signal_map_name(loaded, id), signal_map_name(compiled, id));
+        CHECK_STR(signal_map_get(loaded, id), signal_map_get(compiled, id));
+        CHECK(signal_map_get_bit(loaded, id) == signal_map_get_bit(compiled, id));
+    }
+}
+
+static void check_same_instances(const Block *loaded, const Block *compiled)
+{
+    CHECK(count_instances(loaded) > 0);
+    CHECK(count_instances(loaded) == count_instances(compiled));
+
+    const InstanceList *a = loaded->instances, *b = compiled->instances;
+    for (; a && b; a = a->next, b = b->next)
+    {
+        CHECK_STR(a->instance->name, b->instance->name);
+        CHECK_STR(a->instance->definition->name, b->instance->definition->name);
+        CHECK(a->instance->port_count == b->instance->port_count);
+        for (size_t p = 0; p < a->instance->port_count && p < b->instance->port_count; ++p)
+            CHECK(a->instance->ports[p] == b->instance->ports[p]);
+    }
+}
+
+// Keeps the first half of the image, as a crash in the middle of a write would
+static int write_truncated_copy(const char *from, const char *to)
+{
+    FILE *in = fopen(from, "rb");
+    if (!in)
+        return -1;
+    static char bytes[1 << 20];
+    size_t size = fread(bytes, 1, sizeof(bytes), in);
+    fclose(in);
+
+    FILE *out = fopen(to, "wb");
+    if (!out)
+        return -1;
+    size_t written = fwrite(bytes, 1, size / 2, out);
+    return fclose(out) == 0 && written == size / 2 ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+    const char *inv_dir = argc > 1 ? argv[1] : "inv";
+    test_quiet_logs();
+    init_pubsub();
+    set_build_cache_enabled(0);
+
+    char out_dir[32];
+    if (test_make_temp_dir(out_dir) != 0)
+    {
+        perror("mkdtemp");
+        return 1;
+    }
+    char image_path[64], truncated_path[64];
+    snprintf(image_path, sizeof(image_path), "%s/%s", out_dir, NETLIST_IMAGE_FILE);
+    snprintf(truncated_path, sizeof(truncated_path), "%s/truncated.rcimg", out_dir);
+
+    SignalMap *compiled_map = create_signal_map();
+    Block compiled = {0};
+    compile_block(&compiled, compiled_map, inv_dir, out_dir);
+    CHECK(access(image_path, R_OK) == 0);
+
+    SignalMap *loaded_map = create_signal_map();
+    Block loaded = {0};
+    loaded.image = netlist_image_load(image_path, &loaded, loaded_map);
+    CHECK(loaded.image != NULL);
+
+    if (loaded.image)
+    {
+        // Values published at compile time (literals, folded constants) travel with the image
+        check_same_signals(loaded_map, compiled_map);
+        check_same_instances(&loaded, &compiled);
+
+        EvalOptions options = {0};
+        options.mode = EVAL_MODE_LEVELIZED;
+        int compiled_changes = eval_with_options(&compiled, compiled_map, &options);
+        poll_pubsub(compiled_map, 10); // Our own updates must not reach the loaded map
+        int loaded_changes = eval_with_options(&loaded, loaded_map, &options);
+        CHECK(compiled_changes > 0);
+        CHECK(loaded_changes == compiled_changes);
+        check_same_signals(loaded_map, compiled_map);
+    }
+    block_release(&loaded);
+    destroy_signal_map(loaded_map);
+
+    // A short file is refused rather than mapped past its end
+    CHECK(write_truncated_copy(image_path, truncated_path) == 0);
+    SignalMap *truncated_map = create_signal_map();
+    Block truncated = {0};
+    truncated.image = netlist_image_load(truncated_path, &truncated, truncated_map);
+    CHECK(truncated.image == NULL);
+    block_release(&truncated);
+    destroy_signal_map(truncated_map);
+
+    block_release(&compiled);
+    destroy_signal_map(compiled_map);
+    test_remove_tree(out_dir);
+    cleanup_pubsub();
+    return test_finish("netlist_image");
+}
@@ -0,0 +1,135 @@
+#include "test_util.h"
+#include "intern.h"
+#include "signal_map.h"
+
+// Reserved ranges (signal_map_reserve): names are built one at a time and
+// only when asked for, and a name that already had a signal keeps it.
+// Each case uses its own prefix: the intern pool is process-wide.
+
+// The map keeps the locals array itself, so it is interned in place
+static SignalId reserve(SignalMap *map, const char *prefix, const char **locals, size_t count)
+{
+    for (size_t k = 0; k < count; ++k)
+        locals[k] = intern(locals[k]);
+    return signal_map_reserve(map, intern(prefix), locals, count);
+}
+
+static void test_names_are_lazy(void)
+{
+    SignalMap *map = create_signal_map();
+    const char *locals[] = {"A.0.x", "B.1.y", "C.2.z"};
+    SignalId first = reserve(map, "LAZY.INV", locals, 3);
+
+    CHECK(first != SIGNAL_ID_NONE);
+    CHECK(map->count == 3);
+    CHECK(signal_map_reserved_ids(map, first) == NULL);
+    CHECK(intern_lookup("LAZY.INV.A.0.x") == NULL);
+
+    // A lookup names the one id it found, not its neighbours
+    CHECK(signal_map_find(map, "LAZY.INV.B.1.y") == first + 1);
+    CHECK(intern_lookup("LAZY.INV.B.1.y") != NULL);
+    CHECK(intern_lookup("LAZY.INV.A.0.x") == NULL);
+    CHECK(intern_lookup("LAZY.INV.C.2.z") == NULL);
+
+    // Unknown names are not interned by looking for them
+    CHECK(signal_map_find(map, "LAZY.INV.D.3.w") == SIGNAL_ID_NONE);
+    CHECK(intern_lookup("LAZY.INV.D.3.w") == NULL);
+
+    // Values need no name
+    CHECK(signal_map_set(map, first + 2, intern("1")) == 1);
+    CHECK(signal_map_get_bit(map, first + 2) == 1);
+    CHECK(intern_lookup("LAZY.INV.C.2.z") == NULL);
+
+    const char *name = signal_map_name(map, first);
+    CHECK_STR(name, "LAZY.INV.A.0.x");
+    CHECK(signal_map_name(map, first) == name);
+    CHECK(intern_lookup("LAZY.INV.A.0.x") == name);
+
+    // Interning a reserved name returns its reserved id
+    CHECK(signal_map_intern(map, "LAZY.INV.C.2.z") == first + 2);
+    CHECK(map->count == 3);
+    CHECK_STR(get_signal_value(map, "LAZY.INV.C.2.z"), "1");
+
+    destroy_signal_map(map);
+}
+
+static void test_existing_names_keep_their_signal(void)
+{
+    SignalMap *map = create_signal_map();
+    SignalId existing = signal_map_intern(map, "ALIAS.INV.A.0.x");
+    CHECK(signal_map_set(map, existing, intern("1")) == 1);
+
+    const char *locals[] = {"A.0.x", "B.1.y"};
+    SignalId first = reserve(map, "ALIAS.INV", locals, 2);
+    const SignalId *ids = signal_map_reserved_ids(map, first);
+    CHECK(ids != NULL);
+    if (ids)
+    {
+        CHECK(ids[0] == existing);
+        CHECK(ids[1] != existing);
+        CHECK_STR(signal_map_name(map, ids[1]), "ALIAS.INV.B.1.y");
+        CHECK(signal_map_find(map, "ALIAS.INV.B.1.y") == ids[1]);
+    }
+    // One name, one signal: the value written before the reservation is still the one read
+    CHECK(signal_map_find(map, "ALIAS.INV.A.0.x") == existing);
+    CHECK_STR(get_signal_value(map, "ALIAS.INV.A.0.x"), "1");
+
+    // Siblings of a bound local stay reserved: found and interned at their own id, never split
+    SignalId sibling_existing = signal_map_intern(map, "SIBLING.INV.A.0");
+    const char *sibling_locals[] = {"A.0", "B.1", "C.2"};
+    SignalId sibling_first = reserve(map, "SIBLING.INV", sibling_locals, 3);
+    ids = signal_map_reserved_ids(map, sibling_first);
+    CHECK(ids != NULL && ids[0] == sibling_existing);
+    size_t count_before = map->count;
+    CHECK(signal_map_find(map, "SIBLING.INV.B.1") == sibling_first + 1);
+    CHECK(signal_map_intern(map, "SIBLING.INV.C.2") == sibling_first + 2);
+    CHECK(map->count == count_before);
+    CHECK(signal_map_set(map, sibling_first + 2, intern("1")) == 1);
+    CHECK_STR(get_signal_value(map, "SIBLING.INV.C.2"), "1");
+
+    // The split between prefix and local name does not matter
+    SignalId deep = signal_map_intern(map, "ALIAS.P.Q.r");
+    const char *deep_locals[] = {"Q.r"};
+    SignalId deep_first = reserve(map, "ALIAS.P", deep_locals, 1);
+    ids = signal_map_reserved_ids(map, deep_first);
+    CHECK(ids != NULL && ids[0] == deep);
+
+    destroy_signal_map(map);
+}
+
+static void test_compaction_keeps_names(void)
+{
+    SignalMap *map = create_signal_map();
+    SignalId direct = signal_map_intern(map, "COMPACT.top");
+    const char *locals[] = {"A.0.x", "B.1.y", "C.2.z", "D.3.w"};
+    SignalId first = reserve(map, "COMPACT.INV", locals, 4);
+    CHECK(signal_map_set(map, first + 3, intern("0")) == 1);
+
+    uint8_t keep[5] = {1, 1, 1, 1, 1};
+    SignalId remap[5];
+    keep[first + 1] = 0;
+    CHECK(signal_map_compact(map, keep, remap) == 1);
+    CHECK(map->count == 4);
+    CHECK(remap[first + 1] == SIGNAL_ID_NONE);
+    CHECK(remap[direct] == direct);
+
+    // Survivors are still unnamed until asked for, and resolve to their new ids
+    CHECK(intern_lookup("COMPACT.INV.C.2.z") == NULL);
+    CHECK(signal_map_find(map, "COMPACT.INV.B.1.y") == SIGNAL_ID_NONE);
+    CHECK(signal_map_find(map, "COMPACT.INV.C.2.z") == remap[first + 2]);
+    CHECK_STR(signal_map_name(map, remap[first]), "COMPACT.INV.A.0.x");
+    CHECK_STR(signal_map_name(map, remap[first + 3]), "COMPACT.INV.D.3.w");
+    CHECK_STR(signal_map_get(map, remap[first + 3]), "0");
+    CHECK_STR(signal_map_name(map, remap[direct]), "COMPACT.top");
+
+    destroy_signal_map(map);
+}
+
+int main(void)
+{
+    test_quiet_logs();
+    test_names_are_lazy();
+    test_existing_names_keep_their_signal();
+    test_compaction_keeps_names();
+    return test_finish("signal_map");
+}
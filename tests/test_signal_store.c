@@ -0,0 +1,186 @@
+#include "test_util.h"
+#include "intern.h"
+#include "signal_export.h"
+#include "signal_map.h"
+#include "signal_store.h"
+#include <pthread.h>
+
+// One writer publishes the map over and over while a reader thread takes
+// snapshots. Publish number p drives every signal to p % 2, so a snapshot
+// that mixes two publishes shows up as a signal that disagrees with its epoch.
+// Halfway through the map doubles, which moves the store to larger arrays.
+
+#define SIGNALS 2000
+#define PUBLISHES 2000
+#define GROW_AT (PUBLISHES / 2)
+
+typedef struct ReaderState {
+    const SignalStore *store;
+    int started;        // Atomic
+    int done;           // Atomic; set by the writer
+    size_t reads;
+    size_t torn;        // Snapshots mixing two publishes
+    size_t wrong_count; // Snapshots whose size does not match their epoch
+    size_t went_back;   // Epochs lower than the one before
+} ReaderState;
+
+static void *reader_main(void *arg)
+{
+    ReaderState *state = arg;
+    StoreSnapshot snapshot = {0};
+    uint64_t last_epoch = 0;
+
+    __atomic_store_n(&state->started, 1, __ATOMIC_RELEASE);
+    while (!__atomic_load_n(&state->done, __ATOMIC_ACQUIRE))
+    {
+        if (signal_store_read(state->store, &snapshot) != 0)
+            break;
+        state->reads++;
+        if (snapshot.epoch < last_epoch)
+            state->went_back++;
+        last_epoch = snapshot.epoch;
+        if (snapshot.epoch == 0)
+            continue;
+
+        size_t expected = snapshot.epoch >= GROW_AT ? 2 * SIGNALS : SIGNALS;
+        if (snapshot.count != expected)
+            state->wrong_count++;
+
+        uint8_t bit = (uint8_t)(snapshot.epoch % 2);
+        for (size_t id = 0; id < snapshot.count; ++id)
+            if (snapshot.bits[id] != bit || !snapshot.values[id] || snapshot.values[id][0] != '0' + bit)
+            {
+                state->torn++;
+                break;
+            }
+    }
+    store_snapshot_free(&snapshot);
+    return NULL;
+}
+
+static void intern_signals(SignalMap *map, size_t from, size_t to)
+{
+    char name[32];
+    for (size_t i = from; i < to; ++i)
+    {
+        snprintf(name, sizeof(name), "STORE.s%zu", i);
+        signal_map_intern(map, name);
+    }
+}
+
+static void drive_all(SignalMap *map, const char *value)
+{
+    for (SignalId id = 0; id < map->count; ++id)
+        signal_map_set(map, id, value);
+}
+
+static void test_readers_never_see_a_torn_publish(void)
+{
+    SignalMap *map = create_signal_map();
+    SignalStore *store = create_signal_store();
+    intern_signals(map, 0, SIGNALS);
+
+    StoreSnapshot empty = {0};
+    CHECK(signal_store_read(store, &empty) == 0);
+    CHECK(empty.epoch == 0 && empty.count == 0);
+    store_snapshot_free(&empty);
+
+    ReaderState state = {0};
+    state.store = store;
+    pthread_t reader;
+    CHECK(pthread_create(&reader, NULL, reader_main, &state) == 0);
+    while (!__atomic_load_n(&state.started, __ATOMIC_ACQUIRE))
+        ;
+
+    const char *values[2] = {intern("0"), intern("1")};
+    for (size_t p = 1; p <= PUBLISHES; ++p)
+    {
+        if (p == GROW_AT)
+            intern_signals(map, SIGNALS, 2 * SIGNALS);
+        drive_all(map, values[p % 2]);
+        signal_store_publish(store, map);
+    }
+    __atomic_store_n(&state.done, 1, __ATOMIC_RELEASE);
+    pthread_join(reader, NULL);
+
+    CHECK(state.reads > 0);
+    CHECK(state.torn == 0);
+    CHECK(state.wrong_count == 0);
+    CHECK(state.went_back == 0);
+
+    StoreSnapshot last = {0};
+    CHECK(signal_store_read(store, &last) == 0);
+    CHECK(last.epoch == PUBLISHES);
+    CHECK(last.count == 2 * SIGNALS);
+    store_snapshot_free(&last);
+
+    destroy_signal_store(store);
+    destroy_signal_map(map);
+}
+
+static char *read_file(const char *path)
+{
+    static char text[4096];
+    FILE *in = fopen(path, "r");
+    if (!in)
+        return NULL;
+    size_t size = fread(text, 1, sizeof(text) - 1, in);
+    fclose(in);
+    text[size] = '\0';
+    return text;
+}
+
+static void test_export_writes_driven_signals(const char *dir)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "%s/signals.txt", dir);
+
+    // Undriven signals are left out; ids without a name are written by number
+    const char *names[] = {"EXPORT.a", "EXPORT.b", "EXPORT.c"};
+    uint8_t bits[] = {1, SIGNAL_BIT_UNSET, 0, 1};
+    const char *values[] = {"1", NULL, "0", "1"};
+    StoreSnapshot snapshot = {0};
+    snapshot.epoch = 7;
+    snapshot.count = 4;
+    snapshot.bits = bits;
+    snapshot.values = values;
+    CHECK(export_signal_snapshot(&snapshot, names, 3, path) == 0);
+    CHECK_STR(read_file(path), "EXPORT.a=1\nEXPORT.c=0\n#3=1\n");
+
+    // The exporter thread writes whatever the last publish was when it stops
+    SignalMap *map = create_signal_map();
+    SignalStore *store = create_signal_store();
+    SignalId x = signal_map_intern(map, "EXPORT.x");
+    SignalId y = signal_map_intern(map, "EXPORT.y");
+    signal_map_set(map, x, intern("1"));
+    signal_store_publish(store, map);
+
+    SignalExporter *exporter = start_signal_exporter(store, map, path, 1000);
+    CHECK(exporter != NULL);
+    signal_map_set(map, x, intern("0"));
+    signal_map_set(map, y, intern("1"));
+    signal_store_publish(store, map);
+    stop_signal_exporter(exporter);
+    CHECK_STR(read_file(path), "EXPORT.x=0\nEXPORT.y=1\n");
+
+    destroy_signal_store(store);
+    destroy_signal_map(map);
+}
+
+int main(void)
+{
+    test_quiet_logs();
+
+    char dir[32];
+    if (test_make_temp_dir(dir) != 0)
+    {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    test_readers_never_see_a_torn_publish();
+    test_export_writes_driven_signals(dir);
+
+    test_remove_tree(dir);
+    return test_finish("signal_store");
+}
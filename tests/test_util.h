@@ -0,0 +1,70 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+// Include first in every test, ahead of any system header (mkdtemp, nftw)
+#define _XOPEN_SOURCE 700
+#include "log.h"
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Minimal harness: each CHECK that fails is reported and counted, the test
+// keeps going, and test_finish turns the count into the exit status meson reads.
+
+static int test_failures = 0;
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            fprintf(stderr, "❌ %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            test_failures++;                                                    \
+        }                                                                       \
+    } while (0)
+
+// Values and names are interned, but compare by content so the check says what it means
+#define CHECK_STR(actual, expected)                                             \
+    do {                                                                        \
+        const char *a_ = (actual), *e_ = (expected);                            \
+        if (!(a_ == e_ || (a_ && e_ && strcmp(a_, e_) == 0))) {                 \
+            fprintf(stderr, "❌ %s:%d: %s is \"%s\", expected \"%s\"\n", __FILE__, __LINE__, \
+                    #actual, a_ ? a_ : "(null)", e_ ? e_ : "(null)");           \
+            test_failures++;                                                    \
+        }                                                                       \
+    } while (0)
+
+// Only errors reach the test log; the compiler narrates every stage otherwise
+static inline void test_quiet_logs(void)
+{
+    log_set_level(LOG_LEVEL_ERROR);
+}
+
+// Fresh directory for compiler output; path must hold at least 32 bytes
+static inline int test_make_temp_dir(char *path)
+{
+    strcpy(path, "/tmp/rcnode-test-XXXXXX");
+    return mkdtemp(path) ? 0 : -1;
+}
+
+static inline int test_remove_entry(const char *path, const struct stat *st, int flag, struct FTW *ftw)
+{
+    (void)st;
+    (void)flag;
+    (void)ftw;
+    return remove(path);
+}
+
+static inline void test_remove_tree(const char *path)
+{
+    nftw(path, test_remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+static inline int test_finish(const char *name)
+{
+    if (test_failures)
+        fprintf(stderr, "❌ %s: %d check(s) failed\n", name, test_failures);
+    else
+        printf("✅ %s passed\n", name);
+    return test_failures ? 1 : 0;
+}
+
+#endif